@@ -4,7 +4,7 @@
 output_file="output.csv"
 
 # 결과 파일 초기화 (헤더 포함)
-echo "WriteCount,ReadCount,Benchmark,InsertTime(µs),Read/DeleteTime(µs)" > "$output_file"
+echo "WriteCount,ReadCount,Benchmark,InsertTime(µs),Read/DeleteTime(µs),Threads,InsertOps/s,Read/DeleteOps/s,InsertP50(ns),InsertP90(ns),InsertP99(ns),InsertP99.9(ns),InsertMax(ns),Read/DeleteP50(ns),Read/DeleteP90(ns),Read/DeleteP99(ns),Read/DeleteP99.9(ns),Read/DeleteMax(ns)" > "$output_file"
 
 # 실험 파라미터 (자유롭게 수정 가능)
 write_counts=(1000 5000 10000)
@@ -19,6 +19,10 @@ declare -A benchmarks=(
   [4]="UniformDelete"
   [5]="ZipfianDelete"
   [6]="Scan"
+  [7]="BulkLoad"
+  [8]="ReverseScan"
+  [9]="UniformMultiGet"
+  [10]="UniformInsertBatch"
 )
 
 # 실행 반복
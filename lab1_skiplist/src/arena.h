@@ -0,0 +1,108 @@
+#ifndef LAB1_SKIPLIST_ARENA_H_
+#define LAB1_SKIPLIST_ARENA_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include <atomic>
+
+// Arena: bump allocator that hands out memory from large blocks.
+// (LevelDB의 memtable arena와 같은 방식)
+// Memory is never returned piece by piece; every block is released at once
+// when the arena is destroyed.
+class Arena {
+   public:
+    Arena();
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Hands out 'bytes' bytes (> 0) with no alignment guarantee.
+    char* Allocate(size_t bytes);
+
+    // Allocate memory aligned to 'align' bytes ('align' must be a power of two
+    // no larger than kBlockAlign).
+    char* AllocateAligned(size_t bytes, size_t align = alignof(std::max_align_t));
+
+    // Bytes taken from the heap so far: every block plus its slot in 'blocks'.
+    size_t MemoryUsage() const {
+        return memory_usage.load(std::memory_order_relaxed);
+    }
+
+   private:
+    static constexpr size_t kBlockSize = 64 * 1024;
+    static constexpr size_t kBlockAlign = 64; // Every block starts on a cache line
+
+    char* AllocateFallback(size_t bytes);
+    char* AllocateNewBlock(size_t block_bytes);
+
+    char* alloc_ptr; // Current position in the active block
+    size_t alloc_bytes_remaining; // Bytes left in the active block
+    std::vector<char*> blocks; // Every block handed out by AllocateNewBlock
+    std::atomic<size_t> memory_usage; // Total bytes allocated for blocks (+ bookkeeping)
+};
+
+inline Arena::Arena()
+    : alloc_ptr(nullptr), alloc_bytes_remaining(0), memory_usage(0) {}
+
+inline Arena::~Arena() {
+    for (char* block : blocks) {
+        ::operator delete(block, std::align_val_t(kBlockAlign));
+    }
+}
+
+inline char* Arena::Allocate(size_t bytes) {
+    assert(bytes > 0);
+    if (bytes <= alloc_bytes_remaining) {
+        char* result = alloc_ptr;
+        alloc_ptr += bytes;
+        alloc_bytes_remaining -= bytes;
+        return result;
+    }
+    return AllocateFallback(bytes);
+}
+
+inline char* Arena::AllocateAligned(size_t bytes, size_t align) {
+    assert((align & (align - 1)) == 0 && align <= kBlockAlign);
+    size_t current_mod = reinterpret_cast<uintptr_t>(alloc_ptr) & (align - 1);
+    size_t slop = (current_mod == 0 ? 0 : align - current_mod);
+    size_t needed = bytes + slop;
+    if (needed <= alloc_bytes_remaining) {
+        char* result = alloc_ptr + slop;
+        alloc_ptr += needed;
+        alloc_bytes_remaining -= needed;
+        return result;
+    }
+    // 새 블록은 항상 kBlockAlign에 정렬되어 있으므로 추가 조정이 필요 없다
+    return AllocateFallback(bytes);
+}
+
+inline char* Arena::AllocateFallback(size_t bytes) {
+    if (bytes > kBlockSize / 4) {
+        // 큰 요청은 전용 블록을 받는다. 활성 블록은 그대로 두므로 남은 공간을
+        // 이후의 작은 요청이 계속 쓴다.
+        return AllocateNewBlock(bytes);
+    }
+
+    // 작은 요청: 새 블록으로 넘어가고, 이전 블록의 남은 바이트(최대 kBlockSize / 4)는 버린다
+    alloc_ptr = AllocateNewBlock(kBlockSize);
+    alloc_bytes_remaining = kBlockSize;
+
+    char* result = alloc_ptr;
+    alloc_ptr += bytes;
+    alloc_bytes_remaining -= bytes;
+    return result;
+}
+
+inline char* Arena::AllocateNewBlock(size_t block_bytes) {
+    char* result = static_cast<char*>(::operator new(block_bytes, std::align_val_t(kBlockAlign)));
+    blocks.push_back(result);
+    memory_usage.fetch_add(block_bytes + sizeof(char*), std::memory_order_relaxed);
+    return result;
+}
+
+#endif  // LAB1_SKIPLIST_ARENA_H_
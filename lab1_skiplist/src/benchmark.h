@@ -0,0 +1,129 @@
+#ifndef LAB1_SKIPLIST_BENCHMARK_H_
+#define LAB1_SKIPLIST_BENCHMARK_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#include <atomic>
+
+#include "histogram.h"
+
+// Helpers shared by the benchmark drivers for running one phase
+// (insert, lookup, delete, scan) on one or more threads.
+
+typedef std::chrono::high_resolution_clock PhaseClock;
+
+// Nanoseconds elapsed since 'start' (per-operation latency)
+inline uint64_t NanosSince(PhaseClock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(PhaseClock::now() - start).count();
+}
+
+// Start barrier: every worker waits here until all of them are ready,
+// so no thread gets a head start while the others are still being spawned.
+class StartBarrier {
+   public:
+    explicit StartBarrier(int count) : waiting(count) {}
+
+    void Wait() {
+        waiting.fetch_sub(1, std::memory_order_acq_rel);
+        while (waiting.load(std::memory_order_acquire) > 0) {
+            std::this_thread::yield();
+        }
+    }
+
+   private:
+    std::atomic<int> waiting;
+};
+
+// Timing of one phase
+struct PhaseResult {
+    float time_us = 0; // Wall time from the first worker starting to the last one finishing
+    long ops = 0; // Total operations across all workers
+    std::vector<float> thread_time_us; // Busy time of each worker
+    std::vector<long> thread_ops; // Operations done by each worker
+    Histogram latency; // Per-operation latency in ns, merged over all workers
+
+    // Aggregate throughput
+    double OpsPerSec() const {
+        return time_us > 0 ? ops / (time_us * 1e-6) : 0;
+    }
+
+    // Throughput of a single worker
+    double ThreadOpsPerSec(int tid) const {
+        return thread_time_us[tid] > 0 ? thread_ops[tid] / (thread_time_us[tid] * 1e-6) : 0;
+    }
+};
+
+// Splits 'ops' operations into contiguous [begin, end) ranges, one per thread,
+// and runs fn(tid, begin, end, latency) on each worker after a common start barrier.
+// Workers record the latency of every operation into their own 'latency' histogram.
+template<typename Fn>
+PhaseResult RunPhase(int threads, int ops, Fn fn) {
+    PhaseResult result;
+    result.ops = ops;
+    result.thread_time_us.resize(threads);
+    result.thread_ops.resize(threads);
+    std::vector<PhaseClock::time_point> starts(threads), ends(threads);
+    std::vector<Histogram> latencies(threads);
+
+    StartBarrier barrier(threads);
+    auto worker = [&](int tid) {
+        // 앞쪽 스레드에 나머지를 하나씩 더 배분
+        int begin = static_cast<long>(ops) * tid / threads;
+        int end = static_cast<long>(ops) * (tid + 1) / threads;
+        barrier.Wait();
+        starts[tid] = PhaseClock::now();
+        fn(tid, begin, end, latencies[tid]);
+        ends[tid] = PhaseClock::now();
+        result.thread_ops[tid] = end - begin;
+    };
+
+    if (threads == 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back(worker, t);
+        }
+        for (std::thread& t : workers) {
+            t.join();
+        }
+    }
+
+    auto first = *std::min_element(starts.begin(), starts.end());
+    auto last = *std::max_element(ends.begin(), ends.end());
+    result.time_us = std::chrono::duration_cast<std::chrono::nanoseconds>(last - first).count() * 0.001;
+    for (int t = 0; t < threads; ++t) {
+        result.thread_time_us[t] = std::chrono::duration_cast<std::chrono::nanoseconds>(ends[t] - starts[t]).count() * 0.001;
+        result.latency.Merge(latencies[t]);
+    }
+    return result;
+}
+
+// Prints aggregate throughput and latency percentiles of a phase,
+// plus per-thread throughput when it ran on several threads
+inline void PrintThroughput(const char* phase, const PhaseResult& r) {
+    int threads = static_cast<int>(r.thread_ops.size());
+    const Histogram& h = r.latency;
+    printf("%s: %.0lf ops/sec (%d thread%s)\n", phase, r.OpsPerSec(), threads, threads > 1 ? "s" : "");
+    printf("  latency (ns): avg %.1lf, p50 %lu, p90 %lu, p99 %lu, p99.9 %lu, max %lu\n",
+           h.Average(), (unsigned long)h.Percentile(50), (unsigned long)h.Percentile(90),
+           (unsigned long)h.Percentile(99), (unsigned long)h.Percentile(99.9), (unsigned long)h.Max());
+    if (threads > 1) {
+        for (int t = 0; t < threads; ++t) {
+            printf("  thread %d: %.0lf ops/sec\n", t, r.ThreadOpsPerSec(t));
+        }
+    }
+}
+
+// Writes the latency percentiles of a phase as CSV columns: p50,p90,p99,p99.9,max (ns)
+inline void WriteLatencyColumns(std::ostream& out, const Histogram& h) {
+    out << h.Percentile(50) << "," << h.Percentile(90) << "," << h.Percentile(99) << ","
+        << h.Percentile(99.9) << "," << h.Max();
+}
+
+#endif  // LAB1_SKIPLIST_BENCHMARK_H_
@@ -0,0 +1,586 @@
+#ifndef LAB1_SKIPLIST_CONCURRENT_SKIPLIST_H_
+#define LAB1_SKIPLIST_CONCURRENT_SKIPLIST_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <atomic>
+
+#include "random_level.h"
+
+// Lock-free SkipList (Herlihy & Shavit, "The Art of Multiprocessor Programming", 14.4)
+//
+// - Insert links the new node bottom-up with compare-and-swap on each level.
+//   A key is in the set as soon as its level 0 link is published.
+// - Delete marks the node's forward links top-down (the mark lives in the low
+//   bit of each link). Whoever marks level 0 owns the delete; the node is then
+//   physically unlinked by the next Find that passes it.
+// - Contains and Scan never write: they skip over marked nodes using acquire
+//   loads only.
+//
+// Memory is reclaimed with epochs (Fraser, "Practical lock-freedom", 5.2.3).
+// Every operation pins the global epoch for its duration. An unlinked node is
+// retired into the limbo list of the epoch it was unlinked in, and the epoch
+// only advances once no operation is pinned at the epoch before it, so the
+// limbo list of epoch e is freed when the epoch reaches e + 2: every operation
+// that could still be standing on one of its nodes has finished by then.
+//
+// A node is unlinked by the thread that finishes last among its inserter
+// (which may still be linking upper levels after a concurrent Delete marked
+// it) and its deleter; that thread runs one more Find after both are done, so
+// no level can still point at the node when it is retired.
+template<typename Key>
+class ConcurrentSkipList {
+   private:
+    struct Node;
+
+   public:
+    ConcurrentSkipList(int max_level = 16, float probability = 0.5);
+    ~ConcurrentSkipList();
+
+    ConcurrentSkipList(const ConcurrentSkipList&) = delete;
+    ConcurrentSkipList& operator=(const ConcurrentSkipList&) = delete;
+
+    // All operations may be called concurrently from any number of threads.
+    void Insert(const Key& key);
+    bool Contains(const Key& key) const;
+    // Batched Contains with the interface of SkipList::MultiContains. The keys are looked up
+    // in sorted order, but one at a time (no interleaving across the lock-free searches).
+    void MultiContains(const Key* keys, size_t n, bool* found) const;
+    // Batched Insert with the interface of SkipList::InsertBatch. The keys are inserted in
+    // sorted order, each with its own lock-free search from the head.
+    template<typename Iter>
+    void InsertBatch(Iter begin, Iter end);
+    std::vector<Key> Scan(const Key& key, const int scan_num) const;
+    // Up to scan_num keys <= key, largest first. There are no back links (they cannot be
+    // kept consistent with a single CAS), so every step is a fresh predecessor search.
+    std::vector<Key> ReverseScan(const Key& key, const int scan_num) const;
+    bool Delete(const Key& key);
+
+    // Appends the sorted keys in [begin, end) in one linear pass, like
+    // SkipList::BuildFromSorted. May run alongside readers but not alongside
+    // Insert/Delete (meant for loading a list before it is shared). Keys that are
+    // not larger than the current last key fall back to Insert.
+    template<typename Iter>
+    void BuildFromSorted(Iter begin, Iter end);
+
+    // Not thread-safe; for debugging only.
+    void Print() const;
+
+    // Returns an estimate of the number of bytes of node memory used by the list.
+    // Includes RetiredBytes().
+    size_t ApproximateMemoryUsage() const { return memory_usage.load(std::memory_order_relaxed); }
+
+    // Bytes of deleted nodes that are unlinked but not freed yet (waiting for the epoch to advance).
+    size_t RetiredBytes() const { return retired_bytes.load(std::memory_order_relaxed); }
+
+   private:
+    static constexpr size_t kCacheLineSize = 64;
+    static constexpr int kMaxPossibleLevel = 64; // Upper bound for the on-stack search path
+    static_assert(kMaxPossibleLevel <= LevelGenerator::kMaxLevels, "LevelGenerator draws at most kMaxLevels levels");
+    static constexpr int kEpochSlots = 64; // Pin counters; threads share them round-robin
+    static constexpr uint64_t kAdvanceInterval = 64; // Retires between attempts to advance the epoch
+
+    // Per-thread-slot number of operations pinned at each epoch (mod 3), one cache line per slot
+    struct alignas(kCacheLineSize) EpochSlot {
+        std::atomic<uint32_t> pinned[3];
+    };
+
+    // Pins the current epoch for the lifetime of an operation
+    class EpochGuard {
+       public:
+        explicit EpochGuard(const ConcurrentSkipList* list);
+        ~EpochGuard() { counter->fetch_sub(1, std::memory_order_release); }
+        EpochGuard(const EpochGuard&) = delete;
+        EpochGuard& operator=(const EpochGuard&) = delete;
+
+       private:
+        std::atomic<uint32_t>* counter;
+    };
+
+    // A link is a Node* whose low bit is the deletion mark of the node that owns the link.
+    typedef uintptr_t Link;
+    static Node* Ptr(Link link) { return reinterpret_cast<Node*>(link & ~Link(1)); }
+    static bool IsMarked(Link link) { return (link & 1) != 0; }
+    static Link MakeLink(Node* node, bool marked = false) {
+        return reinterpret_cast<Link>(node) | (marked ? 1 : 0);
+    }
+
+    int RandomLevel() const;
+    int SortedLevel(uint64_t i, int branching) const; // Deterministic height of the i-th bulk-built node
+    Node* NewNode(const Key& key, int level);
+    void FreeNode(Node* node);
+    static size_t NodeSize(int level) { return sizeof(Node) + sizeof(std::atomic<Link>) * (level - 1); }
+    static size_t ThreadSlot();
+
+    // Links levels [1, node->level) of a node whose level 0 link is published
+    void LinkTower(Node* node, Node** preds, Node** succs);
+    // Drops the inserter's or the deleter's claim on a node; the last one unlinks and retires it
+    void Release(Node* node);
+    void Retire(Node* node);
+    void TryAdvanceEpoch();
+    void FreeList(Node* node);
+
+    // Fills preds/succs with the neighbours of 'key' on every level, physically
+    // unlinking marked nodes along the way. Returns true if 'key' is present.
+    bool Find(const Key& key, Node** preds, Node** succs);
+
+    // Returns the first unmarked node with key >= 'key' (nullptr if none). Never writes.
+    Node* FindGreaterOrEqual(const Key& key) const;
+    // Returns the last unmarked node with key < 'key' (nullptr if none). Never writes.
+    Node* FindLessThan(const Key& key) const;
+
+    Node* head; // Head node (starting point of the SkipList)
+    int max_level; // Maximum level in the SkipList
+    float probability; // Probability factor for level increase
+    LevelGenerator levels; // Tower heights (generator state is per thread)
+    std::atomic<size_t> memory_usage; // Bytes allocated for nodes
+    std::atomic<size_t> retired_bytes; // Bytes on the limbo lists
+    std::atomic<uint64_t> retire_count; // Retires so far (paces TryAdvanceEpoch)
+    std::atomic<uint64_t> epoch; // Global epoch
+    std::atomic<Node*> limbo[3]; // Nodes retired in each epoch (mod 3)
+    mutable EpochSlot slots[kEpochSlots];
+};
+
+// Node layout: key and bookkeeping followed by an inline tower of atomic links.
+template<typename Key>
+struct ConcurrentSkipList<Key>::Node {
+    Key key;
+    int level; // Number of links in the tower
+    std::atomic<uint32_t> claims; // Inserter still linking + deleter; the node is retired when both let go
+    Node* retired_next; // Chain of a limbo list (never read by traversals)
+    std::atomic<Link> next[1]; // Length equals 'level'; next[0] is the lowest level link
+};
+
+template<typename Key>
+typename ConcurrentSkipList<Key>::Node* ConcurrentSkipList<Key>::NewNode(const Key& key, int level) {
+    // 노드 크기 이상인 2의 거듭제곱(최대 캐시 라인)으로 정렬해서 노드가 두 라인에 걸치지 않도록 한다
+    size_t size = NodeSize(level);
+    size_t align = alignof(Node);
+    while (align < size && align < kCacheLineSize) {
+        align <<= 1;
+    }
+    void* mem = ::operator new(size, std::align_val_t(align));
+    memory_usage.fetch_add(size, std::memory_order_relaxed);
+
+    Node* node = static_cast<Node*>(mem);
+    new (&node->key) Key(key);
+    node->level = level;
+    new (&node->claims) std::atomic<uint32_t>(2);
+    node->retired_next = nullptr;
+    for (int i = 0; i < level; ++i) {
+        new (&node->next[i]) std::atomic<Link>(0);
+    }
+    return node;
+}
+
+template<typename Key>
+void ConcurrentSkipList<Key>::FreeNode(Node* node) {
+    size_t size = NodeSize(node->level);
+    size_t align = alignof(Node);
+    while (align < size && align < kCacheLineSize) {
+        align <<= 1;
+    }
+    node->key.~Key();
+    ::operator delete(node, std::align_val_t(align));
+    memory_usage.fetch_sub(size, std::memory_order_relaxed);
+}
+
+// Slot of the calling thread (assigned round-robin on first use, shared by all lists)
+template<typename Key>
+size_t ConcurrentSkipList<Key>::ThreadSlot() {
+    static std::atomic<size_t> next_slot(0);
+    thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed) % kEpochSlots;
+    return slot;
+}
+
+template<typename Key>
+ConcurrentSkipList<Key>::EpochGuard::EpochGuard(const ConcurrentSkipList* list) {
+    EpochSlot& slot = list->slots[ThreadSlot()];
+    while (true) {
+        uint64_t e = list->epoch.load(std::memory_order_seq_cst);
+        counter = &slot.pinned[e % 3];
+        counter->fetch_add(1, std::memory_order_seq_cst);
+        // 카운터를 올리는 사이 epoch가 넘어갔으면 그 epoch는 보호되지 않으므로 다시 시도
+        if (list->epoch.load(std::memory_order_seq_cst) == e) return;
+        counter->fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+template<typename Key>
+void ConcurrentSkipList<Key>::Release(Node* node) {
+    if (node->claims.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+    // 삽입과 삭제가 모두 끝났으므로 모든 레벨에서 잘라낸 뒤 폐기
+    Node* preds[kMaxPossibleLevel];
+    Node* succs[kMaxPossibleLevel];
+    Find(node->key, preds, succs);
+    Retire(node);
+}
+
+// Push an unlinked node onto the limbo list of the current epoch (Treiber stack)
+template<typename Key>
+void ConcurrentSkipList<Key>::Retire(Node* node) {
+    retired_bytes.fetch_add(NodeSize(node->level), std::memory_order_relaxed);
+    std::atomic<Node*>& list = limbo[epoch.load(std::memory_order_seq_cst) % 3];
+    Node* top = list.load(std::memory_order_relaxed);
+    do {
+        node->retired_next = top;
+    } while (!list.compare_exchange_weak(top, node, std::memory_order_release,
+                                         std::memory_order_relaxed));
+    if (retire_count.fetch_add(1, std::memory_order_relaxed) % kAdvanceInterval == kAdvanceInterval - 1) {
+        TryAdvanceEpoch();
+    }
+}
+
+// Moves the epoch from e to e + 1 if no operation is pinned at e - 1, then frees the
+// nodes retired in e - 1: every operation that could still reach them has finished
+template<typename Key>
+void ConcurrentSkipList<Key>::TryAdvanceEpoch() {
+    uint64_t e = epoch.load(std::memory_order_seq_cst);
+    size_t previous = (e + 2) % 3;
+    for (const EpochSlot& slot : slots) {
+        if (slot.pinned[previous].load(std::memory_order_seq_cst) != 0) return;
+    }
+    if (!epoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst)) return;
+    FreeList(limbo[previous].exchange(nullptr, std::memory_order_acquire));
+}
+
+template<typename Key>
+void ConcurrentSkipList<Key>::FreeList(Node* node) {
+    while (node != nullptr) {
+        Node* next = node->retired_next;
+        retired_bytes.fetch_sub(NodeSize(node->level), std::memory_order_relaxed);
+        FreeNode(node);
+        node = next;
+    }
+}
+
+// Generate a random level for new nodes (one generator per thread)
+template<typename Key>
+int ConcurrentSkipList<Key>::RandomLevel() const {
+    return levels.Next(max_level);
+}
+
+template<typename Key>
+int ConcurrentSkipList<Key>::SortedLevel(uint64_t i, int branching) const {
+    int level = 1;
+    if (branching == 2) {
+        level += __builtin_ctzll(i);
+    } else {
+        while (i % branching == 0) {
+            i /= branching;
+            level++;
+        }
+    }
+    return std::min(level, max_level);
+}
+
+template<typename Key>
+ConcurrentSkipList<Key>::ConcurrentSkipList(int max_level, float probability)
+    : max_level(std::min(std::max(max_level, 1), kMaxPossibleLevel)), probability(probability),
+      levels(probability), memory_usage(0), retired_bytes(0), retire_count(0), epoch(0) {
+    for (std::atomic<Node*>& list : limbo) list.store(nullptr, std::memory_order_relaxed);
+    for (EpochSlot& slot : slots) {
+        for (std::atomic<uint32_t>& pinned : slot.pinned) pinned.store(0, std::memory_order_relaxed);
+    }
+    head = NewNode(Key{}, this->max_level);
+}
+
+// 소멸자: 다른 스레드가 더 이상 접근하지 않는다고 가정
+template<typename Key>
+ConcurrentSkipList<Key>::~ConcurrentSkipList() {
+    // 삭제된 노드는 모두 잘라내져 limbo 리스트에 있으므로 레벨 0에는 살아 있는 노드만 남는다
+    Link link = head->next[0].load(std::memory_order_relaxed);
+    while (Ptr(link) != nullptr) {
+        Node* node = Ptr(link);
+        link = node->next[0].load(std::memory_order_relaxed);
+        FreeNode(node);
+    }
+    for (std::atomic<Node*>& list : limbo) FreeList(list.load(std::memory_order_relaxed));
+    FreeNode(head);
+}
+
+template<typename Key>
+bool ConcurrentSkipList<Key>::Find(const Key& key, Node** preds, Node** succs) {
+retry:
+    Node* pred = head;
+    Node* curr = nullptr;
+    for (int level = max_level - 1; level >= 0; --level) {
+        curr = Ptr(pred->next[level].load(std::memory_order_acquire));
+        while (curr != nullptr) {
+            Link succ = curr->next[level].load(std::memory_order_acquire);
+            // 삭제 표시된 노드는 이 레벨에서 잘라낸다
+            while (IsMarked(succ)) {
+                Link expected = MakeLink(curr);
+                if (!pred->next[level].compare_exchange_strong(expected, MakeLink(Ptr(succ)),
+                                                               std::memory_order_acq_rel,
+                                                               std::memory_order_acquire)) {
+                    goto retry; // pred가 바뀌었거나 pred 자신이 삭제됨
+                }
+                curr = Ptr(succ);
+                if (curr == nullptr) break;
+                succ = curr->next[level].load(std::memory_order_acquire);
+            }
+            if (curr == nullptr || !(curr->key < key)) break;
+            pred = curr;
+            curr = Ptr(succ);
+        }
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+    return curr != nullptr && curr->key == key;
+}
+
+template<typename Key>
+typename ConcurrentSkipList<Key>::Node* ConcurrentSkipList<Key>::FindGreaterOrEqual(const Key& key) const {
+    Node* pred = head;
+    Node* curr = nullptr;
+    for (int level = max_level - 1; level >= 0; --level) {
+        curr = Ptr(pred->next[level].load(std::memory_order_acquire));
+        while (curr != nullptr) {
+            Link succ = curr->next[level].load(std::memory_order_acquire);
+            if (IsMarked(succ)) {
+                curr = Ptr(succ); // 삭제된 노드는 건너뛰기만 한다
+            } else if (curr->key < key) {
+                pred = curr;
+                curr = Ptr(succ);
+            } else {
+                break;
+            }
+        }
+    }
+    return curr;
+}
+
+template<typename Key>
+typename ConcurrentSkipList<Key>::Node* ConcurrentSkipList<Key>::FindLessThan(const Key& key) const {
+    Node* pred = head;
+    for (int level = max_level - 1; level >= 0; --level) {
+        Node* curr = Ptr(pred->next[level].load(std::memory_order_acquire));
+        while (curr != nullptr) {
+            Link succ = curr->next[level].load(std::memory_order_acquire);
+            if (IsMarked(succ)) {
+                curr = Ptr(succ);
+            } else if (curr->key < key) {
+                pred = curr;
+                curr = Ptr(succ);
+            } else {
+                break;
+            }
+        }
+    }
+    return pred == head ? nullptr : pred;
+}
+
+template<typename Key>
+void ConcurrentSkipList<Key>::Insert(const Key& key) {
+    EpochGuard guard(this);
+    Node* preds[kMaxPossibleLevel];
+    Node* succs[kMaxPossibleLevel];
+    int node_level = RandomLevel();
+    Node* new_node = nullptr;
+
+    // 레벨 0 연결에 성공하면 키가 삽입된 것으로 본다
+    while (true) {
+        if (Find(key, preds, succs)) {
+            if (new_node != nullptr) FreeNode(new_node); // 공개된 적 없는 노드
+            return;
+        }
+        if (new_node == nullptr) new_node = NewNode(key, node_level);
+        for (int i = 0; i < node_level; ++i) {
+            new_node->next[i].store(MakeLink(succs[i]), std::memory_order_relaxed);
+        }
+        Link expected = MakeLink(succs[0]);
+        if (preds[0]->next[0].compare_exchange_strong(expected, MakeLink(new_node),
+                                                      std::memory_order_release,
+                                                      std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    LinkTower(new_node, preds, succs);
+    Release(new_node); // 삽입 쪽 몫: 그 사이 삭제되었다면 여기서 폐기
+}
+
+// 상위 레벨을 아래에서 위로 연결 (연결 도중 삭제가 시작되면 중단)
+template<typename Key>
+void ConcurrentSkipList<Key>::LinkTower(Node* new_node, Node** preds, Node** succs) {
+    for (int level = 1; level < new_node->level; ++level) {
+        while (true) {
+            Node* succ = succs[level];
+            Link own = new_node->next[level].load(std::memory_order_acquire);
+            if (IsMarked(own)) return; // 연결 도중 삭제가 시작됨
+            if (Ptr(own) != succ &&
+                !new_node->next[level].compare_exchange_strong(own, MakeLink(succ),
+                                                               std::memory_order_acq_rel,
+                                                               std::memory_order_acquire)) {
+                continue; // 방금 mark 되었을 수 있으므로 다시 확인
+            }
+            Link expected = MakeLink(succ);
+            if (preds[level]->next[level].compare_exchange_strong(expected, MakeLink(new_node),
+                                                                  std::memory_order_release,
+                                                                  std::memory_order_relaxed)) {
+                break;
+            }
+            // 이웃이 바뀌었으면 다시 찾는다. 새 노드가 이미 삭제되었다면 중단
+            Find(new_node->key, preds, succs);
+            if (succs[0] != new_node) return;
+        }
+    }
+}
+
+template<typename Key>
+bool ConcurrentSkipList<Key>::Delete(const Key& key) {
+    EpochGuard guard(this);
+    Node* preds[kMaxPossibleLevel];
+    Node* succs[kMaxPossibleLevel];
+    if (!Find(key, preds, succs)) return false;
+    Node* node = succs[0];
+
+    // 상위 레벨부터 논리적으로 삭제 표시
+    for (int level = node->level - 1; level >= 1; --level) {
+        Link succ = node->next[level].load(std::memory_order_acquire);
+        while (!IsMarked(succ)) {
+            node->next[level].compare_exchange_weak(succ, succ | 1, std::memory_order_acq_rel,
+                                                    std::memory_order_acquire);
+        }
+    }
+
+    // 레벨 0을 mark 한 스레드가 삭제의 주인이 된다
+    Link succ = node->next[0].load(std::memory_order_acquire);
+    while (!IsMarked(succ)) {
+        if (node->next[0].compare_exchange_strong(succ, succ | 1, std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+            Release(node); // 삽입이 끝났다면 여기서 연결 해제 후 폐기
+            return true;
+        }
+    }
+    return false; // 다른 스레드가 먼저 삭제함
+}
+
+// 쓰기 스레드가 없다고 가정하고 레벨별 마지막 노드 뒤에 이어 붙인다.
+// 새 노드는 모든 필드를 채운 뒤 release store로 연결되므로 동시에 읽는 스레드는 안전하다.
+template<typename Key>
+template<typename Iter>
+void ConcurrentSkipList<Key>::BuildFromSorted(Iter begin, Iter end) {
+    EpochGuard guard(this);
+    Node* last[kMaxPossibleLevel];
+    Node* current = head;
+    for (int level = max_level - 1; level >= 0; --level) {
+        Node* next = Ptr(current->next[level].load(std::memory_order_acquire));
+        while (next != nullptr) {
+            current = next;
+            next = Ptr(current->next[level].load(std::memory_order_acquire));
+        }
+        last[level] = current;
+    }
+    // 끝에 삭제 표시된 노드가 남아 있으면 그 뒤에 붙일 수 없으므로 일반 삽입으로 처리
+    bool append = last[0] == head || !IsMarked(last[0]->next[0].load(std::memory_order_acquire));
+    for (int level = 1; level < max_level && append; ++level) {
+        append = last[level] == head || !IsMarked(last[level]->next[level].load(std::memory_order_acquire));
+    }
+
+    const int branching = probability > 0 ? std::max(2, static_cast<int>(std::lround(1.0 / probability))) : INT32_MAX;
+    uint64_t i = 0;
+    for (; begin != end; ++begin) {
+        const Key& key = *begin;
+        if (append && last[0] != head && !(last[0]->key < key)) {
+            if (last[0]->key == key) continue; // 중복 키는 무시
+            append = false; // 정렬이 깨지면 이후는 일반 삽입
+        }
+        if (!append) {
+            Insert(key);
+            continue;
+        }
+        int node_level = SortedLevel(++i, branching);
+        Node* node = NewNode(key, node_level);
+        node->claims.store(1, std::memory_order_relaxed); // 한 번에 모두 연결되므로 삭제 쪽 몫만 남는다
+        for (int level = 0; level < node_level; ++level) {
+            last[level]->next[level].store(MakeLink(node), std::memory_order_release);
+            last[level] = node;
+        }
+    }
+}
+
+template<typename Key>
+bool ConcurrentSkipList<Key>::Contains(const Key& key) const {
+    EpochGuard guard(this);
+    Node* node = FindGreaterOrEqual(key);
+    return node != nullptr && node->key == key;
+}
+
+template<typename Key>
+void ConcurrentSkipList<Key>::MultiContains(const Key* keys, size_t n, bool* found) const {
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    for (uint32_t i : order) {
+        found[i] = Contains(keys[i]);
+    }
+}
+
+template<typename Key>
+template<typename Iter>
+void ConcurrentSkipList<Key>::InsertBatch(Iter begin, Iter end) {
+    std::vector<Key> batch(begin, end);
+    std::sort(batch.begin(), batch.end());
+    for (const Key& key : batch) {
+        Insert(key);
+    }
+}
+
+template<typename Key>
+std::vector<Key> ConcurrentSkipList<Key>::Scan(const Key& key, const int scan_num) const {
+    std::vector<Key> result;
+    if (scan_num <= 0) return result;
+    EpochGuard guard(this);
+    Node* current = FindGreaterOrEqual(key);
+
+    // 레벨 0을 따라가며 삭제 표시되지 않은 노드를 scan_num개 수집
+    while (current != nullptr && result.size() < static_cast<size_t>(scan_num)) {
+        Link next = current->next[0].load(std::memory_order_acquire);
+        if (!IsMarked(next)) result.push_back(current->key);
+        current = Ptr(next);
+    }
+    return result;
+}
+
+template<typename Key>
+std::vector<Key> ConcurrentSkipList<Key>::ReverseScan(const Key& key, const int scan_num) const {
+    std::vector<Key> result;
+    if (scan_num <= 0) return result;
+    EpochGuard guard(this);
+    Node* current = FindGreaterOrEqual(key);
+    if (current == nullptr || current->key != key) {
+        current = FindLessThan(key);
+    }
+    while (current != nullptr && result.size() < static_cast<size_t>(scan_num)) {
+        result.push_back(current->key);
+        current = FindLessThan(current->key);
+    }
+    return result;
+}
+
+template<typename Key>
+void ConcurrentSkipList<Key>::Print() const {
+    std::cout << "ConcurrentSkipList Structure:\n";
+    for (int level = max_level - 1; level >= 0; --level) {
+        Link link = head->next[level].load(std::memory_order_acquire);
+        std::cout << "Level " << level << ": ";
+        while (Ptr(link) != nullptr) {
+            Node* node = Ptr(link);
+            link = node->next[level].load(std::memory_order_acquire);
+            if (!IsMarked(link)) std::cout << node->key << " ";
+        }
+        std::cout << "\n";
+    }
+}
+
+#endif  // LAB1_SKIPLIST_CONCURRENT_SKIPLIST_H_
@@ -0,0 +1,94 @@
+#ifndef LAB1_SKIPLIST_HISTOGRAM_H_
+#define LAB1_SKIPLIST_HISTOGRAM_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+// Histogram: log-bucketed latency histogram (HdrHistogram style).
+//
+// Values below 2^kSubBucketBits get a bucket each. Above that, every power of
+// two range [2^e, 2^(e+1)) is split into 2^kSubBucketBits equal sub-buckets,
+// so a recorded value is known to within 1/32 (~3%) of itself while the whole
+// uint64_t range fits in a fixed array. Add() is a few shifts and an increment.
+class Histogram {
+   public:
+    Histogram() { Clear(); }
+
+    void Clear() {
+        std::memset(buckets, 0, sizeof(buckets));
+        count = 0;
+        sum = 0;
+        min = UINT64_MAX;
+        max = 0;
+    }
+
+    void Add(uint64_t value) {
+        buckets[BucketIndex(value)]++;
+        count++;
+        sum += value;
+        if (value < min) min = value;
+        if (value > max) max = value;
+    }
+
+    void Merge(const Histogram& other) {
+        for (int i = 0; i < kNumBuckets; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+        count += other.count;
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+    }
+
+    uint64_t Count() const { return count; }
+    uint64_t Min() const { return count == 0 ? 0 : min; }
+    uint64_t Max() const { return max; }
+    double Average() const { return count == 0 ? 0 : static_cast<double>(sum) / count; }
+
+    // Returns the value below which 'p' percent of the samples fall (p in [0, 100]).
+    // The result is the highest value of the matching bucket, capped by Max().
+    uint64_t Percentile(double p) const {
+        if (count == 0) return 0;
+        uint64_t threshold = static_cast<uint64_t>(count * (p / 100.0));
+        if (threshold < 1) threshold = 1;
+        uint64_t cumulative = 0;
+        for (int i = 0; i < kNumBuckets; ++i) {
+            cumulative += buckets[i];
+            if (cumulative >= threshold) {
+                return std::min(BucketLimit(i), max);
+            }
+        }
+        return max;
+    }
+
+   private:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBucketBits;
+    static constexpr int kNumBuckets = kSubBuckets + (64 - kSubBucketBits) * kSubBuckets;
+
+    static int BucketIndex(uint64_t value) {
+        if (value < kSubBuckets) return static_cast<int>(value);
+        int exponent = 63 - __builtin_clzll(value); // >= kSubBucketBits
+        int shift = exponent - kSubBucketBits;
+        int sub = static_cast<int>((value >> shift) - kSubBuckets);
+        return static_cast<int>(kSubBuckets) + (exponent - kSubBucketBits) * static_cast<int>(kSubBuckets) + sub;
+    }
+
+    // Highest value that maps to bucket 'index'
+    static uint64_t BucketLimit(int index) {
+        if (index < static_cast<int>(kSubBuckets)) return index;
+        int exponent = (index - static_cast<int>(kSubBuckets)) / static_cast<int>(kSubBuckets) + kSubBucketBits;
+        int sub = (index - static_cast<int>(kSubBuckets)) % static_cast<int>(kSubBuckets);
+        int shift = exponent - kSubBucketBits;
+        return ((kSubBuckets + sub + 1) << shift) - 1;
+    }
+
+    uint64_t buckets[kNumBuckets];
+    uint64_t count;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+};
+
+#endif  // LAB1_SKIPLIST_HISTOGRAM_H_
@@ -0,0 +1,64 @@
+#ifndef LAB1_SKIPLIST_RANDOM_LEVEL_H_
+#define LAB1_SKIPLIST_RANDOM_LEVEL_H_
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+// Tower heights for skiplist nodes.
+//
+// A height is geometric: level k+1 is reached with probability p^k. Instead of
+// one float draw per level step, the whole height comes from a single 64-bit
+// draw u of a per-thread wyrand generator:
+//   - p = 1/2^b: every b trailing zero bits of u add one level (ctz)
+//   - other p:   one more level while u < p^k * 2^64 (thresholds precomputed)
+// The generator state is thread_local, so Next() is safe to call from any
+// number of threads on a shared (const) LevelGenerator.
+class LevelGenerator {
+   public:
+    static constexpr int kMaxLevels = 64;
+
+    explicit LevelGenerator(float probability) : shift(0) {
+        // p가 정확히 1/2^b 이면 ctz 경로 사용
+        int exponent;
+        if (probability > 0 && probability < 1 && std::frexp(probability, &exponent) == 0.5f) {
+            shift = 1 - exponent;
+        }
+        // 그 밖의 p: thresholds[k] = p^k * 2^64 (포화)
+        long double threshold = 18446744073709551616.0L; // 2^64
+        for (int k = 0; k < kMaxLevels; ++k) {
+            thresholds[k] = threshold >= 18446744073709551615.0L ? UINT64_MAX : static_cast<uint64_t>(threshold);
+            threshold *= probability > 0 ? probability : 0;
+        }
+    }
+
+    // Returns a height in [1, max_level] (max_level <= kMaxLevels)
+    int Next(int max_level) const {
+        uint64_t u = NextRandom();
+        int level;
+        if (shift != 0) {
+            // 최상위 비트를 세워 u = 0 에서도 ctz가 정의되도록 한다
+            level = 1 + __builtin_ctzll(u | (uint64_t(1) << 63)) / shift;
+        } else {
+            level = 1;
+            while (level < max_level && u < thresholds[level]) {
+                level++;
+            }
+        }
+        return level < max_level ? level : max_level;
+    }
+
+    // wyrand: one add and one 64x64->128 multiply per draw
+    static uint64_t NextRandom() {
+        thread_local uint64_t state = std::random_device{}() * 0x9E3779B97F4A7C15ULL;
+        state += 0xa0761d6478bd642fULL;
+        __uint128_t product = static_cast<__uint128_t>(state) * (state ^ 0xe7037ed1a0b428dbULL);
+        return static_cast<uint64_t>(product >> 64) ^ static_cast<uint64_t>(product);
+    }
+
+   private:
+    int shift; // b for p = 1/2^b, 0 for the threshold path
+    uint64_t thresholds[kMaxLevels];
+};
+
+#endif  // LAB1_SKIPLIST_RANDOM_LEVEL_H_
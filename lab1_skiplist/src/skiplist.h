@@ -9,10 +9,19 @@
 #include <smmintrin.h>
 #include <bit>
 #include <functional>
+#include <iterator>
 #include <mutex>
+#include <new>
+#include <numeric>
 #include <vector>
 
 #include <atomic>
+#include <type_traits>
+
+#include "arena.h"
+#include "value_slot.h"
+#include "random_level.h"
+#include "snapshot.h"
 
 typedef std::chrono::high_resolution_clock Clock;
 
@@ -29,81 +38,295 @@ int compare_(const Key& a, const Key& b) {
     }
 }
 
-template<typename Key>
+// SkipList<Key> is a set of keys; SkipList<Key, Value> maps keys to values.
+// Values are stored in the nodes (see value_slot.h for inline/out-of-line rules).
+//
+// MaxHeight is the tallest tower the list can ever hold. It is a compile-time constant so
+// that search paths are fixed-size stack arrays; the max_level given to the constructor
+// may lower it at run time. The default of 32 covers ~4 billion keys at p = 1/2; use a
+// larger MaxHeight (up to LevelGenerator::kMaxLevels = 64) for bigger lists.
+template<typename Key, typename Value = void, int MaxHeight = 32>
 class SkipList {
    private:
     struct Node;
+    typedef ValueSlot<Value> Slot;
 
    public:
+    typedef typename Slot::ValueType ValueType; // NoValue for set-only lists
+
+    static constexpr int kMaxHeight = MaxHeight;
+    static_assert(MaxHeight >= 1, "a skiplist needs at least one level");
+    static_assert(MaxHeight <= LevelGenerator::kMaxLevels, "LevelGenerator draws at most kMaxLevels levels");
+
+    // Iterator over the keys in order, walking the level 0 links lazily (nothing is copied).
+    // Valid until the entry it points at is deleted; inserts do not invalidate it.
+    class Iterator {
+       public:
+        explicit Iterator(const SkipList* list) : list(list), node(nullptr) {}
+
+        bool Valid() const { return node != nullptr; }
+        const Key& key() const { return node->key; }
+        const ValueType* value() const { return node->GetValue(); } // nullptr for set-only lists
+
+        void Next() { node = node->next[0]; }
+        void Prev() { node = node->prev != list->head ? node->prev : nullptr; } // Level 0 back link
+        void Seek(const Key& target) { node = list->FindGreaterOrEqual(target); } // First entry >= target
+        // Positions at the last entry <= target
+        void SeekForPrev(const Key& target) {
+            Node* lower = list->FindLessThan(target);
+            Node* next = lower != nullptr ? lower->next[0] : list->head->next[0];
+            node = next != nullptr && next->key == target ? next : lower;
+        }
+        void SeekToFirst() { node = list->head->next[0]; }
+        void SeekToLast() { node = list->FindLast(); }
+
+       private:
+        const SkipList* list;
+        Node* node;
+    };
+
+    // Passing kAutoMaxLevel as max_level lets the level cap follow the size of the list:
+    // it is 1 + log_{1/p}(N) for N keys (rising as keys are added, up to MaxHeight), so a
+    // small list never draws tall towers and a huge one is not stuck with a low cap.
+    static constexpr int kAutoMaxLevel = 0;
+
+    // max_level is clamped to [1, MaxHeight]; the automatic cap is opt-in (pass kAutoMaxLevel)
     SkipList(int max_level = 16, float probability = 0.5);
     ~SkipList();
 
+    SkipList(const SkipList&) = delete;
+    SkipList& operator=(const SkipList&) = delete;
+
     void Insert(const Key& key); // Insertion function (to be implemented by students)
     bool Contains(const Key& key) const; // Lookup function (to be implemented by students)
     std::vector<Key> Scan(const Key& key, const int scan_num) const; // Range query function (to be implemented by students)
+    std::vector<Key> ReverseScan(const Key& key, const int scan_num) const; // Up to scan_num keys <= key, largest first
     bool Delete(const Key& key); // Delete function (to be implemented by students)
 
+    // Looks up keys[0..n) as one batch and sets found[i] for each key (results are in input order).
+    // The batch is sorted and up to kLookupGroup searches run interleaved: each takes one step
+    // in turn and prefetches the node it will compare against next, so while one search waits
+    // for memory the others make progress.
+    void MultiContains(const Key* keys, size_t n, bool* found) const;
+
+    // Key-value interface (Value != void)
+    void Put(const Key& key, const ValueType& value); // Insert, or overwrite the value of an existing key
+    bool Get(const Key& key, ValueType* value) const; // Copy the value of 'key' into *value if present
+    bool Update(const Key& key, const ValueType& value); // Overwrite the value only if 'key' is present
+    void MultiGet(const Key* keys, size_t n, ValueType* values, bool* found) const; // Batched Get; values[i] is set only if found[i]
+    // Range query returning (key, pointer to value) pairs; values are not copied.
+    // The pointers stay valid until the key is deleted or overwritten.
+    std::vector<std::pair<Key, const ValueType*>> ScanKV(const Key& key, const int scan_num) const;
+
+    // Appends the entries in [begin, end) in one linear pass. Entries are keys, or
+    // (key, value) pairs for key-value lists, sorted by key. Each node is linked after
+    // the last node of every level of its tower, so there is no search per key; tower
+    // heights come from SortedLevel instead of RandomLevel. Keys that are not larger
+    // than the current last key fall back to Insert (duplicates are ignored).
+    template<typename Iter>
+    void BuildFromSorted(Iter begin, Iter end);
+
+    // Inserts the entries in [begin, end) (keys, or (key, value) pairs, in any order) with the
+    // semantics of Insert. The batch is sorted and every search starts from the previous
+    // search path (a finger) instead of the head: it only climbs to the lowest level whose
+    // predecessor is still in front of the key, so nearby keys cost a few hops each.
+    template<typename Iter>
+    void InsertBatch(Iter begin, Iter end);
+
+    // Snapshots (file format in snapshot.h). SaveSnapshot writes the entries in key order
+    // with a static search index of kSnapshotFanout keys per block, so the file can also be
+    // served read-only through SnapshotReader. LoadSnapshot maps a snapshot, verifies its
+    // checksums and adds its entries with BuildFromSorted: on an empty list that is one
+    // sequential pass over the file. Both return false on failure and describe it in
+    // *error if given. Values must be trivially copyable.
+    static constexpr size_t kSnapshotFanout = 64;
+    bool SaveSnapshot(const std::string& path, std::string* error = nullptr) const;
+    bool LoadSnapshot(const std::string& path, std::string* error = nullptr);
+
     void Print() const;
 
+    // Returns an estimate of the number of bytes of node memory used by the list.
+    size_t ApproximateMemoryUsage() const { return arena.MemoryUsage(); }
+
+    size_t Size() const { return num_keys; } // Number of keys in the list
+    int Height() const { return height; } // Tallest tower currently in the list
+    // Number of nodes a lookup of 'key' compares against (the search cost the level
+    // parameters trade against memory; used by the benchmark sweep)
+    size_t CountSearchHops(const Key& key) const;
+
    private:
     int RandomLevel() const; // Generates a random level for new nodes (to be implemented by students)
 
+    // Counts a new key and, with kAutoMaxLevel, raises max_level each time the list grows by 1/probability
+    void AddKey() {
+        num_keys++;
+        while (num_keys >= next_level_size && max_level < MaxHeight) {
+            max_level++;
+            next_level_size /= probability;
+        }
+    }
+
+    // Tower height of the i-th (1-based) node of a bulk build: 1 + the number of times
+    // 'branching' (= 1/probability) divides i, i.e. 1 + ctz(i) for p = 1/2. Every level
+    // then holds exactly 1/branching of the level below, with no random draws.
+    int SortedLevel(uint64_t i, int branching) const;
+
+    // Finds the last node of every level (head for empty levels)
+    void FindLastNodes(Node** last) const;
+
+    // Helpers to read a bulk-build entry: a bare key, or a (key, value) pair.
+    static const Key& EntryKey(const Key& key) { return key; }
+    template<typename K, typename V>
+    static const Key& EntryKey(const std::pair<K, V>& entry) { return entry.first; }
+    static ValueType EntryValue(const Key&) { return ValueType(); }
+    template<typename K, typename V>
+    static const V& EntryValue(const std::pair<K, V>& entry) { return entry.second; }
+
+    // Nodes never straddle a cache line, so the key and the first few
+    // forward pointers of a node are always fetched together.
+    static constexpr size_t kCacheLineSize = 64;
+
+    Node* NewNode(const Key& key, const ValueType& value, int level); // Allocates a node with an inline tower of 'level' pointers
+    void FreeNode(Node* node, int level); // Returns a node to the free list of its level
+
+    // Inserts 'key' if absent; otherwise overwrites its value when 'overwrite' is set.
+    void Upsert(const Key& key, const ValueType& value, bool overwrite);
+
+    // Returns the first node with a key >= 'key', or nullptr if there is none.
+    Node* FindGreaterOrEqual(const Key& key) const;
+    // Returns the last node with a key < 'key', or nullptr if there is none.
+    Node* FindLessThan(const Key& key) const;
+    // Returns the last node, or nullptr if the list is empty.
+    Node* FindLast() const;
+
+    // Number of interleaved searches in MultiContains/MultiGet
+    static constexpr size_t kLookupGroup = 16;
+    // Runs FindGreaterOrEqual for every key of the batch (see MultiContains) and calls
+    // visit(i, node) with the input index i and the node found for keys[i].
+    template<typename Visit>
+    void MultiFindGreaterOrEqual(const Key* keys, size_t n, Visit&& visit) const;
+
+    Arena arena; // Backing storage for every node (released all at once)
+    std::vector<Node*> free_nodes; // Deleted nodes per level, reused by NewNode (chained by next[0])
     Node* head; // Head node (starting point of the SkipList)
     int max_level; // Maximum level in the SkipList
+    int height; // Tallest tower currently in the list (1 when empty); searches start below it
+    size_t num_keys; // Keys currently in the list
+    double next_level_size; // kAutoMaxLevel: max_level grows when num_keys reaches this (infinite otherwise)
     float probability; // Probability factor for level increase
-    mutable std::mt19937 rng; // 랜덤 엔진
-    mutable std::uniform_real_distribution<float> dist; // [0.0, 1.0) 균등분포 생성기
+    LevelGenerator levels; // Tower heights from one 64-bit draw (per-thread generator state)
 };
 
 // SkipList Node structure
-template<typename Key>
-struct SkipList<Key>::Node {
+// 노드는 NewNode로만 생성되며, key 바로 뒤에 레벨 수만큼의 next 포인터가 이어서 할당된다.
+// 값은 ValueSlot을 상속해서 저장한다 (Value = void이면 크기 0).
+template<typename Key, typename Value, int MaxHeight>
+struct SkipList<Key, Value, MaxHeight>::Node : public SkipList<Key, Value, MaxHeight>::Slot {
     Key key;
-    std::vector<Node*> next; // Pointer array for multiple levels
-
-    // Constructor for Nodea
-    // 키와 레벨을 지정하여 초기화
-    Node(Key key, int level) : key(key), next(level, nullptr) {}
+    Node* prev; // Previous node on level 0 (head for the first node) for reverse iteration
+    // Pointer array for multiple levels.
+    // Length equals the node level; next[0] is the lowest level link.
+    Node* next[1];
 };
 
+// Allocate a node whose tower is laid out inline after the key
+template<typename Key, typename Value, int MaxHeight>
+typename SkipList<Key, Value, MaxHeight>::Node* SkipList<Key, Value, MaxHeight>::NewNode(const Key& key, const ValueType& value, int level) {
+    Node* node = free_nodes[level];
+    if (node != nullptr) {
+        // 같은 레벨의 삭제된 노드가 있으면 재사용
+        free_nodes[level] = node->next[0];
+    } else {
+        // 노드 크기 이상인 2의 거듭제곱(최대 캐시 라인)으로 정렬하면 노드가 두 라인에 걸치지 않는다
+        size_t size = sizeof(Node) + sizeof(Node*) * (level - 1);
+        size_t align = alignof(Node);
+        while (align < size && align < kCacheLineSize) {
+            align <<= 1;
+        }
+        node = reinterpret_cast<Node*>(arena.AllocateAligned(size, align));
+    }
+    new (&node->key) Key(key);
+    node->InitValue(value);
+    node->prev = nullptr;
+    for (int i = 0; i < level; ++i) {
+        node->next[i] = nullptr;
+    }
+    return node;
+}
+
+template<typename Key, typename Value, int MaxHeight>
+void SkipList<Key, Value, MaxHeight>::FreeNode(Node* node, int level) {
+    node->key.~Key();
+    node->DestroyValue();
+    node->next[0] = free_nodes[level];
+    free_nodes[level] = node;
+}
+
 // Generate a random level for new nodes
-template<typename Key>
-int SkipList<Key>::RandomLevel() const {
+template<typename Key, typename Value, int MaxHeight>
+int SkipList<Key, Value, MaxHeight>::RandomLevel() const {
+    // 주어진 확률로 최대 레벨 이하까지 레벨 증가 (난수 한 번으로 높이 전체 결정)
+    return levels.Next(max_level);
+}
+
+template<typename Key, typename Value, int MaxHeight>
+int SkipList<Key, Value, MaxHeight>::SortedLevel(uint64_t i, int branching) const {
     int level = 1;
-    // 주어진 확률로 최대 레벨 이하까지 레벨 증가
-    while(dist(rng) < probability && level < max_level) {
-        level++;
+    if (branching == 2) {
+        level += __builtin_ctzll(i); // p = 1/2: 끝자리 0 비트 수가 곧 높이
+    } else {
+        while (i % branching == 0) {
+            i /= branching;
+            level++;
+        }
     }
-    return level;
+    return std::min(level, max_level);
 }
 
 // Constructor for SkipList
-template<typename Key>
-SkipList<Key>::SkipList(int max_level, float probability)
-    : max_level(max_level), probability(probability) {
-    // 헤드 노드를 최대 레벨로 초기화
-    head = new Node(Key{}, max_level);
+template<typename Key, typename Value, int MaxHeight>
+SkipList<Key, Value, MaxHeight>::SkipList(int max_level, float probability)
+    : free_nodes(MaxHeight + 1, nullptr), max_level(std::max(1, std::min(max_level, MaxHeight))), height(1),
+      num_keys(0), next_level_size(HUGE_VAL), probability(probability), levels(probability) {
+    if (max_level == kAutoMaxLevel) {
+        // 키 수가 1/p 배가 될 때마다 한 레벨씩 (p >= 1이면 처음부터 최대)
+        this->max_level = probability >= 1 ? MaxHeight : 1;
+        if (probability > 0 && probability < 1) next_level_size = 1.0 / probability;
+    }
+    // 헤드 노드는 자랄 수 있는 최대 높이로 초기화
+    head = NewNode(Key{}, ValueType(), MaxHeight);
 }
 
 // 소멸자
-template<typename Key>
-SkipList<Key>::~SkipList() {
-    Node* node = head;
-    while (node) {
-        Node* next = node->next[0];
-        delete node;
-        node = next;
+// 노드 메모리는 arena가 한 번에 해제하므로 키 소멸자와 out-of-line 값만 정리하면 된다.
+template<typename Key, typename Value, int MaxHeight>
+SkipList<Key, Value, MaxHeight>::~SkipList() {
+    if (!std::is_trivially_destructible<Key>::value || Slot::kOutOfLine) {
+        for (Node* node = head; node != nullptr; node = node->next[0]) {
+            node->key.~Key();
+            node->DestroyValue();
+        }
     }
 }
 
 // Insert function (inserts a key into SkipList)
-template<typename Key>
-void SkipList<Key>::Insert(const Key& key) {
-    std::vector<Node*> update(max_level); // 삽입 위치 추적
+template<typename Key, typename Value, int MaxHeight>
+void SkipList<Key, Value, MaxHeight>::Insert(const Key& key) {
+    Upsert(key, ValueType(), false);
+}
+
+template<typename Key, typename Value, int MaxHeight>
+void SkipList<Key, Value, MaxHeight>::Put(const Key& key, const ValueType& value) {
+    Upsert(key, value, true);
+}
+
+template<typename Key, typename Value, int MaxHeight>
+void SkipList<Key, Value, MaxHeight>::Upsert(const Key& key, const ValueType& value, bool overwrite) {
+    Node* update[MaxHeight]; // 삽입 위치 추적
     Node* current = head;
 
-    // 삽입 위치 찾기 (상위 레벨부터 아래로 탐색)
-    for (int level = max_level - 1; level >= 0; --level) {
+    // 삽입 위치 찾기 (현재 높이부터 아래로 탐색)
+    for (int level = height - 1; level >= 0; --level) {
         // 다음 노드가 존재하고 키 값이 삽입할 키 값보다 작은 경우 계속 다음 노드로 이동
         while (current->next[level] != nullptr && current->next[level]->key < key) {
             current = current->next[level];
@@ -111,31 +334,38 @@ void SkipList<Key>::Insert(const Key& key) {
         update[level] = current; // 삽입할 노드의 위치를 기억
     }
     
-    // 이미 존재하는 키는 삽입 X
+    // 이미 존재하는 키는 삽입 X (Put이면 값만 덮어쓴다)
     current = current->next[0];
     if (current != nullptr && current->key == key) {
+        if (overwrite) current->SetValue(value);
         return;
     }
 
-    // 새로운 노드의 레벨 생성
+    // 새로운 노드의 레벨 생성 (현재 높이보다 높으면 그 위 레벨의 선행 노드는 head)
     int node_level = RandomLevel();
-    Node* new_node = new Node(key, node_level);
+    for (; height < node_level; ++height) {
+        update[height] = head;
+    }
+    Node* new_node = NewNode(key, value, node_level);
+    AddKey();
 
     // 각 레벨에 새 노드 연결
     for (int i = 0; i < node_level; ++i) {
         new_node->next[i] = update[i]->next[i];
         update[i]->next[i] = new_node;
     }
+    new_node->prev = update[0];
+    if (new_node->next[0] != nullptr) new_node->next[0]->prev = new_node;
 }
 
 // Delete function (removes a key from SkipList)
-template<typename Key>
-bool SkipList<Key>::Delete(const Key& key) {
-    std::vector<Node*> update(max_level); // 삭제 위치 추적
+template<typename Key, typename Value, int MaxHeight>
+bool SkipList<Key, Value, MaxHeight>::Delete(const Key& key) {
+    Node* update[MaxHeight]; // 삭제 위치 추적
     Node* current = head;
 
     // 삭제 대상 찾기 (Insert와 매커니즘 동일)
-    for (int level = max_level - 1; level >= 0; --level) {
+    for (int level = height - 1; level >= 0; --level) {
         while (current->next[level] && current->next[level]->key < key) {
             current = current->next[level];
         }
@@ -149,59 +379,329 @@ bool SkipList<Key>::Delete(const Key& key) {
         return false;
     }
 
-    // 연결 끊기
-    for (int i = 0; i < max_level; ++i) {
+    // 연결 끊기 (노드 레벨도 함께 계산)
+    int node_level = 0;
+    for (int i = 0; i < height; ++i) {
         if (update[i]->next[i] != current) break;
         update[i]->next[i] = current->next[i];
+        node_level++;
     }
+    if (current->next[0] != nullptr) current->next[0]->prev = update[0];
 
-    delete current;
+    FreeNode(current, node_level);
+    num_keys--;
+
+    // 맨 위 레벨들이 비었으면 높이를 줄인다 (이후 탐색이 빈 head 포인터를 건너지 않도록)
+    while (height > 1 && head->next[height - 1] == nullptr) {
+        height--;
+    }
     return true;
 }
 
-// Lookup function (checks if a key exists in SkipList)
-template<typename Key>
-bool SkipList<Key>::Contains(const Key& key) const {
+template<typename Key, typename Value, int MaxHeight>
+void SkipList<Key, Value, MaxHeight>::FindLastNodes(Node** last) const {
+    Node* current = head;
+    for (int level = MaxHeight - 1; level >= height; --level) {
+        last[level] = head; // max_level이 빌드 중에 자랄 수 있으므로 전부 채운다
+    }
+    for (int level = height - 1; level >= 0; --level) {
+        while (current->next[level] != nullptr) {
+            current = current->next[level];
+        }
+        last[level] = current;
+    }
+}
+
+template<typename Key, typename Value, int MaxHeight>
+bool SkipList<Key, Value, MaxHeight>::SaveSnapshot(const std::string& path, std::string* error) const {
+    SnapshotWriter<Key, ValueType> writer(path, num_keys, kSnapshotFanout);
+    for (Node* node = head->next[0]; node != nullptr; node = node->next[0]) {
+        writer.Add(node->key, node->GetValue());
+    }
+    if (writer.Finish()) return true;
+    if (error != nullptr) *error = writer.Error();
+    return false;
+}
+
+template<typename Key, typename Value, int MaxHeight>
+bool SkipList<Key, Value, MaxHeight>::LoadSnapshot(const std::string& path, std::string* error) {
+    SnapshotReader<Key, ValueType> reader;
+    if (!reader.Open(path)) {
+        if (error != nullptr) *error = reader.Error();
+        return false;
+    }
+    BuildFromSorted(reader.Begin(), reader.End());
+    return true;
+}
+
+// Bulk build: 레벨별 마지막 노드 뒤에 이어 붙이기만 하므로 키당 탐색이 없다
+template<typename Key, typename Value, int MaxHeight>
+template<typename Iter>
+void SkipList<Key, Value, MaxHeight>::BuildFromSorted(Iter begin, Iter end) {
+    Node* last[MaxHeight];
+    FindLastNodes(last);
+
+    const int branching = probability > 0 ? std::max(2, static_cast<int>(std::lround(1.0 / probability))) : INT32_MAX;
+    uint64_t i = 0;
+    for (; begin != end; ++begin) {
+        const Key& key = EntryKey(*begin);
+        if (last[0] != head && !(last[0]->key < key)) {
+            if (last[0]->key == key) continue; // 중복 키는 무시
+            // 정렬되지 않은 입력: 일반 삽입 후 마지막 노드들을 다시 찾는다
+            Upsert(key, EntryValue(*begin), false);
+            FindLastNodes(last);
+            continue;
+        }
+        int node_level = SortedLevel(++i, branching);
+        height = std::max(height, node_level);
+        Node* node = NewNode(key, EntryValue(*begin), node_level);
+        AddKey();
+        node->prev = last[0];
+        for (int level = 0; level < node_level; ++level) {
+            last[level]->next[level] = node;
+            last[level] = node;
+        }
+    }
+}
+
+template<typename Key, typename Value, int MaxHeight>
+template<typename Iter>
+void SkipList<Key, Value, MaxHeight>::InsertBatch(Iter begin, Iter end) {
+    typedef typename std::iterator_traits<Iter>::value_type Entry;
+    std::vector<Entry> batch(begin, end);
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](const Entry& a, const Entry& b) { return EntryKey(a) < EntryKey(b); });
+    // 배치 안의 중복 키는 처음 것만 남긴다 (finger가 항상 현재 키보다 앞에 있도록)
+    batch.erase(std::unique(batch.begin(), batch.end(),
+                            [](const Entry& a, const Entry& b) { return EntryKey(a) == EntryKey(b); }),
+                batch.end());
+
+    // finger[level]: 직전 키의 레벨별 선행 노드 (head에서 시작)
+    Node* finger[MaxHeight];
+    std::fill(finger, finger + MaxHeight, head);
+    for (const Entry& entry : batch) {
+        const Key& key = EntryKey(entry);
+
+        // 선행 노드가 여전히 key 바로 앞인 가장 낮은 레벨을 찾는다 (그 위 레벨은 모두 유효)
+        int top = 0;
+        while (top < height - 1 && finger[top]->next[top] != nullptr && finger[top]->next[top]->key < key) {
+            top++;
+        }
+
+        // top부터 아래로 내려가며 경로를 갱신한다
+        Node* current = finger[top];
+        for (int level = top; level >= 0; --level) {
+            // 이 레벨의 이전 선행 노드가 더 앞서 있으면 거기서 출발
+            Node* candidate = finger[level];
+            if (candidate != head && (current == head || current->key < candidate->key)) {
+                current = candidate;
+            }
+            while (current->next[level] != nullptr && current->next[level]->key < key) {
+                current = current->next[level];
+            }
+            finger[level] = current;
+        }
+
+        Node* next = current->next[0];
+        if (next != nullptr && next->key == key) continue; // 이미 있는 키
+
+        int node_level = RandomLevel();
+        height = std::max(height, node_level); // 새로 생긴 레벨의 finger는 head
+        Node* new_node = NewNode(key, EntryValue(entry), node_level);
+        AddKey();
+        new_node->prev = finger[0];
+        for (int level = 0; level < node_level; ++level) {
+            new_node->next[level] = finger[level]->next[level];
+            finger[level]->next[level] = new_node;
+            finger[level] = new_node; // 다음 키의 선행 노드 후보
+        }
+        if (new_node->next[0] != nullptr) new_node->next[0]->prev = new_node;
+    }
+}
+
+template<typename Key, typename Value, int MaxHeight>
+typename SkipList<Key, Value, MaxHeight>::Node* SkipList<Key, Value, MaxHeight>::FindGreaterOrEqual(const Key& key) const {
     Node* current = head;
 
     // 대상 찾기 (Insert와 매커니즘 동일)
-    for (int level = max_level - 1; level >= 0; --level) {
+    for (int level = height - 1; level >= 0; --level) {
         while (current->next[level] && current->next[level]->key < key) {
             current = current->next[level];
         }
     }
-    current = current->next[0];
-    return current != nullptr && current->key == key;
+    return current->next[0];
 }
 
-// Range query function (retrieves scan_num keys starting from key)
-template<typename Key>
-std::vector<Key> SkipList<Key>::Scan(const Key& key, const int scan_num) const {
-    std::vector<Key> result;
+template<typename Key, typename Value, int MaxHeight>
+size_t SkipList<Key, Value, MaxHeight>::CountSearchHops(const Key& key) const {
+    // FindGreaterOrEqual과 같은 경로, null이 아닌 next와의 비교 횟수를 센다
+    size_t hops = 0;
     Node* current = head;
+    for (int level = height - 1; level >= 0; --level) {
+        while (current->next[level]) {
+            hops++;
+            if (!(current->next[level]->key < key)) break;
+            current = current->next[level];
+        }
+    }
+    return hops;
+}
 
-    // key 이상의 노드 찾기
-    for (int level = max_level - 1; level >= 0; --level) {
+template<typename Key, typename Value, int MaxHeight>
+typename SkipList<Key, Value, MaxHeight>::Node* SkipList<Key, Value, MaxHeight>::FindLessThan(const Key& key) const {
+    Node* current = head;
+    for (int level = height - 1; level >= 0; --level) {
         while (current->next[level] && current->next[level]->key < key) {
             current = current->next[level];
         }
     }
+    return current == head ? nullptr : current;
+}
 
-    current = current->next[0];
+template<typename Key, typename Value, int MaxHeight>
+typename SkipList<Key, Value, MaxHeight>::Node* SkipList<Key, Value, MaxHeight>::FindLast() const {
+    Node* current = head;
+    for (int level = height - 1; level >= 0; --level) {
+        while (current->next[level]) {
+            current = current->next[level];
+        }
+    }
+    return current == head ? nullptr : current;
+}
+
+template<typename Key, typename Value, int MaxHeight>
+template<typename Visit>
+void SkipList<Key, Value, MaxHeight>::MultiFindGreaterOrEqual(const Key* keys, size_t n, Visit&& visit) const {
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+    // 진행 중인 탐색 하나의 상태 (현재 노드와 레벨)
+    struct Lane {
+        uint32_t index;
+        Node* node;
+        int level;
+    };
+    Lane lanes[kLookupGroup];
+    size_t active = 0;
+    size_t started = 0;
+    for (; active < kLookupGroup && started < n; ++active) {
+        lanes[active] = Lane{order[started++], head, height - 1};
+    }
+
+    while (active > 0) {
+        for (size_t l = 0; l < active;) {
+            Lane& lane = lanes[l];
+            const Key& key = keys[lane.index];
+            // 한 번에 한 칸만 전진하고 다음 탐색으로 넘어간다
+            Node* next = lane.node->next[lane.level];
+            if (next != nullptr && next->key < key) {
+                lane.node = next;
+            } else if (lane.level > 0) {
+                lane.level--;
+            } else {
+                visit(lane.index, next);
+                if (started < n) {
+                    lane = Lane{order[started++], head, height - 1};
+                } else {
+                    lane = lanes[--active]; // 끝난 자리는 마지막 탐색으로 채운다
+                    continue;
+                }
+            }
+            // 다음 차례에 비교할 노드를 미리 가져온다
+            Node* ahead = lane.node->next[lane.level];
+            if (ahead != nullptr) _mm_prefetch(reinterpret_cast<const char*>(ahead), _MM_HINT_T0);
+            ++l;
+        }
+    }
+}
+
+template<typename Key, typename Value, int MaxHeight>
+void SkipList<Key, Value, MaxHeight>::MultiContains(const Key* keys, size_t n, bool* found) const {
+    MultiFindGreaterOrEqual(keys, n, [&](size_t i, Node* node) {
+        found[i] = node != nullptr && node->key == keys[i];
+    });
+}
+
+template<typename Key, typename Value, int MaxHeight>
+void SkipList<Key, Value, MaxHeight>::MultiGet(const Key* keys, size_t n, ValueType* values, bool* found) const {
+    MultiFindGreaterOrEqual(keys, n, [&](size_t i, Node* node) {
+        found[i] = node != nullptr && node->key == keys[i];
+        if (found[i]) values[i] = *node->GetValue();
+    });
+}
+
+// Lookup function (checks if a key exists in SkipList)
+template<typename Key, typename Value, int MaxHeight>
+bool SkipList<Key, Value, MaxHeight>::Contains(const Key& key) const {
+    Node* current = FindGreaterOrEqual(key);
+    return current != nullptr && current->key == key;
+}
 
-    // 다음 노드들을 차례로 scan_num개를 수집한다.
-    while (current && result.size() < static_cast<size_t>(scan_num)) {
-        result.push_back(current->key);
-        current = current->next[0];
+template<typename Key, typename Value, int MaxHeight>
+bool SkipList<Key, Value, MaxHeight>::Get(const Key& key, ValueType* value) const {
+    Node* current = FindGreaterOrEqual(key);
+    if (current == nullptr || current->key != key) {
+        return false;
     }
+    *value = *current->GetValue();
+    return true;
+}
+
+template<typename Key, typename Value, int MaxHeight>
+bool SkipList<Key, Value, MaxHeight>::Update(const Key& key, const ValueType& value) {
+    Node* current = FindGreaterOrEqual(key);
+    if (current == nullptr || current->key != key) {
+        return false;
+    }
+    current->SetValue(value);
+    return true;
+}
 
+// Range query function (retrieves scan_num keys starting from key)
+template<typename Key, typename Value, int MaxHeight>
+std::vector<Key> SkipList<Key, Value, MaxHeight>::Scan(const Key& key, const int scan_num) const {
+    std::vector<Key> result;
+    if (scan_num <= 0) return result;
+
+    // key 이상의 노드부터 scan_num개를 수집한다.
+    Iterator it(this);
+    for (it.Seek(key); it.Valid() && result.size() < static_cast<size_t>(scan_num); it.Next()) {
+        result.push_back(it.key());
+    }
+
+    return result;
+}
+
+// Reverse range query: one search for the starting node, then the level 0 back links
+template<typename Key, typename Value, int MaxHeight>
+std::vector<Key> SkipList<Key, Value, MaxHeight>::ReverseScan(const Key& key, const int scan_num) const {
+    std::vector<Key> result;
+    if (scan_num <= 0) return result;
+    Iterator it(this);
+    for (it.SeekForPrev(key); it.Valid() && result.size() < static_cast<size_t>(scan_num); it.Prev()) {
+        result.push_back(it.key());
+    }
+    return result;
+}
+
+template<typename Key, typename Value, int MaxHeight>
+std::vector<std::pair<Key, const typename SkipList<Key, Value, MaxHeight>::ValueType*>>
+SkipList<Key, Value, MaxHeight>::ScanKV(const Key& key, const int scan_num) const {
+    std::vector<std::pair<Key, const ValueType*>> result;
+    if (scan_num <= 0) return result;
+    result.reserve(std::min<size_t>(scan_num, num_keys));
+    Iterator it(this);
+    for (it.Seek(key); it.Valid() && result.size() < static_cast<size_t>(scan_num); it.Next()) {
+        result.emplace_back(it.key(), it.value());
+    }
     return result;
 }
 
-template<typename Key>
-void SkipList<Key>::Print() const {
+template<typename Key, typename Value, int MaxHeight>
+void SkipList<Key, Value, MaxHeight>::Print() const {
   std::cout << "SkipList Structure:\n";
-  for (int level = max_level - 1; level >= 0; --level) {
+  for (int level = height - 1; level >= 0; --level) {
     Node* node = head->next[level];
     std::cout << "Level " << level << ": ";
     while (node != nullptr) {
@@ -10,270 +10,505 @@
 #include <vector>
 #include <thread>
 #include <cstdio>
+#include <cstring>
+#include <cmath>
 
 #include "zipf.h"
 #include "latest-generator.h"
 #include "skiplist.h"
+#include "concurrent_skiplist.h"
+#include "wal.h"
+#include "benchmark.h"
 
-void Zipfian(const int write, const int read, SkipList<Key>& sl) {
-    // Zipfian distribution generator
-    init_zipf_generator(0, write);
+// Number of threads each phase is split across (--threads)
+static int num_threads = 1;
 
-    // Insert keys following Zipfian distribution
-    auto w_start = Clock::now();
-    for (int i = 1; i <= write; ++i) {
-        Key key = nextValue() % write+1;        
-        sl.Insert(key);
-    }
-    auto w_end = Clock::now();
-    std::cout << "After Insert\n";
+// Snapshot file written after the benchmark and reloaded from (--snapshot)
+static std::string snapshot_path;
 
-    // Calculate insertion time
-    float w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
+// Write-ahead log in front of the list: log file, sync policy and interval (--wal, --sync, --sync-interval)
+static std::string wal_path;
+static SyncPolicy sync_policy = SyncPolicy::kEveryOp;
+static int sync_interval_ms = 10;
 
-    // Search for keys following Zipfian distribution
-    auto r_start = Clock::now();
-    for (int i = 1; i <= read; ++i) {
-        Key key = nextValue() % read+1;
-        sl.Contains(key);
-    }
-    auto r_end = Clock::now();
+// Results of the most recent benchmark (collected by --sweep)
+static PhaseResult last_write, last_read;
 
-    // Calculate search time
-    float r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
+// Print the results of a benchmark and append them to output.csv
+void Report(const char* label, const char* csv_name, const char* read_label,
+            const int write, const int read, const PhaseResult& w, const PhaseResult& r) {
+    float w_time = w.time_us;
+    float r_time = r.time_us;
+    last_write = w;
+    last_read = r;
 
     // Display results
-    printf("\n[Zipfian] Insertion = %.2lf µs, Lookup = %.2lf µs\n", w_time, r_time);
-    
+    printf("\n[%s] Insertion = %.2lf µs, %s = %.2lf µs\n", label, w_time, read_label, r_time);
+    PrintThroughput("Insertion", w);
+    PrintThroughput(read_label, r);
+
     // 파일에 저장
     std::ofstream outFile("output.csv", std::ios::app); // append 모드
     if (outFile.is_open()) {
-        outFile << write << "," << read << ",Zipfian," << w_time << "," << r_time << "\n";
+        outFile << write << "," << read << "," << csv_name << "," << w_time << "," << r_time << ","
+                << num_threads << "," << static_cast<long>(w.OpsPerSec()) << "," << static_cast<long>(r.OpsPerSec()) << ",";
+        WriteLatencyColumns(outFile, w.latency);
+        outFile << ",";
+        WriteLatencyColumns(outFile, r.latency);
+        outFile << "\n";
         outFile.close();
     }
 }
 
-void Uniform(const int write, const int read, SkipList<Key>& sl) {
-    // Uniformly distributed random generator
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> distr(1, write);
+template<typename List>
+void Zipfian(const int write, const int read, List& sl) {
+    // Zipfian distribution generator
+    init_zipf_generator(0, write);
+    const unsigned int seed = std::random_device{}();
 
-    // Insert random keys
-    auto w_start = Clock::now();
-    for (int i = 1; i <= write; ++i) {
-        sl.Insert(distr(gen)+1);
-    }
-    auto w_end = Clock::now();
+    // Insert keys following Zipfian distribution
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        unsigned int thread_seed = seed + tid; // 스레드별 난수 상태
+        for (int i = begin; i < end; ++i) {
+            Key key = nextValue_r(&thread_seed) % write+1;
+            auto op_start = PhaseClock::now();
+            sl.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
     std::cout << "After Insert\n";
 
-    // Calculate insertion time
-    float w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
+    // Search for keys following Zipfian distribution
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        unsigned int thread_seed = seed + num_threads + tid;
+        for (int i = begin; i < end; ++i) {
+            Key key = nextValue_r(&thread_seed) % read+1;
+            auto op_start = PhaseClock::now();
+            sl.Contains(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Zipfian", "Zipfian", "Lookup", write, read, w, r);
+}
 
-    // Search for random keys
-    auto r_start = Clock::now();
-    for (int i = 1; i <= read; ++i) {
-        sl.Contains(distr(gen)+1);
-    }
-    auto r_end = Clock::now();
+template<typename List>
+void Uniform(const int write, const int read, List& sl) {
+    // Uniformly distributed random generator (one engine per thread)
+    std::random_device rd;
+    const unsigned int seed = rd();
 
-    // Calculate search time
-    float r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
+    // Insert random keys
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        for (int i = begin; i < end; ++i) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            sl.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+    std::cout << "After Insert\n";
 
-    // Display results
-    printf("\n[Uniform] Insertion = %.2lf µs, Lookup = %.2lf µs\n", w_time, r_time);
-    
-    // 파일에 저장
-    std::ofstream outFile("output.csv", std::ios::app); // append 모드
-    if (outFile.is_open()) {
-        outFile << write << "," << read << ",Uniform," << w_time << "," << r_time << "\n";
-        outFile.close();
-    }
+    // Search for random keys
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + num_threads + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        for (int i = begin; i < end; ++i) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            sl.Contains(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Uniform", "Uniform", "Lookup", write, read, w, r);
 }
 
-void RevSequential(const int write, const int read, SkipList<Key>& sl) {
-    // Insert keys reverse sequentially
-    auto w_start = Clock::now();
-    for (int i = write; i > 0; i--) {
-        sl.Insert(i);
-    }
-    auto w_end = Clock::now();
+template<typename List>
+void RevSequential(const int write, const int read, List& sl) {
+    // Insert keys reverse sequentially (each thread takes a contiguous range)
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = write - begin; i > write - end; i--) {
+            auto op_start = PhaseClock::now();
+            sl.Insert(i);
+            latency.Add(NanosSince(op_start));
+        }
+    });
     std::cout << "After Insert\n";
 
-    // Calculate insertion time
-    float w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
-
     // Search for keys reverse sequentially
-    auto r_start = Clock::now();
-    for (int i = read; i > 0; i--) {
-        sl.Contains(i);
-    }
-    auto r_end = Clock::now();
-
-    // Calculate search time
-    float r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
-
-    // Display results
-    printf("\n[Rev-Sequential] Insertion = %.2lf µs, Lookup = %.2lf µs\n", w_time, r_time);
-    
-    // 파일에 저장
-    std::ofstream outFile("output.csv", std::ios::app); // append 모드
-    if (outFile.is_open()) {
-        outFile << write << "," << read << ",RevSequential," << w_time << "," << r_time << "\n";
-        outFile.close();
-    }
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = read - begin; i > read - end; i--) {
+            auto op_start = PhaseClock::now();
+            sl.Contains(i);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Rev-Sequential", "RevSequential", "Lookup", write, read, w, r);
 }
 
-void Sequential(const int write, const int read, SkipList<Key>& sl) {
-    // Insert keys sequentially
-    auto w_start = Clock::now();
-    for (int i = 1; i <= write; ++i) {
-        sl.Insert(i);
-    }
-    auto w_end = Clock::now();
+template<typename List>
+void Sequential(const int write, const int read, List& sl) {
+    // Insert keys sequentially (each thread takes a contiguous range)
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = begin + 1; i <= end; ++i) {
+            auto op_start = PhaseClock::now();
+            sl.Insert(i);
+            latency.Add(NanosSince(op_start));
+        }
+    });
     std::cout << "After Insert\n";
 
-    // Calculate insertion time
-    float w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
-
     // Search for keys sequentially
-    auto r_start = Clock::now();
-    for (int i = 1; i <= read; ++i) {
-        sl.Contains(i);
-    }
-    auto r_end = Clock::now();
-
-    // Calculate search time
-    float r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
-
-    // Display results
-    printf("\n[Sequential] Insertion = %.2lf µs, Lookup = %.2lf µs\n", w_time, r_time);
-    
-    // 파일에 저장
-    std::ofstream outFile("output.csv", std::ios::app); // append 모드
-    if (outFile.is_open()) {
-        outFile << write << "," << read << ",Sequential," << w_time << "," << r_time << "\n";
-        outFile.close();
-    }
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = begin + 1; i <= end; ++i) {
+            auto op_start = PhaseClock::now();
+            sl.Contains(i);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Sequential", "Sequential", "Lookup", write, read, w, r);
 }
 
-void Zipfian_Delete(const int write, const int read, SkipList<Key>& sl) {
+template<typename List>
+void Zipfian_Delete(const int write, const int read, List& sl) {
     // Zipfian distribution generator
     init_zipf_generator(0, write);
+    const unsigned int seed = std::random_device{}();
 
     // Insert keys following Zipfian distribution
-    auto w_start = Clock::now();
-    for (int i = 1; i <= write; ++i) {
-        Key key = nextValue() % write+1;        
-        sl.Insert(key);
-    }
-    auto w_end = Clock::now();
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        unsigned int thread_seed = seed + tid;
+        for (int i = begin; i < end; ++i) {
+            Key key = nextValue_r(&thread_seed) % write+1;
+            auto op_start = PhaseClock::now();
+            sl.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
     std::cout << "After Insert\n";
 
-    // Calculate insertion time
-    float w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
-
     // Insert Print
     // sl.Print();
 
     // Delete for keys following Zipfian distribution
-    auto r_start = Clock::now();
-    for (int i = 1; i <= read; ++i) {
-        Key key = nextValue() % read+1;
-        sl.Delete(key);
-    }
-    auto r_end = Clock::now();
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        unsigned int thread_seed = seed + num_threads + tid;
+        for (int i = begin; i < end; ++i) {
+            Key key = nextValue_r(&thread_seed) % read+1;
+            auto op_start = PhaseClock::now();
+            sl.Delete(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Zipfian Delete", "ZipfianDelete", "Deletion", write, read, w, r);
+}
 
-    // Calculate search time
-    float r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
+template<typename List>
+void Uniform_Delete(const int write, const int read, List& sl) {
+    // Uniformly distributed random generator (one engine per thread)
+    std::random_device rd;
+    const unsigned int seed = rd();
 
-    // Display results
-    printf("\n[Zipfian Delete] Insertion = %.2lf µs, Deletion = %.2lf µs\n", w_time, r_time);
-    
-    // 파일에 저장
-    std::ofstream outFile("output.csv", std::ios::app); // append 모드
-    if (outFile.is_open()) {
-        outFile << write << "," << read << ",ZipfianDelete," << w_time << "," << r_time << "\n";
-        outFile.close();
+    // Insert random keys
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        for (int i = begin; i < end; ++i) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            sl.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+    std::cout << "After Insert\n";
+
+    // Insert Print
+    // sl.Print();
+
+    // Delete for random keys
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + num_threads + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        for (int i = begin; i < end; ++i) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            sl.Delete(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Uniform Delete", "UniformDelete", "Deletion", write, read, w, r);
+}
+
+template<typename List>
+void Uniform_Scan(const int write, const int read, List &sl) {
+    std::random_device rd;
+    const unsigned int seed = rd();
+
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = begin + 1; i <= end; i++) {
+            //Key key = distr(gen)+1;
+            Key key = i;
+            auto op_start = PhaseClock::now();
+            sl.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+    printf("After Insert\n");
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + tid);
+        std::uniform_int_distribution<int> distr(0, write);
+        for (int i = begin; i < end; i++) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            sl.Scan(key, 1000);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Uniform-Scan", "UniformScan", "Lookup", write, read, w, r);
+}
+
+template<typename List>
+void Bulk_Load(const int write, const int read, List& sl) {
+    // Sorted input (prepared outside the timed phase)
+    std::vector<Key> keys(write);
+    for (int i = 0; i < write; ++i) {
+        keys[i] = i + 1;
     }
+
+    // Append every key in one linear pass (single-threaded);
+    // the latency sample is the amortized cost per key.
+    PhaseResult w = RunPhase(1, write, [&](int tid, int begin, int end, Histogram& latency) {
+        auto op_start = PhaseClock::now();
+        sl.BuildFromSorted(keys.begin(), keys.end());
+        latency.Add(NanosSince(op_start) / std::max(1, end - begin));
+    });
+    std::cout << "After Insert\n";
+
+    // Search for keys sequentially
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = begin + 1; i <= end; ++i) {
+            auto op_start = PhaseClock::now();
+            sl.Contains(i);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Bulk Load", "BulkLoad", "Lookup", write, read, w, r);
+}
+
+template<typename List>
+void Reverse_Scan(const int write, const int read, List& sl) {
+    std::random_device rd;
+    const unsigned int seed = rd();
+
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = begin + 1; i <= end; i++) {
+            Key key = i;
+            auto op_start = PhaseClock::now();
+            sl.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+    printf("After Insert\n");
+
+    // 최신(큰 키)부터 거꾸로 1000개씩 읽기
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + tid);
+        std::uniform_int_distribution<int> distr(0, write);
+        for (int i = begin; i < end; i++) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            sl.ReverseScan(key, 1000);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Reverse-Scan", "ReverseScan", "Lookup", write, read, w, r);
 }
 
-void Uniform_Delete(const int write, const int read, SkipList<Key>& sl) {
-    // Uniformly distributed random generator
+// Keys per MultiContains call in the Multi-Get benchmark
+static const int kMultiGetBatch = 64;
+
+template<typename List>
+void Uniform_MultiGet(const int write, const int read, List& sl) {
+    // Uniformly distributed random generator (one engine per thread)
     std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> distr(1, write);
+    const unsigned int seed = rd();
 
     // Insert random keys
-    auto w_start = Clock::now();
-    for (int i = 1; i <= write; ++i) {
-        sl.Insert(distr(gen)+1);
-    }
-    auto w_end = Clock::now();
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        for (int i = begin; i < end; ++i) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            sl.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
     std::cout << "After Insert\n";
 
-    // Calculate insertion time
-    float w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
+    // Search for random keys in batches; the latency sample is the amortized cost per key
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + num_threads + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        Key keys[kMultiGetBatch];
+        bool found[kMultiGetBatch];
+        for (int i = begin; i < end; i += kMultiGetBatch) {
+            int batch = std::min(kMultiGetBatch, end - i);
+            for (int j = 0; j < batch; ++j) {
+                keys[j] = distr(gen)+1;
+            }
+            auto op_start = PhaseClock::now();
+            sl.MultiContains(keys, batch, found);
+            latency.Add(NanosSince(op_start) / batch);
+        }
+    });
+
+    Report("Uniform Multi-Get", "UniformMultiGet", "Lookup", write, read, w, r);
+}
 
-    // Insert Print
-    // sl.Print();
+// Keys per InsertBatch call in the Insert-Batch benchmark
+static const int kInsertBatch = 256;
 
-    // Delete for random keys
-    auto r_start = Clock::now();
-    for (int i = 1; i <= read; ++i) {
-        sl.Delete(distr(gen)+1);
+template<typename List>
+void Uniform_InsertBatch(const int write, const int read, List& sl) {
+    // Uniformly distributed random generator (one engine per thread)
+    std::random_device rd;
+    const unsigned int seed = rd();
+
+    // Insert random keys in batches; the latency sample is the amortized cost per key
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        std::vector<Key> keys(kInsertBatch);
+        for (int i = begin; i < end; i += kInsertBatch) {
+            int batch = std::min(kInsertBatch, end - i);
+            for (int j = 0; j < batch; ++j) {
+                keys[j] = distr(gen)+1;
+            }
+            auto op_start = PhaseClock::now();
+            sl.InsertBatch(keys.begin(), keys.begin() + batch);
+            latency.Add(NanosSince(op_start) / batch);
+        }
+    });
+    std::cout << "After Insert\n";
+
+    // Search for random keys
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + num_threads + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        for (int i = begin; i < end; ++i) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            sl.Contains(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Uniform Insert-Batch", "UniformInsertBatch", "Lookup", write, read, w, r);
+}
+
+// Saves the list to snapshot_path after a benchmark, then restarts from the file twice:
+// serving lookups straight from the mapping (SnapshotReader) and rebuilding a list (LoadSnapshot)
+int RunSnapshot(const SkipList<Key>& sl, const int read, int max_level, float probability) {
+    std::string error;
+    auto start = PhaseClock::now();
+    if (!sl.SaveSnapshot(snapshot_path, &error)) {
+        std::cerr << "SaveSnapshot failed: " << error << "\n";
+        return 1;
     }
-    auto r_end = Clock::now();
+    double save_s = NanosSince(start) * 1e-9;
 
-    // Calculate search time
-    float r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
+    start = PhaseClock::now();
+    SnapshotReader<Key> reader;
+    if (!reader.Open(snapshot_path)) {
+        std::cerr << "SnapshotReader failed: " << reader.Error() << "\n";
+        return 1;
+    }
+    double open_s = NanosSince(start) * 1e-9;
+
+    // 매핑에서 바로 조회 (키 범위 안의 임의의 키)
+    size_t found = 0;
+    std::mt19937_64 gen(std::random_device{}());
+    Key low = reader.Size() > 0 ? reader.Keys()[0] : 0;
+    Key high = reader.Size() > 0 ? reader.Keys()[reader.Size() - 1] : 0;
+    std::uniform_int_distribution<Key> distr(low, high);
+    start = PhaseClock::now();
+    for (int i = 0; i < read; ++i) {
+        found += reader.Contains(distr(gen));
+    }
+    double lookup_s = NanosSince(start) * 1e-9;
 
-    // Display results
-    printf("\n[Uniform Delete] Insertion = %.2lf µs, Deletion = %.2lf µs\n", w_time, r_time);
-    
-    // 파일에 저장
-    std::ofstream outFile("output.csv", std::ios::app); // append 모드
-    if (outFile.is_open()) {
-        outFile << write << "," << read << ",UniformDelete," << w_time << "," << r_time << "\n";
-        outFile.close();
+    start = PhaseClock::now();
+    SkipList<Key> loaded(max_level, probability);
+    if (!loaded.LoadSnapshot(snapshot_path, &error) || loaded.Size() != sl.Size()) {
+        std::cerr << "LoadSnapshot failed: " << (error.empty() ? "size mismatch" : error) << "\n";
+        return 1;
     }
+    double load_s = NanosSince(start) * 1e-9;
+
+    printf("\n[Snapshot] %zu keys, %.1f MB in %s\n", reader.Size(), reader.FileBytes() / 1048576.0, snapshot_path.c_str());
+    printf("  Save = %.3f s, Open + verify = %.3f s, LoadSnapshot (rebuild) = %.3f s\n", save_s, open_s, load_s);
+    printf("  Lookups from the mapping = %.0f ops/s (%zu of %d found)\n", read / std::max(lookup_s, 1e-9), found, read);
+    return 0;
 }
 
-void Uniform_Scan(const int write, const int read, SkipList<Key> &sl) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> distr(0, write);
-
-    auto w_start = Clock::now();
-    for(int i = 1; i <= write; i++) {
-        //Key key = distr(gen)+1;
-        Key key = i;
-        sl.Insert(key);
+const char* SyncPolicyName(SyncPolicy policy) {
+    switch (policy) {
+        case SyncPolicy::kEveryOp: return "every";
+        case SyncPolicy::kInterval: return "interval";
+        case SyncPolicy::kNone: return "none";
     }
-    auto w_end = Clock::now();
-    printf("After Insert\n");
-    auto r_start = Clock::now();
-    for(int i = 1; i <= read; i++) {
-        Key key = distr(gen)+1;
-        sl.Scan(key, 1000);
+    return "?";
+}
+
+// Runs a benchmark on a List behind a write-ahead log (--wal), then reopens the log and times
+// its replay into an empty list, which is what a restart would do. 'args' construct the list.
+template<typename List, typename... Args>
+int RunLogged(const int W, const int R, const int B, const char* programName, Args... args) {
+    std::remove(wal_path.c_str()); // 이전 실행의 로그는 버린다
+    WriteAheadLog<Key>::Stats stats;
+    {
+        WriteAheadLog<Key> log(wal_path, sync_policy, sync_interval_ms);
+        Logged<Key, List> sl(log, args...);
+        int ret = RunBenchmark(W, R, B, sl, programName);
+        if (ret != 0) return ret;
+        stats = log.GetStats();
     }
-    auto r_end = Clock::now();
 
-    float r_time, w_time;
-    r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
-    w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
-    printf("\n[Uniform-Scan] Insertion = %.2lf µs, Lookup = %.2lf µs\n", w_time, r_time);
-    
-    // 파일에 저장
-    std::ofstream outFile("output.csv", std::ios::app); // append 모드
-    if (outFile.is_open()) {
-        outFile << write << "," << read << ",UniformScan," << w_time << "," << r_time << "\n";
-        outFile.close();
+    auto start = PhaseClock::now();
+    WriteAheadLog<Key> log(wal_path, sync_policy, sync_interval_ms);
+    Logged<Key, List> sl(log, args...);
+    size_t records = sl.Replay();
+    double replay_s = NanosSince(start) * 1e-9;
+
+    printf("\n[WAL] sync = %s", SyncPolicyName(sync_policy));
+    if (sync_policy == SyncPolicy::kInterval) printf(" (%d ms)", sync_interval_ms);
+    printf(", %llu records, %.1f MB in %s\n", static_cast<unsigned long long>(stats.records),
+           stats.bytes / 1048576.0, wal_path.c_str());
+    printf("  During the run: fsyncs = %llu (%.1f records per fsync), writes = %llu\n",
+           static_cast<unsigned long long>(stats.syncs), stats.RecordsPerSync(), static_cast<unsigned long long>(stats.writes));
+    printf("  Recovery: replayed %zu records in %.3f s\n", records, replay_s);
+    if (records != stats.records) {
+        std::cerr << "Replay found " << records << " records, expected " << stats.records << "\n";
+        return 1;
     }
+    return 0;
 }
 
 void printUsage(const char* programName) {
-    std::cerr << "\nUsage: " << programName << " [Write Count] [Read Count] [Benchmark #] [Max Level] [Probability]\n\n"
+    std::cerr << "\nUsage: " << programName << " [Write Count] [Read Count] [Benchmark #] [Max Level] [Probability] [--snapshot PATH] [--threads N]\n"
+              << "       " << programName << " [Write Count] [Read Count] [Benchmark #] ... --wal PATH [--sync every|interval|none] [--sync-interval MS]\n"
+              << "       " << programName << " --sweep [--sweep-keys N1,...] [--sweep-levels L1,...] [--sweep-probs P1,...] [--sweep-benchmarks B1,...]\n\n"
               << "Benchmark can be selected by number or name.\n\n"
               << "Synthetic Benchmarks:\n"
               << " 0 - Sequential\n"
@@ -282,44 +517,224 @@ void printUsage(const char* programName) {
               << " 3 - Zipfian\n"
               << " 4 - Uniform Delete\n"
               << " 5 - Zipfian Delete\n"
-              << " 6 - Scan\n";
+              << " 6 - Scan\n"
+              << " 7 - Bulk Load (sorted keys, then sequential lookups)\n"
+              << " 8 - Reverse Scan (1000 keys <= a random key, largest first)\n"
+              << " 9 - Uniform Multi-Get (lookups in batches of 64 via MultiContains)\n"
+              << " 10 - Uniform Insert-Batch (inserts in batches of 256 via InsertBatch)\n\n"
+              << "Parameters:\n"
+              << " Max Level   - tallest tower; 0 (default) grows it with the list size as 1 + log_{1/p}(N)\n"
+              << " Probability - chance that a tower grows one more level, 0 < p < 1 (default 0.5)\n\n"
+              << "Options:\n"
+              << " --snapshot PATH - after the benchmark save the list to PATH, then time reopening it:\n"
+              << "               lookups served from the mapped file and a rebuild with LoadSnapshot\n"
+              << " --wal PATH  - log every Insert/Delete to PATH first (a new log; with --threads the writers\n"
+              << "               share fsyncs), then report fsyncs and time a replay of the log\n"
+              << " --sync P    - when a logged operation is durable: every (fsync before it returns, default),\n"
+              << "               interval (background fsync every --sync-interval MS, default 10) or none\n"
+              << " --threads N - split every phase across N threads sharing one ConcurrentSkipList\n"
+              << " --sweep     - run the selected benchmarks (default: Uniform) for each key count\n"
+              << "               (write = read = N), max level and probability; print throughput,\n"
+              << "               average search hops and memory per key, and write them to sweep.csv\n";
 }
 
-int main(int argc, char *argv[]) {
-    if (argc != 4) {
-        printUsage(argv[0]);
-        return 1;
-    }
-
-    const int W = std::atoi(argv[1]);               // Insertion count
-    const int R = std::atoi(argv[2]);               // Lookup count
-    const int B = std::atoi(argv[3]);               // Benchmark type
-
-    SkipList<Key> sl;
-
-    auto runBenchmarkType1 = [&](const std::string& name, void (*benchmarkFunc)(int, int, SkipList<Key>&)) {
+template<typename List>
+int RunBenchmark(const int W, const int R, const int B, List& sl, const char* programName) {
+    auto runBenchmarkType1 = [&](const std::string& name, void (*benchmarkFunc)(int, int, List&)) {
         std::cout << "\n[" << name << " Benchmark in progress...]\n\n";
         benchmarkFunc(W, R, sl);
     };
 
     switch (B) {
         // Type 1:
-        case 0: runBenchmarkType1("Sequential", Sequential); break;
-        case 1: runBenchmarkType1("Rev-Sequential", RevSequential); break;
-        case 2: runBenchmarkType1("Uniform", Uniform); break;
-        case 3: runBenchmarkType1("Zipfian", Zipfian); break;
-        case 4: runBenchmarkType1("Uniform Delete", Uniform_Delete); break;
-        case 5: runBenchmarkType1("Zipfian Delete", Zipfian_Delete); break;
-        case 6: runBenchmarkType1("Scan", Uniform_Scan); break;
+        case 0: runBenchmarkType1("Sequential", Sequential<List>); break;
+        case 1: runBenchmarkType1("Rev-Sequential", RevSequential<List>); break;
+        case 2: runBenchmarkType1("Uniform", Uniform<List>); break;
+        case 3: runBenchmarkType1("Zipfian", Zipfian<List>); break;
+        case 4: runBenchmarkType1("Uniform Delete", Uniform_Delete<List>); break;
+        case 5: runBenchmarkType1("Zipfian Delete", Zipfian_Delete<List>); break;
+        case 6: runBenchmarkType1("Scan", Uniform_Scan<List>); break;
+        case 7: runBenchmarkType1("Bulk Load", Bulk_Load<List>); break;
+        case 8: runBenchmarkType1("Reverse Scan", Reverse_Scan<List>); break;
+        case 9: runBenchmarkType1("Uniform Multi-Get", Uniform_MultiGet<List>); break;
+        case 10: runBenchmarkType1("Uniform Insert-Batch", Uniform_InsertBatch<List>); break;
 
         default:
             std::cerr << "Invalid benchmark option provided.\n";
-            printUsage(argv[0]);
+            printUsage(programName);
             return 1;
     }
 
+    // 노드 메모리 사용량 (arena 기준)
+    printf("Memory usage = %zu bytes\n", sl.ApproximateMemoryUsage());
+
     // Print
     // sl.Print();
 
     return 0;
-}
\ No newline at end of file
+}
+
+// One row of the --sweep table
+struct SweepRow {
+    int keys;
+    int max_level; // As requested (0 = grows with the list)
+    float probability;
+    int benchmark;
+    int height; // Tallest tower at the end of the run
+    double write_ops;
+    double read_ops;
+    double search_hops;
+    double bytes_per_key;
+};
+
+// Parses a comma separated list of numbers ("4,16,64")
+template<typename T>
+std::vector<T> ParseList(const char* arg) {
+    std::vector<T> values;
+    for (const char* p = arg; *p != '\0';) {
+        values.push_back(static_cast<T>(std::atof(p)));
+        p = std::strchr(p, ',');
+        if (p == nullptr) break;
+        ++p;
+    }
+    return values;
+}
+
+// Average CountSearchHops over keys drawn from the benchmark key range [2, keys + 1]
+template<typename List>
+double AverageSearchHops(const List& sl, int keys) {
+    const int kSamples = 10000;
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> distr(1, keys);
+    size_t hops = 0;
+    for (int i = 0; i < kSamples; ++i) {
+        hops += sl.CountSearchHops(distr(gen) + 1);
+    }
+    return static_cast<double>(hops) / kSamples;
+}
+
+// Runs the selected benchmarks for every (key count, max level, probability) on a fresh list
+int RunSweep(const std::vector<int>& key_counts, const std::vector<int>& levels, const std::vector<float>& probs,
+             const std::vector<int>& benchmarks, const char* programName) {
+    static const char* kNames[] = {"Sequential", "RevSequential", "Uniform", "Zipfian",
+                                   "UniformDelete", "ZipfianDelete", "UniformScan", "BulkLoad",
+                                   "ReverseScan", "UniformMultiGet", "UniformInsertBatch"};
+    const int kNumBenchmarks = 11;
+
+    std::vector<SweepRow> rows;
+    for (int keys : key_counts) {
+        for (float p : probs) {
+            for (int level : levels) {
+                for (int b : benchmarks) {
+                    if (b < 0 || b >= kNumBenchmarks) {
+                        std::cerr << "Invalid benchmark option provided.\n";
+                        printUsage(programName);
+                        return 1;
+                    }
+                    SkipList<Key> sl(level, p);
+                    RunBenchmark(keys, keys, b, sl, programName);
+                    double bytes_per_key = sl.Size() > 0 ? static_cast<double>(sl.ApproximateMemoryUsage()) / sl.Size() : 0.0;
+                    rows.push_back({keys, level, p, b, sl.Height(), last_write.OpsPerSec(), last_read.OpsPerSec(),
+                                    AverageSearchHops(sl, keys), bytes_per_key});
+                }
+            }
+        }
+    }
+
+    // 결과 표 출력 및 sweep.csv 저장
+    std::ofstream outFile("sweep.csv");
+    outFile << "Keys,MaxLevel,Probability,Benchmark,Height,InsertOps/s,Read/DeleteOps/s,SearchHops,BytesPerKey\n";
+    printf("\n%10s %8s %6s %-18s %6s %14s %18s %11s %10s\n",
+           "Keys", "MaxLevel", "p", "Benchmark", "Height", "Insert ops/s", "Read/Delete ops/s", "Search hops", "Bytes/key");
+    for (const SweepRow& row : rows) {
+        std::string level = row.max_level > 0 ? std::to_string(row.max_level) : "auto";
+        printf("%10d %8s %6.3f %-18s %6d %14.0lf %18.0lf %11.1lf %10.1lf\n", row.keys, level.c_str(), row.probability,
+               kNames[row.benchmark], row.height, row.write_ops, row.read_ops, row.search_hops, row.bytes_per_key);
+        outFile << row.keys << "," << level << "," << row.probability << "," << kNames[row.benchmark] << ","
+                << row.height << "," << static_cast<long>(row.write_ops) << "," << static_cast<long>(row.read_ops) << ","
+                << row.search_hops << "," << row.bytes_per_key << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    // 옵션(--threads, --sweep...)을 분리하고 나머지는 위치 인자로 처리
+    std::vector<char*> args;
+    bool concurrent = false;
+    bool sweep = false;
+    std::vector<int> sweep_keys = {10000, 100000, 1000000};
+    std::vector<int> sweep_levels = {SkipList<Key>::kAutoMaxLevel, 8, 12, 16, 24, 32};
+    std::vector<float> sweep_probs = {0.5f, 0.25f, static_cast<float>(1 / M_E), 0.125f};
+    std::vector<int> sweep_benchmarks = {2};
+    for (int i = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            num_threads = std::atoi(argv[++i]);
+            concurrent = true;
+        } else if (std::strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+            snapshot_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--wal") == 0 && i + 1 < argc) {
+            wal_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--sync") == 0 && i + 1 < argc) {
+            ++i;
+            if (std::strcmp(argv[i], "every") == 0) sync_policy = SyncPolicy::kEveryOp;
+            else if (std::strcmp(argv[i], "interval") == 0) sync_policy = SyncPolicy::kInterval;
+            else if (std::strcmp(argv[i], "none") == 0) sync_policy = SyncPolicy::kNone;
+            else sync_interval_ms = -1; // 잘못된 정책: 아래에서 사용법 출력
+        } else if (std::strcmp(argv[i], "--sync-interval") == 0 && i + 1 < argc) {
+            sync_interval_ms = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--sweep") == 0) {
+            sweep = true;
+        } else if (std::strcmp(argv[i], "--sweep-keys") == 0 && i + 1 < argc) {
+            sweep_keys = ParseList<int>(argv[++i]);
+        } else if (std::strcmp(argv[i], "--sweep-levels") == 0 && i + 1 < argc) {
+            sweep_levels = ParseList<int>(argv[++i]);
+        } else if (std::strcmp(argv[i], "--sweep-probs") == 0 && i + 1 < argc) {
+            sweep_probs = ParseList<float>(argv[++i]);
+        } else if (std::strcmp(argv[i], "--sweep-benchmarks") == 0 && i + 1 < argc) {
+            sweep_benchmarks = ParseList<int>(argv[++i]);
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+
+    if (sweep && args.size() == 1 && !concurrent) {
+        return RunSweep(sweep_keys, sweep_levels, sweep_probs, sweep_benchmarks, argv[0]);
+    }
+
+    if (sweep || args.size() < 4 || args.size() > 6 || num_threads < 1 || (concurrent && !snapshot_path.empty()) ||
+        (!wal_path.empty() && !snapshot_path.empty()) || sync_interval_ms < 1) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    const int W = std::atoi(args[1]);               // Insertion count
+    const int R = std::atoi(args[2]);               // Lookup count
+    const int B = std::atoi(args[3]);               // Benchmark type
+    const int max_level = args.size() > 4 ? std::atoi(args[4]) : SkipList<Key>::kAutoMaxLevel;
+    const float probability = args.size() > 5 ? std::atof(args[5]) : 0.5f;
+    if (max_level < 0 || probability <= 0 || probability >= 1) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (!wal_path.empty()) {
+        if (concurrent) {
+            return RunLogged<ConcurrentSkipList<Key>>(W, R, B, argv[0], max_level > 0 ? max_level : 16, probability);
+        }
+        return RunLogged<SkipList<Key>>(W, R, B, argv[0], max_level, probability);
+    }
+
+    // 멀티스레드 모드에서는 lock-free 구현을 공유 (레벨 자동 조정이 없으므로 0이면 기본값 16)
+    if (concurrent) {
+        ConcurrentSkipList<Key> sl(max_level > 0 ? max_level : 16, probability);
+        int ret = RunBenchmark(W, R, B, sl, argv[0]);
+        // 삭제된 노드 중 epoch가 넘어가길 기다리는 양
+        printf("Retired (not yet reclaimed) = %zu bytes\n", sl.RetiredBytes());
+        return ret;
+    }
+
+    SkipList<Key> sl(max_level, probability);
+    int ret = RunBenchmark(W, R, B, sl, argv[0]);
+    if (ret == 0 && !snapshot_path.empty()) ret = RunSnapshot(sl, R, max_level, probability);
+    return ret;
+}
@@ -0,0 +1,478 @@
+#ifndef LAB1_SKIPLIST_SNAPSHOT_H_
+#define LAB1_SKIPLIST_SNAPSHOT_H_
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <nmmintrin.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "value_slot.h"
+
+// Snapshot file format (version 1, native byte order):
+//
+//   [SnapshotHeader, 64 bytes]
+//   [keys:   count sorted keys]
+//   [values: count values of value_bytes each (absent for sets)]       padded to 8 bytes
+//   [index:  static search levels over the keys, lowest level first]
+//
+// Index level 1 holds the first key of every block of 'fanout' keys, level 2 the first
+// key of every block of 'fanout' level 1 keys, and so on until a level fits in one
+// block. A lookup therefore reads one block per level, like a descent of a B+ tree
+// whose nodes are the blocks, and can run directly on the mapped file.
+//
+// Every section has its own CRC32C and the header is covered by one too, so a
+// truncated or corrupted file is rejected instead of loaded.
+static constexpr uint64_t kSnapshotMagic = 0x3150414e534b5653ULL; // "SVKSNAP1"
+static constexpr uint32_t kSnapshotVersion = 1;
+
+struct SnapshotHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t key_bytes;
+    uint32_t value_bytes;  // 0 for set-only structures
+    uint32_t fanout;       // Keys per index block
+    uint64_t count;        // Number of entries
+    uint64_t index_keys;   // Keys over all index levels
+    uint32_t index_levels;
+    uint32_t keys_crc;
+    uint32_t values_crc;
+    uint32_t index_crc;
+    uint32_t reserved;
+    uint32_t header_crc;   // CRC32C of the header bytes before this field
+};
+static_assert(sizeof(SnapshotHeader) == 64, "the snapshot header is 64 bytes");
+
+namespace snapshot_detail {
+
+typedef uint32_t (*CrcFn)(uint32_t crc, const unsigned char* data, size_t n);
+
+inline uint32_t Crc32cScalar(uint32_t crc, const unsigned char* data, size_t n) {
+    // 반사형 CRC32C (Castagnoli) 다항식의 바이트 단위 테이블
+    static const std::vector<uint32_t> table = [] {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1)));
+            t[i] = c;
+        }
+        return t;
+    }();
+    for (size_t i = 0; i < n; ++i) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return crc;
+}
+
+// SSE4.2 crc32 instruction: 8 bytes per step
+__attribute__((target("sse4.2")))
+inline uint32_t Crc32cSSE42(uint32_t crc, const unsigned char* data, size_t n) {
+    uint64_t c = crc;
+    for (; n >= 8; n -= 8, data += 8) {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        c = _mm_crc32_u64(c, word);
+    }
+    crc = static_cast<uint32_t>(c);
+    for (; n > 0; --n, ++data) crc = _mm_crc32_u8(crc, *data);
+    return crc;
+}
+
+inline CrcFn ResolveCrc32c() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2") ? Crc32cSSE42 : Crc32cScalar;
+}
+
+inline size_t Align8(size_t n) { return (n + 7) & ~size_t(7); }
+
+// Value bytes stored per entry (nothing for NoValue)
+template<typename ValueType>
+constexpr size_t ValueBytes() { return std::is_empty<ValueType>::value ? 0 : sizeof(ValueType); }
+
+// Sizes of the index levels over 'count' keys (level 1 first)
+inline std::vector<size_t> IndexLevelSizes(size_t count, size_t fanout) {
+    std::vector<size_t> sizes;
+    for (size_t n = count; n > fanout; n = (n + fanout - 1) / fanout) {
+        sizes.push_back((n + fanout - 1) / fanout);
+    }
+    return sizes;
+}
+
+}  // namespace snapshot_detail
+
+// CRC32C of data[0..n), continuing from 'crc' (0 for a new checksum)
+inline uint32_t Crc32c(uint32_t crc, const void* data, size_t n) {
+    static const snapshot_detail::CrcFn fn = snapshot_detail::ResolveCrc32c();
+    return ~fn(~crc, static_cast<const unsigned char*>(data), n);
+}
+
+// SnapshotWriter: streams sorted entries into a snapshot file.
+//
+// The entry count is fixed up front so that every section has a known offset; keys and
+// values are buffered separately and written with pwrite. The file is written under
+// path + ".tmp", synced and renamed over 'path' by Finish, so an existing snapshot is
+// only replaced by a complete one. Finish then syncs the directory so that the new
+// name survives a crash too.
+template<typename Key, typename ValueType = NoValue>
+class SnapshotWriter {
+    static_assert(std::is_trivially_copyable<Key>::value, "snapshot keys are written as bytes");
+    static_assert(std::is_trivially_copyable<ValueType>::value, "snapshot values are written as bytes");
+
+   public:
+    static constexpr size_t kValueBytes = snapshot_detail::ValueBytes<ValueType>();
+
+    SnapshotWriter(const std::string& path, size_t count, size_t fanout)
+        : path(path), tmp_path(path + ".tmp"), count(count), fanout(std::max<size_t>(2, fanout)), added(0),
+          keys(0), values(0), failed(false) {
+        fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) Fail("open");
+        keys.offset = sizeof(SnapshotHeader);
+        values.offset = keys.offset + count * sizeof(Key);
+        index_offset = snapshot_detail::Align8(values.offset + count * kValueBytes);
+        first_keys.reserve((count + this->fanout - 1) / this->fanout);
+    }
+
+    ~SnapshotWriter() {
+        if (fd >= 0) {
+            close(fd);
+            unlink(tmp_path.c_str());
+        }
+    }
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    // Appends the next entry; 'value' is ignored for sets
+    void Add(const Key& key, const ValueType* value) {
+        if (added % fanout == 0) first_keys.push_back(key);
+        keys.Append(this, &key, sizeof(Key));
+        if (kValueBytes > 0) values.Append(this, value, kValueBytes);
+        added++;
+    }
+
+    // Writes the index and the header and publishes the file; false on an I/O error
+    // or if the number of entries added differs from the count given up front
+    bool Finish() {
+        if (added != count && !failed) {
+            failed = true;
+            error = "entry count does not match the snapshot size";
+        }
+        keys.Flush(this);
+        values.Flush(this);
+
+        // 인덱스 층: 아래 층 블록마다 첫 키 (블록 하나에 들어갈 때까지)
+        uint32_t index_crc = 0;
+        size_t offset = index_offset;
+        size_t index_keys = 0;
+        std::vector<size_t> sizes = snapshot_detail::IndexLevelSizes(count, fanout);
+        std::vector<Key> level = std::move(first_keys);
+        for (size_t l = 0; l < sizes.size(); ++l) {
+            if (l > 0) {
+                size_t out = 0;
+                for (size_t i = 0; i < level.size(); i += fanout) level[out++] = level[i];
+                level.resize(out);
+            }
+            size_t bytes = level.size() * sizeof(Key);
+            WriteAt(level.data(), bytes, offset);
+            index_crc = Crc32c(index_crc, level.data(), bytes);
+            offset += bytes;
+            index_keys += level.size();
+        }
+        // 값 뒤의 정렬 패딩까지 포함한 길이로 맞춘다 (인덱스가 없을 때도)
+        if (!failed && ftruncate(fd, static_cast<off_t>(offset)) != 0) Fail("ftruncate");
+
+        SnapshotHeader header = {};
+        header.magic = kSnapshotMagic;
+        header.version = kSnapshotVersion;
+        header.key_bytes = sizeof(Key);
+        header.value_bytes = kValueBytes;
+        header.fanout = static_cast<uint32_t>(fanout);
+        header.count = count;
+        header.index_keys = index_keys;
+        header.index_levels = static_cast<uint32_t>(sizes.size());
+        header.keys_crc = keys.crc;
+        header.values_crc = values.crc;
+        header.index_crc = index_crc;
+        header.header_crc = Crc32c(0, &header, offsetof(SnapshotHeader, header_crc));
+        WriteAt(&header, sizeof(header), 0);
+
+        if (!failed && fsync(fd) != 0) Fail("fsync");
+        if (close(fd) != 0 && !failed) Fail("close");
+        fd = -1;
+        if (!failed && rename(tmp_path.c_str(), path.c_str()) != 0) Fail("rename");
+        if (!failed) SyncDirectory(); // 새 이름 자체도 크래시 후에 남도록
+        if (failed) unlink(tmp_path.c_str());
+        return !failed;
+    }
+
+    // Description of the first error (empty if none)
+    const std::string& Error() const { return error; }
+
+   private:
+    static constexpr size_t kBufferBytes = 1 << 20;
+
+    // One section written sequentially through a buffer
+    struct Section {
+        explicit Section(size_t offset) : offset(offset), crc(0) {}
+
+        void Append(SnapshotWriter* writer, const void* data, size_t n) {
+            if (buffer.size() + n > kBufferBytes) Flush(writer);
+            const char* bytes = static_cast<const char*>(data);
+            buffer.insert(buffer.end(), bytes, bytes + n);
+        }
+
+        void Flush(SnapshotWriter* writer) {
+            if (buffer.empty()) return;
+            writer->WriteAt(buffer.data(), buffer.size(), offset);
+            crc = Crc32c(crc, buffer.data(), buffer.size());
+            offset += buffer.size();
+            buffer.clear();
+        }
+
+        size_t offset;
+        uint32_t crc;
+        std::vector<char> buffer;
+    };
+
+    void WriteAt(const void* data, size_t n, size_t offset) {
+        const char* bytes = static_cast<const char*>(data);
+        while (n > 0 && !failed) {
+            ssize_t written = pwrite(fd, bytes, n, static_cast<off_t>(offset));
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                Fail("pwrite");
+                return;
+            }
+            bytes += written;
+            offset += written;
+            n -= written;
+        }
+    }
+
+    void Fail(const char* what) {
+        if (failed) return;
+        failed = true;
+        error = std::string(what) + " " + tmp_path + ": " + std::strerror(errno);
+    }
+
+    // fsyncs the directory holding 'path' so that the rename is durable too
+    void SyncDirectory() {
+        size_t slash = path.rfind('/');
+        std::string dir = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        int dir_fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if (dir_fd < 0) return Fail("open the directory of");
+        if (fsync(dir_fd) != 0) Fail("fsync the directory of");
+        close(dir_fd);
+    }
+
+    std::string path;
+    std::string tmp_path;
+    int fd;
+    size_t count;
+    size_t fanout;
+    size_t added;
+    Section keys;
+    Section values;
+    size_t index_offset;
+    std::vector<Key> first_keys; // Index level 1, collected while the keys stream past
+    bool failed;
+    std::string error;
+};
+
+// SnapshotReader: maps a snapshot file read-only.
+//
+// After Open the entries can be served straight from the mapping (LowerBound, Contains,
+// Get, Scan: one index block per level, then one key block) or streamed in order with
+// Begin/End, e.g. into a bulk load. Pages are read by the OS on first touch.
+template<typename Key, typename ValueType = NoValue>
+class SnapshotReader {
+   public:
+    static constexpr size_t kValueBytes = snapshot_detail::ValueBytes<ValueType>();
+
+    // Forward iterator over the entries as (key, value) pairs
+    class EntryIterator {
+       public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef std::pair<Key, ValueType> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const value_type* pointer;
+        typedef const value_type& reference;
+
+        EntryIterator() : reader(nullptr), index(0) {}
+        EntryIterator(const SnapshotReader* reader, size_t index) : reader(reader), index(index) {}
+
+        reference operator*() const {
+            entry.first = reader->keys[index];
+            if (kValueBytes > 0) std::memcpy(&entry.second, reader->values + index * kValueBytes, kValueBytes);
+            return entry;
+        }
+        pointer operator->() const { return &**this; }
+        EntryIterator& operator++() { ++index; return *this; }
+        EntryIterator operator++(int) { EntryIterator old = *this; ++index; return old; }
+        bool operator==(const EntryIterator& other) const { return index == other.index; }
+        bool operator!=(const EntryIterator& other) const { return index != other.index; }
+        friend difference_type operator-(const EntryIterator& a, const EntryIterator& b) {
+            return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
+        }
+
+       private:
+        const SnapshotReader* reader;
+        size_t index;
+        mutable value_type entry; // 역참조 결과 (값은 정렬되어 있지 않을 수 있어 복사한다)
+    };
+
+    SnapshotReader() : data(nullptr), bytes(0), keys(nullptr), values(nullptr), count(0), fanout(0) {}
+    ~SnapshotReader() { Close(); }
+
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    // Maps 'path' and checks the header against Key and ValueType. With 'verify' the
+    // checksums of all sections are checked too, which reads the whole file once.
+    // Returns false (see Error) if the file cannot be used.
+    bool Open(const std::string& path, bool verify = true) {
+        Close();
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return Fail("open " + path + ": " + std::strerror(errno));
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return Fail("stat " + path + ": " + std::strerror(errno));
+        }
+        bytes = st.st_size;
+        if (bytes < sizeof(SnapshotHeader)) {
+            close(fd);
+            return Fail(path + " is too short to be a snapshot");
+        }
+        void* mapped = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) return Fail("mmap " + path + ": " + std::strerror(errno));
+        data = static_cast<const char*>(mapped);
+        // 전체를 읽을 예정이면 미리 읽기를 요청해 둔다
+        if (verify) madvise(mapped, bytes, MADV_WILLNEED);
+
+        const SnapshotHeader& header = *reinterpret_cast<const SnapshotHeader*>(data);
+        if (header.magic != kSnapshotMagic) return Fail(path + " is not a snapshot");
+        if (header.version != kSnapshotVersion) return Fail(path + " has an unsupported snapshot version");
+        if (Crc32c(0, &header, offsetof(SnapshotHeader, header_crc)) != header.header_crc) {
+            return Fail(path + ": header checksum mismatch");
+        }
+        if (header.key_bytes != sizeof(Key) || header.value_bytes != kValueBytes) {
+            return Fail(path + ": key/value sizes do not match this structure");
+        }
+        // 크기 계산 전에 확인: fanout 0은 0으로 나누기, 1은 인덱스 층이 끝나지 않는다
+        if (header.fanout < 2) return Fail(path + ": invalid index fanout");
+        if (header.count > (bytes - sizeof(SnapshotHeader)) / (sizeof(Key) + kValueBytes)) {
+            return Fail(path + ": section sizes do not match the file");
+        }
+        count = header.count;
+        fanout = header.fanout;
+        size_t values_offset = sizeof(SnapshotHeader) + count * sizeof(Key);
+        size_t index_offset = snapshot_detail::Align8(values_offset + count * kValueBytes);
+        level_sizes = snapshot_detail::IndexLevelSizes(count, fanout);
+        size_t index_keys = 0;
+        for (size_t size : level_sizes) index_keys += size;
+        if (header.index_levels != level_sizes.size() || header.index_keys != index_keys ||
+            index_offset + index_keys * sizeof(Key) != bytes) {
+            return Fail(path + ": section sizes do not match the file");
+        }
+
+        keys = reinterpret_cast<const Key*>(data + sizeof(SnapshotHeader));
+        values = data + values_offset;
+        levels.clear();
+        const Key* level = reinterpret_cast<const Key*>(data + index_offset);
+        for (size_t size : level_sizes) {
+            levels.push_back(level);
+            level += size;
+        }
+
+        if (verify) {
+            if (Crc32c(0, keys, count * sizeof(Key)) != header.keys_crc ||
+                Crc32c(0, values, count * kValueBytes) != header.values_crc ||
+                Crc32c(0, data + index_offset, index_keys * sizeof(Key)) != header.index_crc) {
+                return Fail(path + ": data checksum mismatch");
+            }
+        }
+        return true;
+    }
+
+    void Close() {
+        if (data != nullptr) munmap(const_cast<char*>(data), bytes);
+        data = nullptr;
+        keys = nullptr;
+        values = nullptr;
+        count = 0;
+    }
+
+    const std::string& Error() const { return error; }
+
+    size_t Size() const { return count; }
+    size_t FileBytes() const { return bytes; }
+    const Key* Keys() const { return keys; }
+
+    EntryIterator Begin() const { return EntryIterator(this, 0); }
+    EntryIterator End() const { return EntryIterator(this, count); }
+
+    // Position of the first key >= 'key' (Size() if there is none)
+    size_t LowerBound(const Key& key) const {
+        // 위 층부터 블록 하나씩: key 이하인 마지막 첫 키의 블록으로 내려간다
+        size_t begin = 0;
+        size_t end = level_sizes.empty() ? count : level_sizes.back();
+        for (size_t l = levels.size(); l-- > 0;) {
+            const Key* level = levels[l];
+            size_t j = std::upper_bound(level + begin, level + end, key) - level;
+            size_t block = j > begin ? j - 1 : begin;
+            begin = block * fanout;
+            end = std::min(begin + fanout, l > 0 ? level_sizes[l - 1] : count);
+        }
+        return std::lower_bound(keys + begin, keys + end, key) - keys;
+    }
+
+    bool Contains(const Key& key) const {
+        size_t pos = LowerBound(key);
+        return pos < count && keys[pos] == key;
+    }
+
+    bool Get(const Key& key, ValueType* value) const {
+        size_t pos = LowerBound(key);
+        if (pos == count || keys[pos] != key) return false;
+        if (kValueBytes > 0) std::memcpy(value, values + pos * kValueBytes, kValueBytes);
+        return true;
+    }
+
+    // Copies up to 'scan_num' keys >= 'key' into out; returns the number copied
+    size_t Scan(const Key& key, size_t scan_num, Key* out) const {
+        size_t pos = LowerBound(key);
+        size_t n = std::min(scan_num, count - pos);
+        std::copy(keys + pos, keys + pos + n, out);
+        return n;
+    }
+
+   private:
+    bool Fail(const std::string& message) {
+        Close();
+        error = message;
+        return false;
+    }
+
+    const char* data;
+    size_t bytes;
+    const Key* keys;
+    const char* values;
+    size_t count;
+    size_t fanout;
+    std::vector<size_t> level_sizes;  // Index level sizes, level 1 first
+    std::vector<const Key*> levels;   // Index levels in the mapping, level 1 first
+    std::string error;
+};
+
+#endif  // LAB1_SKIPLIST_SNAPSHOT_H_
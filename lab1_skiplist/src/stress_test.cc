@@ -0,0 +1,745 @@
+// Regression tests for the skiplists, the snapshot format and the write-ahead log.
+//
+// Every structure is checked against std::set: single-threaded with random operations,
+// and ConcurrentSkipList with threads that each own a slice of the key space (so every
+// result on their own keys is exact) while also fighting over a shared hot range.
+// Run with "make test"; "make test-tsan" and "make test-asan" build it with a sanitizer.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "arena.h"
+#include "random_level.h"
+#include "skiplist.h"
+#include "concurrent_skiplist.h"
+#include "snapshot.h"
+#include "wal.h"
+#include "benchmark.h"
+#include "histogram.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                    \
+    do {                                                                               \
+        if (!(cond)) {                                                                 \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                                \
+        }                                                                              \
+    } while (0)
+
+// Keys of 'model' in [from, ...), at most n of them
+static std::vector<Key> ModelScan(const std::set<Key>& model, Key from, int n) {
+    std::vector<Key> keys;
+    for (auto it = model.lower_bound(from); it != model.end() && static_cast<int>(keys.size()) < n; ++it) {
+        keys.push_back(*it);
+    }
+    return keys;
+}
+
+// Keys of 'model' <= from, largest first, at most n of them
+static std::vector<Key> ModelReverseScan(const std::set<Key>& model, Key from, int n) {
+    std::vector<Key> keys;
+    for (auto it = model.upper_bound(from); it != model.begin() && static_cast<int>(keys.size()) < n;) {
+        keys.push_back(*--it);
+    }
+    return keys;
+}
+
+// Batched lookups of every size around the group width, unsorted and with duplicates,
+// agree with the model
+template<typename Tree, typename Model>
+static void CheckMultiContains(const Tree& tree, const Model& model, Key range, uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    for (size_t n : {0, 1, 15, 16, 17, 64, 100}) {
+        std::vector<Key> keys(n);
+        for (Key& key : keys) key = gen() % range;
+        if (n > 1) keys[n - 1] = keys[0];
+        std::unique_ptr<bool[]> found(new bool[n + 1]);
+        tree.MultiContains(keys.data(), n, found.get());
+        for (size_t i = 0; i < n; ++i) {
+            auto it = model.lower_bound(keys[i]);
+            CHECK(found[i] == (it != model.end() && *it == keys[i]));
+        }
+    }
+}
+
+// Random Insert/Delete/Contains/Scan/ReverseScan against std::set, then a bulk build
+template<typename List>
+static void TestAgainstSet(const char* name, List& list, uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    std::set<Key> model;
+    const Key kRange = 5000;
+    for (int i = 0; i < 60000; ++i) {
+        Key key = gen() % kRange;
+        switch (gen() % 6) {
+            case 0:
+            case 1:
+                list.Insert(key);
+                model.insert(key);
+                break;
+            case 2:
+                CHECK(list.Delete(key) == (model.erase(key) == 1));
+                break;
+            case 3:
+                CHECK(list.Contains(key) == (model.count(key) == 1));
+                break;
+            case 4: {
+                int n = static_cast<int>(gen() % 40) - 4; // 음수와 0도 포함
+                CHECK(list.Scan(key, n) == ModelScan(model, key, n));
+                break;
+            }
+            case 5: {
+                int n = static_cast<int>(gen() % 40) - 4;
+                CHECK(list.ReverseScan(key, n) == ModelReverseScan(model, key, n));
+                break;
+            }
+        }
+    }
+    CHECK(list.Scan(0, kRange + 1) == ModelScan(model, 0, kRange + 1));
+    CheckMultiContains(list, model, kRange + 10, seed);
+
+    // 기존 키보다 큰 정렬된 키는 이어 붙이고, 섞인 키는 일반 삽입으로 처리되어야 한다
+    std::vector<Key> sorted;
+    for (Key key = kRange; key < 2 * kRange; key += 1 + gen() % 3) sorted.push_back(key);
+    sorted.push_back(7); // 정렬이 깨지는 키
+    list.BuildFromSorted(sorted.begin(), sorted.end());
+    model.insert(sorted.begin(), sorted.end());
+    CHECK(list.Scan(0, 2 * kRange) == ModelScan(model, 0, 2 * kRange));
+    CHECK(list.ReverseScan(2 * kRange, 2 * kRange) == ModelReverseScan(model, 2 * kRange, 2 * kRange));
+
+    // 정렬되지 않고 중복이 섞인 배치는 키마다 Insert한 것과 같아야 한다
+    for (size_t n : {0, 1, 100, 3000}) {
+        std::vector<Key> batch(n);
+        for (Key& key : batch) key = gen() % (3 * kRange);
+        list.InsertBatch(batch.begin(), batch.end());
+        model.insert(batch.begin(), batch.end());
+    }
+    CHECK(list.Scan(0, 3 * kRange) == ModelScan(model, 0, 3 * kRange));
+    std::cout << name << ": " << model.size() << " keys match std::set\n";
+}
+
+// Put/Get/Update/Delete/ScanKV of a key-value SkipList against std::map
+template<typename Value, typename MakeValue>
+static void TestKeyValue(const char* name, MakeValue make_value) {
+    SkipList<Key, Value> list;
+    std::map<Key, Value> model;
+    std::mt19937_64 gen(21);
+    for (int i = 0; i < 60000; ++i) {
+        Key key = gen() % 5000;
+        Value value{};
+        switch (gen() % 6) {
+            case 0:
+            case 1:
+                list.Put(key, make_value(i));
+                model[key] = make_value(i);
+                break;
+            case 2:
+                CHECK(list.Delete(key) == (model.erase(key) == 1));
+                break;
+            case 3:
+                CHECK(list.Get(key, &value) == (model.count(key) == 1));
+                CHECK(model.count(key) == 0 || value == model[key]);
+                break;
+            case 4: {
+                bool present = model.count(key) == 1;
+                CHECK(list.Update(key, make_value(-i)) == present);
+                if (present) model[key] = make_value(-i);
+                break;
+            }
+            case 5: {
+                int n = static_cast<int>(gen() % 40) - 4;
+                auto entries = list.ScanKV(key, n);
+                auto expected = model.lower_bound(key);
+                for (const auto& entry : entries) {
+                    CHECK(expected != model.end() && entry.first == expected->first && *entry.second == expected->second);
+                    if (expected != model.end()) ++expected;
+                }
+                CHECK(static_cast<int>(entries.size()) == std::max(n, 0) || expected == model.end());
+                break;
+            }
+        }
+    }
+    std::vector<std::pair<Key, Value>> sorted;
+    for (Key key = 5000; key < 8000; key += 1 + gen() % 3) sorted.emplace_back(key, make_value(key));
+    list.BuildFromSorted(sorted.begin(), sorted.end());
+    model.insert(sorted.begin(), sorted.end());
+    // 배치 삽입은 기존 값을 덮어쓰지 않고, 배치 안의 중복은 첫 번째가 남는다
+    std::vector<std::pair<Key, Value>> pairs;
+    for (int i = 0; i < 2000; ++i) {
+        Key key = gen() % 9000;
+        pairs.emplace_back(key, make_value(i));
+        model.emplace(key, make_value(i));
+    }
+    list.InsertBatch(pairs.begin(), pairs.end());
+    std::vector<Key> keys;
+    for (const auto& entry : model) keys.push_back(entry.first);
+    CHECK(list.Scan(0, 9001) == keys);
+    for (const auto& entry : model) {
+        Value value{};
+        CHECK(list.Get(entry.first, &value) && value == entry.second);
+    }
+
+    // 배치 조회: 입력 순서대로, 찾은 키에만 값이 채워진다
+    std::vector<Key> batch(100);
+    for (Key& key : batch) key = gen() % 9000;
+    std::vector<Value> values(batch.size());
+    std::unique_ptr<bool[]> found(new bool[batch.size()]);
+    list.MultiGet(batch.data(), batch.size(), values.data(), found.get());
+    for (size_t i = 0; i < batch.size(); ++i) {
+        CHECK(found[i] == (model.count(batch[i]) == 1));
+        CHECK(!found[i] || values[i] == model[batch[i]]);
+    }
+
+    // 반복자: 양방향 순회와 Seek 후 Prev가 모델과 같아야 한다
+    typename SkipList<Key, Value>::Iterator it(&list);
+    auto expected = model.begin();
+    for (it.SeekToFirst(); it.Valid() && expected != model.end(); it.Next(), ++expected) {
+        CHECK(it.key() == expected->first && *it.value() == expected->second);
+    }
+    CHECK(!it.Valid() && expected == model.end());
+    auto reverse = model.rbegin();
+    for (it.SeekToLast(); it.Valid() && reverse != model.rend(); it.Prev(), ++reverse) {
+        CHECK(it.key() == reverse->first);
+    }
+    CHECK(!it.Valid() && reverse == model.rend());
+    for (int i = 0; i < 1000; ++i) {
+        Key target = gen() % 9000;
+        auto lower = model.lower_bound(target);
+        it.Seek(target);
+        CHECK(it.Valid() == (lower != model.end()));
+        if (!it.Valid()) continue;
+        CHECK(it.key() == lower->first);
+        it.Prev();
+        CHECK(it.Valid() == (lower != model.begin()));
+        if (it.Valid()) CHECK(it.key() == std::prev(lower)->first);
+        it.SeekForPrev(target);
+        auto upper = model.upper_bound(target);
+        CHECK(it.Valid() == (upper != model.begin()));
+        if (it.Valid()) CHECK(it.key() == std::prev(upper)->first);
+    }
+    std::cout << name << ": " << model.size() << " pairs match std::map\n";
+}
+
+// The automatic max level grows with the list; deleting every key brings the height back to 1
+static void TestHeightShrinks() {
+    SkipList<Key> list(SkipList<Key>::kAutoMaxLevel, 0.5);
+    std::vector<Key> keys(50000);
+    for (size_t i = 0; i < keys.size(); ++i) keys[i] = i * 7;
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(9));
+    for (Key key : keys) list.Insert(key);
+    CHECK(list.Size() == keys.size());
+    CHECK(list.Height() > 8);
+    for (Key key : keys) CHECK(list.Delete(key));
+    CHECK(list.Size() == 0 && list.Height() == 1);
+    CHECK(list.Scan(0, 10).empty());
+    // 기본 생성자는 고정된 max level 16을 쓴다
+    SkipList<Key> fixed;
+    for (Key key = 0; key < 200000; ++key) fixed.Insert(key);
+    CHECK(fixed.Height() <= 16);
+    std::cout << "SkipList: height returns to 1 after deleting every key\n";
+}
+
+static std::string TempPath(const char* name) {
+    return std::string("/tmp/lab1_stress_") + std::to_string(getpid()) + "_" + name;
+}
+
+// P(level >= k) must follow p^(k-1) on both the ctz path and the threshold path
+static void TestLevelGenerator() {
+    const float probabilities[] = {0.5f, 0.25f, 0.125f, 0.3f, 1 / 2.718281828f, 0.9f};
+    const int draws = 400000;
+    for (float p : probabilities) {
+        LevelGenerator generator(p);
+        std::vector<int> at_least(LevelGenerator::kMaxLevels + 2, 0);
+        for (int i = 0; i < draws; ++i) {
+            int level = generator.Next(LevelGenerator::kMaxLevels);
+            CHECK(level >= 1 && level <= LevelGenerator::kMaxLevels);
+            for (int k = 1; k <= level; ++k) at_least[k]++;
+        }
+        for (int k = 2; k <= 5; ++k) {
+            double expected = std::pow(p, k - 1);
+            CHECK(std::fabs(double(at_least[k]) / draws - expected) < 0.01);
+        }
+    }
+    // 경계: p = 0 이면 항상 1, p = 1 이면 항상 max_level
+    LevelGenerator never(0.0f), always(1.0f);
+    for (int i = 0; i < 1000; ++i) {
+        CHECK(never.Next(12) == 1);
+        CHECK(always.Next(12) == 12);
+        CHECK(always.Next(LevelGenerator::kMaxLevels) == LevelGenerator::kMaxLevels);
+    }
+    std::cout << "LevelGenerator: level distribution matches p^(k-1)\n";
+}
+
+// Search cost stays logarithmic at p = 1/2 and explodes when the max level is too low
+static void TestSearchHops() {
+    SkipList<Key> empty;
+    CHECK(empty.CountSearchHops(5) == 0);
+    SkipList<Key> tall(32, 0.5), flat(1, 0.5);
+    for (Key key = 0; key < 20000; ++key) {
+        tall.Insert(key * 2);
+        flat.Insert(key * 2);
+    }
+    size_t tall_hops = 0, flat_hops = 0;
+    for (Key key = 1; key < 40000; key += 400) {
+        tall_hops += tall.CountSearchHops(key);
+        flat_hops += flat.CountSearchHops(key);
+    }
+    CHECK(tall_hops / 100 < 100);
+    CHECK(flat_hops / 100 > 1000); // 레벨 1이면 선형 탐색
+    std::cout << "SkipList: " << tall_hops / 100 << " hops per search at max level 32, "
+              << flat_hops / 100 << " at max level 1\n";
+}
+
+// Aligned allocations of every size stay aligned and never overlap, including the
+// large ones that get a block of their own
+static void TestArena() {
+    Arena arena;
+    std::mt19937_64 gen(5);
+    std::vector<std::pair<char*, size_t>> allocations;
+    size_t total = 0;
+    for (int i = 0; i < 20000; ++i) {
+        size_t bytes = i % 100 == 0 ? 20000 + gen() % 50000 : 1 + gen() % 200;
+        size_t align = size_t(1) << (gen() % 7); // 1 ~ 64
+        char* p = arena.AllocateAligned(bytes, align);
+        CHECK(reinterpret_cast<uintptr_t>(p) % align == 0);
+        std::memset(p, i & 0xff, bytes);
+        allocations.emplace_back(p, bytes);
+        total += bytes;
+    }
+    // 나중 할당이 앞선 할당의 내용을 덮어쓰지 않아야 한다
+    for (size_t i = 0; i < allocations.size(); ++i) {
+        char* p = allocations[i].first;
+        CHECK(p[0] == static_cast<char>(i & 0xff) && p[allocations[i].second - 1] == static_cast<char>(i & 0xff));
+    }
+    CHECK(arena.MemoryUsage() >= total);
+    std::cout << "Arena: " << allocations.size() << " aligned allocations intact\n";
+}
+
+// Deleted nodes are reused: deleting every key and inserting as many new ones barely grows the arena
+static void TestNodeReuse() {
+    SkipList<Key> list;
+    for (Key key = 0; key < 20000; ++key) list.Insert(key);
+    size_t usage = list.ApproximateMemoryUsage();
+    for (Key key = 0; key < 20000; ++key) CHECK(list.Delete(key));
+    for (Key key = 20000; key < 40000; ++key) list.Insert(key);
+    CHECK(list.ApproximateMemoryUsage() < usage * 5 / 4);
+    CHECK(list.Scan(0, 20001).size() == 20000);
+    std::cout << "SkipList: " << usage << " bytes before, " << list.ApproximateMemoryUsage()
+              << " bytes after replacing every key\n";
+}
+
+// BuildFromSorted on a ConcurrentSkipList publishes whole nodes: readers running
+// during the build only ever see a sorted prefix of the input
+static void TestBuildWithReaders() {
+    ConcurrentSkipList<Key> list(12, 0.5);
+    std::vector<Key> sorted;
+    for (Key key = 0; key < 200000; key += 2) sorted.push_back(key);
+    std::atomic<bool> done(false);
+    std::atomic<int> reader_failures(0);
+    std::vector<std::thread> readers;
+    for (int tid = 0; tid < 3; ++tid) {
+        readers.emplace_back([&, tid] {
+            std::mt19937_64 gen(tid);
+            while (!done.load()) {
+                Key from = gen() % 200000;
+                std::vector<Key> keys = list.Scan(from, 32);
+                for (size_t i = 0; i < keys.size(); ++i) {
+                    Key expected = (i == 0 ? (from + 1) / 2 * 2 : keys[i - 1] + 2);
+                    if (keys[i] != expected) reader_failures++;
+                }
+            }
+        });
+    }
+    list.BuildFromSorted(sorted.begin(), sorted.end());
+    done = true;
+    for (std::thread& t : readers) t.join();
+    CHECK(reader_failures == 0);
+    CHECK(list.Scan(0, sorted.size() + 1) == sorted);
+    std::cout << "ConcurrentSkipList: readers see a sorted prefix during BuildFromSorted\n";
+}
+
+// Threads own the keys k with k % threads == tid and check every result on them exactly;
+// all of them also insert and delete a shared hot range to make the CASes collide.
+static void TestConcurrentSkipList(int threads, int ops_per_thread) {
+    const Key kOwnedRange = 20000;
+    const Key kHotBase = 1000000, kHotRange = 64;
+    ConcurrentSkipList<Key> list(12, 0.5);
+    std::vector<std::set<Key>> models(threads);
+    std::atomic<int> thread_failures(0);
+
+    auto worker = [&](int tid) {
+        std::mt19937_64 gen(tid + 1);
+        std::set<Key>& model = models[tid];
+        auto own_key = [&] { return (gen() % (kOwnedRange / threads)) * threads + tid; };
+        int local_failures = 0;
+        for (int i = 0; i < ops_per_thread; ++i) {
+            switch (gen() % 8) {
+                case 0:
+                case 1: {
+                    Key key = own_key();
+                    list.Insert(key);
+                    model.insert(key);
+                    break;
+                }
+                case 2: {
+                    Key key = own_key();
+                    if (list.Delete(key) != (model.erase(key) == 1)) local_failures++;
+                    break;
+                }
+                case 3: {
+                    Key key = own_key();
+                    if (list.Contains(key) != (model.count(key) == 1)) local_failures++;
+                    break;
+                }
+                case 4: {
+                    // 결과는 정렬되어 있어야 하고, 그 구간의 내 키는 정확히 내 모델과 같아야 한다
+                    Key from = gen() % kOwnedRange;
+                    int n = 1 + gen() % 64;
+                    std::vector<Key> keys = list.Scan(from, n);
+                    bool sorted = std::adjacent_find(keys.begin(), keys.end(), std::greater_equal<Key>()) == keys.end();
+                    if (!sorted || (!keys.empty() && keys.front() < from)) local_failures++;
+                    Key last = static_cast<int>(keys.size()) < n ? kHotBase : keys.back() + 1;
+                    std::vector<Key> mine, expected;
+                    for (Key key : keys) {
+                        if (key < kOwnedRange && static_cast<int>(key % threads) == tid) mine.push_back(key);
+                    }
+                    for (auto it = model.lower_bound(from); it != model.end() && *it < last; ++it) expected.push_back(*it);
+                    if (mine != expected) local_failures++;
+                    break;
+                }
+                case 5: {
+                    Key key = own_key();
+                    std::vector<Key> keys = list.ReverseScan(key, 8);
+                    bool sorted = std::adjacent_find(keys.begin(), keys.end(), std::less_equal<Key>()) == keys.end();
+                    if (!sorted || (!keys.empty() && keys.front() > key)) local_failures++;
+                    if (!keys.empty() && (keys.front() == key) != (model.count(key) == 1)) local_failures++;
+                    break;
+                }
+                default: {
+                    Key key = kHotBase + gen() % kHotRange;
+                    if (gen() % 2 == 0) {
+                        list.Insert(key);
+                    } else {
+                        list.Delete(key);
+                    }
+                    break;
+                }
+            }
+        }
+        thread_failures += local_failures;
+    };
+
+    std::vector<std::thread> pool;
+    for (int tid = 0; tid < threads; ++tid) pool.emplace_back(worker, tid);
+    for (std::thread& t : pool) t.join();
+    CHECK(thread_failures == 0);
+
+    // 최종 상태: 소유 구간은 모델의 합집합, 핫 구간은 Contains와 일치하는 정렬된 키
+    std::set<Key> all;
+    for (const std::set<Key>& model : models) all.insert(model.begin(), model.end());
+    std::vector<Key> owned = list.Scan(0, kOwnedRange);
+    owned.erase(std::lower_bound(owned.begin(), owned.end(), kOwnedRange), owned.end());
+    CHECK(owned == std::vector<Key>(all.begin(), all.end()));
+    std::vector<Key> hot = list.Scan(kHotBase, kHotRange + 1);
+    CHECK(static_cast<Key>(hot.size()) <= kHotRange);
+    for (Key key = kHotBase; key < kHotBase + kHotRange; ++key) {
+        CHECK(list.Contains(key) == std::binary_search(hot.begin(), hot.end(), key));
+    }
+    std::cout << "ConcurrentSkipList: " << threads << " threads, " << all.size() + hot.size()
+              << " keys match, " << list.RetiredBytes() << " bytes waiting for reclamation\n";
+}
+
+// Deleted nodes are reclaimed while the list is in use, not only in the destructor
+static void TestConcurrentReclaim() {
+    ConcurrentSkipList<Key> list(12, 0.5);
+    std::atomic<int> missing(0);
+    for (int round = 0; round < 4; ++round) {
+        RunPhase(4, 50000, [&](int, int begin, int end, Histogram&) {
+            for (int i = begin; i < end; ++i) list.Insert(i);
+        });
+        size_t peak = list.ApproximateMemoryUsage();
+        RunPhase(4, 50000, [&](int, int begin, int end, Histogram&) {
+            for (int i = begin; i < end; ++i) missing += !list.Delete(i);
+        });
+        CHECK(list.Scan(0, 10).empty());
+        // 스레드가 선점된 채 epoch를 잡고 있으면 limbo 리스트가 길어질 수 있다.
+        // 아무도 epoch를 잡고 있지 않을 때의 삭제 몇 백 번이면 epoch가 충분히 넘어가 비워진다.
+        for (Key key = 0; key < 256; ++key) list.Insert(key);
+        for (Key key = 0; key < 256; ++key) missing += !list.Delete(key);
+        CHECK(list.ApproximateMemoryUsage() < peak / 8);
+    }
+    CHECK(missing == 0);
+    std::cout << "ConcurrentSkipList: " << list.ApproximateMemoryUsage() << " bytes left after deleting every key\n";
+}
+
+// Percentiles are within one sub-bucket (1/32) above the exact sample, and merging
+// two halves gives the same histogram as recording everything in one
+static void TestHistogram() {
+    std::mt19937_64 gen(17);
+    std::vector<uint64_t> samples;
+    Histogram all, first, second;
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t value = gen() >> (gen() % 64); // 모든 자릿수에 고르게
+        samples.push_back(value);
+        all.Add(value);
+        (i % 2 == 0 ? first : second).Add(value);
+    }
+    std::sort(samples.begin(), samples.end());
+    first.Merge(second);
+    CHECK(all.Count() == samples.size() && all.Min() == samples.front() && all.Max() == samples.back());
+    for (double p : {0.0, 1.0, 50.0, 90.0, 99.0, 99.9, 100.0}) {
+        size_t rank = std::max<size_t>(1, static_cast<size_t>(samples.size() * (p / 100.0)));
+        uint64_t exact = samples[rank - 1];
+        uint64_t estimate = all.Percentile(p);
+        CHECK(estimate >= exact && estimate - exact <= exact / 32);
+        CHECK(first.Percentile(p) == estimate);
+    }
+    CHECK(Histogram().Percentile(50) == 0);
+    std::cout << "Histogram: percentiles within 1/32 of the exact samples\n";
+}
+
+// RunPhase hands every operation to exactly one worker, and merges the workers' latencies
+static void TestRunPhase() {
+    const int kOps = 10007;
+    for (int threads : {1, 3, 8}) {
+        std::vector<int> seen(kOps, 0);
+        PhaseResult result = RunPhase(threads, kOps, [&](int, int begin, int end, Histogram& latency) {
+            for (int i = begin; i < end; ++i) {
+                seen[i]++;
+                latency.Add(i);
+            }
+        });
+        CHECK(std::count(seen.begin(), seen.end(), 1) == kOps);
+        CHECK(result.ops == kOps && static_cast<int>(result.thread_ops.size()) == threads);
+        long total = 0;
+        for (long ops : result.thread_ops) total += ops;
+        CHECK(total == kOps && result.latency.Count() == kOps);
+    }
+
+    // 드라이버의 --threads 경로: 여러 스레드가 구간을 나눠 하나의 리스트에 삽입한다
+    ConcurrentSkipList<Key> list(12, 0.5);
+    RunPhase(4, kOps, [&](int, int begin, int end, Histogram&) {
+        for (int i = begin; i < end; ++i) list.Insert(i);
+    });
+    std::vector<Key> keys = list.Scan(0, kOps + 1);
+    CHECK(keys.size() == kOps && keys.front() == 0 && keys.back() == kOps - 1);
+    std::cout << "RunPhase: every operation runs exactly once\n";
+}
+
+// Snapshot round trip; a corrupted, truncated or inconsistent file must be rejected
+static void TestSnapshot() {
+    std::string path = TempPath("snapshot");
+    SkipList<Key> list;
+    std::set<Key> model;
+    std::mt19937_64 gen(7);
+    for (int i = 0; i < 100000; ++i) {
+        Key key = gen() % 1000000;
+        list.Insert(key);
+        model.insert(key);
+    }
+    std::string error;
+    CHECK(list.SaveSnapshot(path, &error));
+
+    SkipList<Key> loaded;
+    CHECK(loaded.LoadSnapshot(path, &error));
+    CHECK(loaded.Scan(0, model.size() + 1) == std::vector<Key>(model.begin(), model.end()));
+
+    SnapshotReader<Key> reader;
+    CHECK(reader.Open(path, true));
+    for (int i = 0; i < 10000; ++i) {
+        Key key = gen() % 1000000;
+        CHECK(reader.Contains(key) == (model.count(key) == 1));
+    }
+    reader.Close();
+
+    // 키 영역의 한 바이트를 바꾸면 CRC 검사에서 거부되어야 한다
+    int fd = open(path.c_str(), O_RDWR);
+    char byte;
+    CHECK(pread(fd, &byte, 1, sizeof(SnapshotHeader) + 3) == 1);
+    byte ^= 0x40;
+    CHECK(pwrite(fd, &byte, 1, sizeof(SnapshotHeader) + 3) == 1);
+    SkipList<Key> corrupted;
+    CHECK(!corrupted.LoadSnapshot(path, &error));
+
+    // CRC가 맞더라도 fanout이나 개수가 잘못된 헤더는 거부되어야 한다 (0으로 나누기, 무한 루프, 넘침)
+    SnapshotHeader original;
+    CHECK(pread(fd, &original, sizeof(original), 0) == sizeof(original));
+    for (int variant = 0; variant < 3; ++variant) {
+        SnapshotHeader header = original;
+        if (variant < 2) header.fanout = variant;
+        else header.count = UINT64_MAX / 4;
+        header.header_crc = Crc32c(0, &header, offsetof(SnapshotHeader, header_crc));
+        CHECK(pwrite(fd, &header, sizeof(header), 0) == sizeof(header));
+        CHECK(!reader.Open(path, false));
+    }
+    // 원래 헤더로는 (데이터 CRC를 검사하지 않으면) 다시 열려야 한다
+    CHECK(pwrite(fd, &original, sizeof(original), 0) == sizeof(original));
+    CHECK(reader.Open(path, false));
+    reader.Close();
+    CHECK(ftruncate(fd, sizeof(SnapshotHeader) + 100) == 0);
+    CHECK(!corrupted.LoadSnapshot(path, &error));
+    close(fd);
+    unlink(path.c_str());
+    std::cout << "Snapshot: round trip and corruption checks done\n";
+}
+
+// Recovery from a log whose tail was torn by a crash: intact records replay, the torn
+// record and everything after it are dropped, and new appends continue after them
+static void TestWalTornTail() {
+    std::string path = TempPath("wal");
+    unlink(path.c_str());
+    std::set<Key> model;
+    {
+        WriteAheadLog<Key> log(path, SyncPolicy::kNone);
+        Logged<Key, SkipList<Key>> list(log);
+        std::mt19937_64 gen(11);
+        for (int i = 0; i < 10000; ++i) {
+            Key key = gen() % 2000;
+            if (gen() % 3 == 0) {
+                list.Delete(key);
+                model.erase(key);
+            } else {
+                list.Insert(key);
+                model.insert(key);
+            }
+        }
+    }
+    // 마지막 레코드를 반쯤 잘라낸다: 그 레코드(키 12345 삽입)는 복구되면 안 된다
+    {
+        WriteAheadLog<Key> log(path, SyncPolicy::kNone);
+        Logged<Key, SkipList<Key>> list(log);
+        list.Insert(12345);
+    }
+    int fd = open(path.c_str(), O_RDWR);
+    off_t size = lseek(fd, 0, SEEK_END);
+    CHECK(ftruncate(fd, size - 3) == 0);
+    close(fd);
+    {
+        WriteAheadLog<Key> log(path, SyncPolicy::kNone);
+        Logged<Key, SkipList<Key>> list(log);
+        CHECK(list.Replay() == 10000);
+        CHECK(list.Scan(0, 20000) == std::vector<Key>(model.begin(), model.end()));
+        list.Insert(54321);
+        model.insert(54321);
+    }
+    // 체크섬이 틀린 마지막 레코드도 잘린 꼬리로 취급된다
+    fd = open(path.c_str(), O_RDWR);
+    size = lseek(fd, 0, SEEK_END);
+    char byte;
+    CHECK(pread(fd, &byte, 1, size - 1) == 1);
+    byte ^= 1;
+    CHECK(pwrite(fd, &byte, 1, size - 1) == 1);
+    close(fd);
+    model.erase(54321);
+    {
+        WriteAheadLog<Key> log(path, SyncPolicy::kNone);
+        Logged<Key, SkipList<Key>> list(log);
+        CHECK(list.Replay() == 10000);
+        CHECK(list.Scan(0, 20000) == std::vector<Key>(model.begin(), model.end()));
+    }
+    unlink(path.c_str());
+    std::cout << "WriteAheadLog: torn tail recovery done\n";
+}
+
+// Concurrent logged writers with group commit; the replayed list must match the live one
+static void TestWalConcurrentReplay() {
+    std::string path = TempPath("wal_concurrent");
+    unlink(path.c_str());
+    std::vector<Key> live;
+    {
+        WriteAheadLog<Key> log(path, SyncPolicy::kInterval, 1);
+        Logged<Key, ConcurrentSkipList<Key>> list(log, 12, 0.5);
+        std::vector<std::thread> pool;
+        for (int tid = 0; tid < 4; ++tid) {
+            pool.emplace_back([&list, tid] {
+                std::mt19937_64 gen(tid + 100);
+                for (int i = 0; i < 5000; ++i) {
+                    Key key = gen() % 500; // 스레드끼리 같은 키를 두고 경쟁
+                    if (gen() % 2 == 0) {
+                        list.Insert(key);
+                    } else {
+                        list.Delete(key);
+                    }
+                }
+            });
+        }
+        for (std::thread& t : pool) t.join();
+        live = list.Scan(0, 1000);
+    }
+    WriteAheadLog<Key> log(path, SyncPolicy::kNone);
+    Logged<Key, SkipList<Key>> replayed(log);
+    CHECK(replayed.Replay() == 20000);
+    CHECK(replayed.Scan(0, 1000) == live);
+    unlink(path.c_str());
+    std::cout << "WriteAheadLog: concurrent writers replay to the same list\n";
+}
+
+int main() {
+    {
+        SkipList<Key> list(SkipList<Key>::kAutoMaxLevel, 0.5);
+        TestAgainstSet("SkipList (automatic max level)", list, 1);
+    }
+    {
+        SkipList<Key> list(4, 0.25); // 낮은 고정 높이
+        TestAgainstSet("SkipList (max level 4)", list, 2);
+    }
+    {
+        SkipList<Key> list(32, 0.75); // 높은 노드: 인라인 타워가 여러 캐시 라인에 걸친다
+        TestAgainstSet("SkipList (max level 32)", list, 3);
+    }
+    {
+        SkipList<Key, void, 8> list(100, 0.5); // MaxHeight로 제한된다
+        TestAgainstSet("SkipList<Key, void, 8> (max level 100)", list, 5);
+    }
+    {
+        SkipList<Key> list(-1, 0.5); // 1로 보정된다
+        TestAgainstSet("SkipList (max level -1)", list, 6);
+    }
+    {
+        ConcurrentSkipList<Key> list(12, 0.5);
+        TestAgainstSet("ConcurrentSkipList (one thread)", list, 4);
+    }
+    {
+        ConcurrentSkipList<Key> list(0, 0.5); // 1로 보정되어야 한다
+        TestAgainstSet("ConcurrentSkipList (max level 0)", list, 7);
+    }
+    TestKeyValue<uint64_t>("SkipList<Key, uint64_t>", [](int i) { return static_cast<uint64_t>(i) * 3; });
+    TestKeyValue<std::string>("SkipList<Key, std::string>", [](int i) { return std::to_string(i) + "-value"; });
+    TestHeightShrinks();
+    TestLevelGenerator();
+    TestSearchHops();
+    TestArena();
+    TestNodeReuse();
+    TestConcurrentSkipList(8, 40000);
+    TestConcurrentReclaim();
+    TestBuildWithReaders();
+    TestSnapshot();
+    TestWalTornTail();
+    TestWalConcurrentReplay();
+    TestHistogram();
+    TestRunPhase();
+
+    if (failures > 0) {
+        std::cout << failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "All tests passed\n";
+    return 0;
+}
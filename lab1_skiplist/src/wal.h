@@ -0,0 +1,425 @@
+#ifndef LAB1_SKIPLIST_WAL_H_
+#define LAB1_SKIPLIST_WAL_H_
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "snapshot.h"
+
+// When a logged operation is durable
+enum class SyncPolicy {
+    kEveryOp,  // Before the operation returns (fsyncs are shared by concurrent writers)
+    kInterval, // Within the sync interval: a background thread syncs the log periodically
+    kNone,     // No fsync per operation: records are written when the buffer fills and synced on close
+};
+
+// Operation of a log record
+enum class LogOp : uint32_t {
+    kInsert = 1,
+    kDelete = 2,
+};
+
+// WriteAheadLog: append-only log of key operations.
+//
+// File format: a 16-byte header (magic, version, key size) followed by fixed-size records
+// {crc, op, key}, where crc is the CRC32C of the op and the key. The log sequence number
+// (LSN) of a record is the file offset just past it.
+//
+// Group commit: Append only copies the record into a buffer and returns its LSN. For
+// kEveryOp, WaitDurable(lsn) then makes one of the waiting writers the leader: it takes
+// the whole buffer, writes and fdatasyncs it without holding the lock, and wakes the
+// others. Records appended while the leader is syncing go out together with the next
+// sync, so with N concurrent writers one fsync covers up to N operations.
+//
+// Opening a log validates it and truncates a torn tail (a record cut short by a crash
+// or with a bad checksum): appends continue after the last intact record. I/O errors
+// are fatal: the process prints the error and aborts.
+template<typename Key>
+class WriteAheadLog {
+    static_assert(std::is_trivially_copyable<Key>::value, "log records hold keys as bytes");
+
+   public:
+    struct Stats {
+        uint64_t records = 0; // Records appended
+        uint64_t writes = 0;  // write calls
+        uint64_t syncs = 0;   // fdatasync calls
+        uint64_t bytes = 0;   // Bytes written
+
+        double RecordsPerSync() const { return syncs > 0 ? static_cast<double>(records) / syncs : 0; }
+    };
+
+    WriteAheadLog(const std::string& path, SyncPolicy policy = SyncPolicy::kEveryOp, int interval_ms = 10)
+        : path(path), policy(policy), interval(std::max(1, interval_ms)), flushing(false), stop(false) {
+        fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) Fatal("open");
+        end = ValidEnd();
+        appended = written = durable = end;
+        if (policy == SyncPolicy::kInterval) {
+            syncer = std::thread([this] { SyncLoop(); });
+        }
+    }
+
+    // Writes and syncs every appended record
+    ~WriteAheadLog() {
+        if (syncer.joinable()) {
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                stop = true;
+            }
+            wakeup.notify_all();
+            syncer.join();
+        }
+        Sync();
+        close(fd);
+    }
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // Buffers records for keys[0..n) and returns the LSN of the last one
+    uint64_t Append(LogOp op, const Key* keys, size_t n) {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (size_t i = 0; i < n; ++i) {
+            Record record = {};
+            record.op = static_cast<uint32_t>(op);
+            record.key = keys[i];
+            record.crc = RecordCrc(record);
+            const char* bytes = reinterpret_cast<const char*>(&record);
+            buffer.insert(buffer.end(), bytes, bytes + sizeof(Record));
+        }
+        appended += n * sizeof(Record);
+        stats.records += n;
+        uint64_t lsn = appended;
+        // 동기화를 기다리지 않는 정책은 버퍼가 차면 바로 내보낸다
+        if (policy != SyncPolicy::kEveryOp && buffer.size() >= kBufferBytes && !flushing) {
+            FlushLocked(lock, false);
+        }
+        return lsn;
+    }
+
+    uint64_t Append(LogOp op, const Key& key) { return Append(op, &key, 1); }
+
+    // Returns once the record at 'lsn' is durable as the sync policy defines it:
+    // for kEveryOp it is synced (possibly by another writer's fsync), otherwise this returns at once
+    void WaitDurable(uint64_t lsn) {
+        if (policy != SyncPolicy::kEveryOp) return;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (durable < lsn) {
+            if (flushing) {
+                flushed.wait(lock);
+            } else {
+                FlushLocked(lock, true);
+            }
+        }
+    }
+
+    // Writes and syncs every record appended so far
+    void Sync() {
+        std::unique_lock<std::mutex> lock(mutex);
+        uint64_t target = appended;
+        while (durable < target) {
+            if (flushing) {
+                flushed.wait(lock);
+            } else {
+                FlushLocked(lock, true);
+            }
+        }
+    }
+
+    // Calls apply(op, key) for every intact record, oldest first; returns the number of records.
+    // Meant for recovery, before the first Append.
+    template<typename Apply>
+    size_t Replay(Apply apply) {
+        std::vector<char> chunk(kBufferBytes / sizeof(Record) * sizeof(Record));
+        size_t count = 0;
+        for (uint64_t offset = sizeof(LogHeader); offset < end;) {
+            size_t n = std::min<uint64_t>(chunk.size(), end - offset);
+            ReadAt(chunk.data(), n, offset);
+            for (size_t i = 0; i < n; i += sizeof(Record)) {
+                Record record;
+                std::memcpy(&record, chunk.data() + i, sizeof(Record));
+                apply(static_cast<LogOp>(record.op), record.key);
+            }
+            offset += n;
+            count += n / sizeof(Record);
+        }
+        return count;
+    }
+
+    // Drops every record (e.g. once a checkpoint holds their effects). No appends may run.
+    void Reset() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (flushing) flushed.wait(lock);
+        buffer.clear();
+        end = sizeof(LogHeader);
+        if (ftruncate(fd, end) != 0) Fatal("ftruncate");
+        if (fdatasync(fd) != 0) Fatal("fdatasync");
+        appended = written = durable = end;
+    }
+
+    Stats GetStats() const {
+        std::lock_guard<std::mutex> guard(mutex);
+        return stats;
+    }
+
+    SyncPolicy Policy() const { return policy; }
+
+   private:
+    static constexpr uint64_t kMagic = 0x314c41574b5653ULL; // "SVKWAL1"
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kBufferBytes = 1 << 20;
+
+    struct LogHeader {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t key_bytes;
+    };
+
+    struct Record {
+        uint32_t crc; // CRC32C of the bytes after this field
+        uint32_t op;
+        Key key;
+    };
+
+    static uint32_t RecordCrc(const Record& record) {
+        return Crc32c(0, &record.op, sizeof(Record) - offsetof(Record, op));
+    }
+
+    [[noreturn]] void Fatal(const char* what) const {
+        std::fprintf(stderr, "WriteAheadLog %s: %s failed: %s\n", path.c_str(), what, std::strerror(errno));
+        std::abort();
+    }
+
+    // Checks the header (writing it to a new log) and returns the offset past the last
+    // intact record, truncating anything after it
+    uint64_t ValidEnd() {
+        off_t size = lseek(fd, 0, SEEK_END);
+        if (size < 0) Fatal("lseek");
+        LogHeader header = {kMagic, kVersion, sizeof(Key)};
+        if (static_cast<size_t>(size) < sizeof(LogHeader)) {
+            // 새 로그 (또는 헤더조차 다 쓰지 못한 로그)
+            if (ftruncate(fd, 0) != 0) Fatal("ftruncate");
+            WriteAt(&header, sizeof(header), 0);
+            if (fdatasync(fd) != 0) Fatal("fdatasync");
+            return sizeof(LogHeader);
+        }
+        LogHeader found;
+        ReadAt(&found, sizeof(found), 0);
+        if (found.magic != header.magic || found.version != header.version || found.key_bytes != header.key_bytes) {
+            std::fprintf(stderr, "WriteAheadLog %s: not a log of this key type\n", path.c_str());
+            std::abort();
+        }
+
+        std::vector<char> chunk(kBufferBytes / sizeof(Record) * sizeof(Record));
+        uint64_t offset = sizeof(LogHeader);
+        for (;;) {
+            size_t n = std::min<uint64_t>(chunk.size(), size - offset) / sizeof(Record) * sizeof(Record);
+            if (n == 0) break;
+            ReadAt(chunk.data(), n, offset);
+            size_t good = 0;
+            while (good < n) {
+                Record record;
+                std::memcpy(&record, chunk.data() + good, sizeof(Record));
+                if (record.crc != RecordCrc(record)) break;
+                good += sizeof(Record);
+            }
+            offset += good;
+            if (good < n) break;
+        }
+        if (offset != static_cast<uint64_t>(size)) {
+            // 찢어진 꼬리는 잘라내고 그 자리부터 이어 쓴다
+            if (ftruncate(fd, offset) != 0) Fatal("ftruncate");
+            if (fdatasync(fd) != 0) Fatal("fdatasync");
+        }
+        return offset;
+    }
+
+    // Writes the buffered records (and syncs them if 'sync'). Called with the lock held and
+    // no flush running; the lock is released during the I/O so writers can keep appending.
+    void FlushLocked(std::unique_lock<std::mutex>& lock, bool sync) {
+        flushing = true;
+        std::vector<char> batch;
+        batch.swap(buffer);
+        buffer.swap(spare);
+        uint64_t offset = written;
+        uint64_t target = appended;
+        lock.unlock();
+
+        if (!batch.empty()) WriteAt(batch.data(), batch.size(), offset);
+        if (sync && fdatasync(fd) != 0) Fatal("fdatasync");
+
+        lock.lock();
+        stats.writes += !batch.empty();
+        stats.syncs += sync;
+        stats.bytes += batch.size();
+        written = target;
+        if (sync) durable = target;
+        batch.clear();
+        spare.swap(batch); // 다음 번에 버퍼로 재사용
+        flushing = false;
+        flushed.notify_all();
+    }
+
+    // kInterval: syncs whatever was appended once per interval
+    void SyncLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stop) {
+            wakeup.wait_for(lock, interval);
+            if (!flushing && durable < appended) FlushLocked(lock, true);
+        }
+    }
+
+    void WriteAt(const void* data, size_t n, uint64_t offset) {
+        const char* bytes = static_cast<const char*>(data);
+        while (n > 0) {
+            ssize_t done = pwrite(fd, bytes, n, static_cast<off_t>(offset));
+            if (done < 0) {
+                if (errno == EINTR) continue;
+                Fatal("pwrite");
+            }
+            bytes += done;
+            offset += done;
+            n -= done;
+        }
+    }
+
+    void ReadAt(void* data, size_t n, uint64_t offset) {
+        if (pread(fd, data, n, static_cast<off_t>(offset)) != static_cast<ssize_t>(n)) Fatal("pread");
+    }
+
+    std::string path;
+    int fd;
+    SyncPolicy policy;
+    std::chrono::milliseconds interval;
+
+    mutable std::mutex mutex;
+    std::condition_variable flushed; // A flush finished
+    std::condition_variable wakeup;  // Stops the interval thread
+    std::vector<char> buffer;        // Records appended but not yet written
+    std::vector<char> spare;         // Second buffer, swapped in while a flush writes the first
+    uint64_t end;                    // Valid end of the log when it was opened
+    uint64_t appended;               // LSN of the last appended record
+    uint64_t written;                // Records up to here have been written
+    uint64_t durable;                // Records up to here have been synced
+    bool flushing;
+    bool stop;
+    Stats stats;
+    std::thread syncer;
+};
+
+// Logged<Key, Base>: a key set (SkipList, ConcurrentSkipList) whose modifications go through a
+// WriteAheadLog first. Insert, Delete, InsertBatch and BuildFromSorted append their records and
+// apply the change, then wait until the records are durable under the log's sync policy;
+// everything else is inherited unchanged. Put and Update of key-value lists are not logged.
+//
+// Records of one key must reach the log in the order the changes are applied, or a replay
+// could end in a different state than concurrent writers did. Each key hashes to one of
+// kStripes mutexes held across append + apply (batches hold 'batches' exclusively instead);
+// the wait for the fsync happens after the mutex is released, so writers still share fsyncs.
+template<typename Key, typename Base>
+class Logged : public Base {
+   public:
+    template<typename... Args>
+    explicit Logged(WriteAheadLog<Key>& log, Args&&... args) : Base(std::forward<Args>(args)...), log(log) {}
+
+    void Insert(const Key& key) {
+        uint64_t lsn;
+        {
+            std::shared_lock<std::shared_mutex> shared(batches);
+            std::lock_guard<std::mutex> guard(Stripe(key));
+            lsn = log.Append(LogOp::kInsert, key);
+            Base::Insert(key);
+        }
+        log.WaitDurable(lsn);
+    }
+
+    bool Delete(const Key& key) {
+        uint64_t lsn;
+        bool deleted;
+        {
+            std::shared_lock<std::shared_mutex> shared(batches);
+            std::lock_guard<std::mutex> guard(Stripe(key));
+            lsn = log.Append(LogOp::kDelete, key);
+            deleted = Base::Delete(key);
+        }
+        log.WaitDurable(lsn);
+        return deleted;
+    }
+
+    // Batches are logged as one append (one fsync at most)
+    template<typename Iter>
+    void InsertBatch(Iter begin, Iter end) {
+        std::vector<Key> keys(begin, end);
+        uint64_t lsn;
+        {
+            std::lock_guard<std::shared_mutex> guard(batches);
+            lsn = log.Append(LogOp::kInsert, keys.data(), keys.size());
+            Base::InsertBatch(keys.begin(), keys.end());
+        }
+        log.WaitDurable(lsn);
+    }
+
+    template<typename Iter>
+    void BuildFromSorted(Iter begin, Iter end) {
+        std::vector<Key> keys(begin, end);
+        uint64_t lsn;
+        {
+            std::lock_guard<std::shared_mutex> guard(batches);
+            lsn = log.Append(LogOp::kInsert, keys.data(), keys.size());
+            Base::BuildFromSorted(keys.begin(), keys.end());
+        }
+        log.WaitDurable(lsn);
+    }
+
+    // Recovery: applies the records of the log to the list (without logging them again) and
+    // returns how many there were. Call it before any other modification, on an empty list
+    // or on one restored from the snapshot the log was reset after (see Checkpoint).
+    size_t Replay() {
+        return log.Replay([this](LogOp op, const Key& key) {
+            switch (op) {
+                case LogOp::kInsert: Base::Insert(key); break;
+                case LogOp::kDelete: Base::Delete(key); break;
+            }
+        });
+    }
+
+    // Saves a snapshot of the list (Base::SaveSnapshot) and then drops the log records it
+    // covers, so a restart loads the snapshot and replays only what came after. No other
+    // operation may run during a checkpoint.
+    bool Checkpoint(const std::string& snapshot_path, std::string* error = nullptr) {
+        log.Sync();
+        if (!Base::SaveSnapshot(snapshot_path, error)) return false;
+        log.Reset();
+        return true;
+    }
+
+    WriteAheadLog<Key>& Log() { return log; }
+
+   private:
+    static constexpr size_t kStripes = 64;
+
+    std::mutex& Stripe(const Key& key) { return stripes[std::hash<Key>()(key) % kStripes]; }
+
+    WriteAheadLog<Key>& log;
+    std::shared_mutex batches; // Shared by single-key operations, exclusive for batches
+    std::mutex stripes[kStripes];
+};
+
+#endif  // LAB1_SKIPLIST_WAL_H_
@@ -14,4 +14,5 @@ double zeta(long st, long n, double initialsum);
 double zetastatic(long st, long n, double initialsum);
 long nextLong(long itemcount);
 long nextValue();
+long nextValue_r(unsigned int* seed); //thread-safe variant: draws from the caller's seed, leaves the globals untouched
 void setLastValue(long val);
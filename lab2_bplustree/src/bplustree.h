@@ -9,11 +9,19 @@
 #include <smmintrin.h>
 #include <bit>
 #include <functional>
+#include <iterator>
 #include <mutex>
+#include <numeric>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 #include <atomic>
 
+#include "simd_search.h"
+#include "snapshot.h"
+#include "value_slot.h"
+
 // Define Clock and Key types
 typedef std::chrono::high_resolution_clock Clock;
 typedef uint64_t Key;
@@ -29,18 +37,183 @@ int compare_(const Key& a, const Key& b) {
     }
 }
 
+// Values of one leaf, kept parallel to LeafNode::keys (values[i] belongs to keys[i]).
+// The slots live inline in the leaf; only the first 'count' entries are in use.
+// Moving slots between leaves moves ownership of out-of-line values; erasing a
+// slot does not destroy its value (call DestroyValue first).
+template<typename Value, size_t N>
+class LeafSlots {
+   public:
+    typedef ValueSlot<Value> Slot;
+
+    Slot& operator[](size_t i) { return slots[i]; }
+    const Slot& operator[](size_t i) const { return slots[i]; }
+
+    // Opens a gap at 'pos' among the first 'count' slots and stores 'slot' there
+    void Insert(size_t pos, size_t count, const Slot& slot) {
+        std::copy_backward(slots + pos, slots + count, slots + count + 1);
+        slots[pos] = slot;
+    }
+    // Closes the gap left by slot 'pos' among the first 'count' slots
+    void Erase(size_t pos, size_t count) { std::copy(slots + pos + 1, slots + count, slots + pos); }
+    // Copies slots [from, from + n) to 'dst' starting at 'to' (used by split, borrow and merge)
+    void MoveTo(size_t from, size_t n, LeafSlots& dst, size_t to) const {
+        std::copy(slots + from, slots + from + n, dst.slots + to);
+    }
+    // Moves the first 'count' slots up by 'n', leaving room for n slots at the front
+    void ShiftUp(size_t count, size_t n) { std::copy_backward(slots, slots + count, slots + count + n); }
+
+   private:
+    Slot slots[N];
+};
+
+// Set-only trees keep no per-key storage at all.
+template<size_t N>
+class LeafSlots<void, N> {
+   public:
+    typedef ValueSlot<void> Slot;
+
+    Slot& operator[](size_t) { return empty; }
+    const Slot& operator[](size_t) const { return empty; }
+
+    void Insert(size_t, size_t, const Slot&) {}
+    void Erase(size_t, size_t) {}
+    void MoveTo(size_t, size_t, LeafSlots&, size_t) const {}
+    void ShiftUp(size_t, size_t) {}
+
+   private:
+    Slot empty;
+};
+
 // B+ Tree class template definition
-template<typename Key>
+// Bplustree<Key> is a set of keys; Bplustree<Key, Value> maps keys to values stored in the leaves.
+//
+// Nodes are fixed-size blocks of at most NodeBytes bytes (e.g. 256 for a few cache
+// lines, 4096 for a page): keys, children and values are inline arrays, so every
+// node is a single allocation and its capacity is known at compile time.
+template<typename Key, typename Value = void, size_t NodeBytes = 256>
 class Bplustree {
    private:
     // Forward declaration of node structures
     struct Node;
     struct InternalNode;
     struct LeafNode;
+    typedef ValueSlot<Value> Slot;
+
+    static constexpr size_t kCacheLineSize = 64;
+    // Space taken by the node header (is_leaf, count) before the first key
+    static constexpr size_t kHeaderBytes = 8;
+    // Bytes one leaf entry needs for its value (nothing for set-only trees)
+    static constexpr size_t kSlotBytes = std::is_void<Value>::value ? 0 : sizeof(Slot);
+
+    // Array capacities derived from NodeBytes.
+    // An internal node holds up to kInternalKeys keys and one more child;
+    // a leaf holds up to kLeafKeys keys with their values and the next/prev pointers.
+    static constexpr size_t kInternalKeys =
+        (NodeBytes - kHeaderBytes - sizeof(Node*)) / (sizeof(Key) + sizeof(Node*));
+    static constexpr size_t kLeafKeys =
+        (NodeBytes - kHeaderBytes - 2 * sizeof(Node*) - 1) / (sizeof(Key) + kSlotBytes);
 
    public:
+    typedef typename Slot::ValueType ValueType; // NoValue for set-only trees
+
+    // Largest degree whose nodes fit in NodeBytes.
+    // Nodes overflow to 'degree' keys before they split, and a leaf merge can
+    // leave one more key than that, hence the extra leaf entry.
+    static constexpr int kMaxDegree = static_cast<int>(std::min(kInternalKeys, kLeafKeys - 1));
+    static_assert(kLeafKeys >= 1 && kMaxDegree >= 3, "NodeBytes is too small for a degree 3 node");
+    static_assert(kMaxDegree < 65536, "node counts are 16-bit");
+    static constexpr size_t kNodeBytes = NodeBytes;
+
+    // Iterator over the keys in order, walking the leaf chain lazily (nothing is copied).
+    // Any modification of the tree invalidates it.
+    class Iterator {
+       public:
+        explicit Iterator(const Bplustree* tree) : tree(tree), leaf(nullptr), index(0) {}
+
+        bool Valid() const { return leaf != nullptr; }
+        const Key& key() const { return leaf->keys[index]; }
+        const ValueType* value() const { return leaf->values[index].GetValue(); } // nullptr for set-only trees
+
+        void Next() {
+            if (++index == leaf->count) {
+                leaf = leaf->next;
+                index = 0;
+                SkipEmptyLeaves();
+            }
+        }
+        void Prev() {
+            if (index > 0) {
+                --index;
+                return;
+            }
+            // 이전 리프로 (삭제로 빈 리프는 건너뛴다)
+            do {
+                leaf = leaf->prev;
+            } while (leaf != nullptr && leaf->count == 0);
+            if (leaf != nullptr) index = leaf->count - 1;
+        }
+        // Positions at the first key >= target
+        void Seek(const Key& target) {
+            leaf = tree->FindLeaf(target);
+            index = LeafPosition(leaf, target);
+            if (index == leaf->count) {
+                leaf = leaf->next;
+                index = 0;
+            }
+            SkipEmptyLeaves();
+        }
+        // Positions at the last key <= target
+        void SeekForPrev(const Key& target) {
+            leaf = tree->FindLeaf(target);
+            index = LeafPosition(leaf, target);
+            if (index < leaf->count && leaf->keys[index] == target) return;
+            Prev();
+        }
+        void SeekToFirst() {
+            const Node* node = tree->root;
+            while (!node->is_leaf) {
+                node = node->as_internal()->children[0];
+            }
+            leaf = node->as_leaf();
+            index = 0;
+            SkipEmptyLeaves();
+        }
+        void SeekToLast() {
+            const Node* node = tree->root;
+            while (!node->is_leaf) {
+                node = node->as_internal()->children[node->count];
+            }
+            leaf = node->as_leaf();
+            index = leaf->count;
+            Prev();
+        }
+
+       private:
+        // 삭제로 비어 있는 리프는 건너뛴다
+        void SkipEmptyLeaves() {
+            while (leaf != nullptr && leaf->count == 0) {
+                leaf = leaf->next;
+            }
+        }
+
+        const Bplustree* tree;
+        const LeafNode* leaf;
+        size_t index;
+    };
+
     // Constructor: Initializes a B+ Tree with the specified degree (maximum number of children per internal node)
-    Bplustree(int degree = 4);
+    // The degree is clamped to [3, kMaxDegree]; by default nodes are filled to their capacity.
+    Bplustree(int degree = kMaxDegree);
+
+    // Bulk-load constructor: builds the tree from sorted input (see BulkLoad).
+    template<typename Iter>
+    Bplustree(Iter begin, Iter end, double fill_factor = 1.0, int degree = kMaxDegree);
+
+    ~Bplustree();
+
+    Bplustree(const Bplustree&) = delete;
+    Bplustree& operator=(const Bplustree&) = delete;
 
     // Insert function:
     // Inserts a key into the B+ Tree.
@@ -52,109 +225,693 @@ class Bplustree {
     // TODO: Implement key lookup starting from the root and traversing to the appropriate leaf.
     bool Contains(const Key& key) const;
 
+    // MultiContains function:
+    // Looks up keys[0..n) as one batch and sets found[i] for each key (results are in input order).
+    // The batch is sorted and walked down the tree kLookupGroup keys at a time, one level per
+    // step: every child of the group is prefetched before any of them is searched, so the
+    // cache misses of the group overlap instead of being paid one after another.
+    void MultiContains(const Key* keys, size_t n, bool* found) const;
+
     // Scan function:
     // Performs a range query starting from the specified key and returns up to 'scan_num' keys.
-    // TODO: Traverse leaf nodes using the next pointer and collect keys.
-    std::vector<Key> Scan(const Key& key, const int scan_num);
+    // The start is found with one in-leaf search; from there whole runs of leaf keys are
+    // copied at once, and the next leaf is prefetched while the current one is copied.
+    std::vector<Key> Scan(const Key& key, const int scan_num) const;
+    // Same, into a caller-provided buffer of at least 'scan_num' keys; returns the number copied.
+    size_t Scan(const Key& key, size_t scan_num, Key* out) const;
+
+    // ScanRange function:
+    // Keys in [start, end), in order. The buffer version copies at most 'scan_num' of them.
+    std::vector<Key> ScanRange(const Key& start, const Key& end) const;
+    size_t ScanRange(const Key& start, const Key& end, size_t scan_num, Key* out) const;
+
+    // ReverseScan function:
+    // Returns up to 'scan_num' keys <= key, largest first, following the prev pointers.
+    std::vector<Key> ReverseScan(const Key& key, const int scan_num) const;
 
     // Delete function:
-    // Removes the specified key from the tree.
-    // TODO: Implement deletion, handling key removal, merging, or rebalancing nodes if required.
+    // Removes the specified key from the tree in a single root-to-leaf descent. The recursion
+    // keeps the path: a node that falls below half full is fixed by its parent on the way back
+    // up, by merging it with a sibling or, if the two do not fit in one node, evening them out.
     bool Delete(const Key& key);
 
+    // Lazy merge mode: Delete only fixes nodes that become empty (a leaf without keys, an
+    // internal node with a single child) and leaves underfull nodes in place, so a delete
+    // usually touches just its leaf. Underfull nodes are merged by Compact, which Delete runs
+    // by itself once the deletes since the last pass outnumber the keys left (O(1) amortized).
+    void SetLazyMerge(bool lazy) { lazy_merge = lazy; }
+
+    // Compact function:
+    // Merges or evens out every underfull node in one bottom-up pass (see SetLazyMerge).
+    void Compact();
+
+    // BulkLoad function:
+    // Replaces the contents of the tree with the entries in [begin, end) (forward iterators).
+    // Entries are keys, or (key, value) pairs for key-value trees, and must be sorted by key
+    // without duplicates. Leaves are packed left to right to 'fill_factor' of their capacity
+    // (1.0 = full; lower values leave room for later inserts, below 0.5 nodes start under the
+    // usual minimum occupancy), then each internal level is built in one pass over the level
+    // below. Runs in O(N) and writes the nodes sequentially.
+    template<typename Iter>
+    void BulkLoad(Iter begin, Iter end, double fill_factor = 1.0);
+
+    // InsertBatch function:
+    // Inserts the entries in [begin, end) (forward iterators; keys, or (key, value) pairs, in any
+    // order) with the semantics of Insert: keys already present keep their value. The batch is
+    // sorted and pushed down the tree in one recursive pass, so nodes on the common part of the
+    // paths are searched once, every leaf it touches is rewritten once, and a node that
+    // overflows is split once, into as many nodes as it needs.
+    template<typename Iter>
+    void InsertBatch(Iter begin, Iter end);
+
+    // Snapshot functions (file format in snapshot.h):
+    // SaveSnapshot writes the entries in key order, with a static search index whose blocks hold
+    // 'degree' keys, so the file can also be served read-only through SnapshotReader.
+    // LoadSnapshot maps a snapshot, verifies its checksums and replaces the contents of the tree
+    // with it through BulkLoad: O(N), reading the file sequentially. Both return false on failure
+    // and describe it in *error if given; a failed load leaves the tree unchanged.
+    // Values must be trivially copyable.
+    bool SaveSnapshot(const std::string& path, std::string* error = nullptr) const;
+    bool LoadSnapshot(const std::string& path, double fill_factor = 1.0, std::string* error = nullptr);
+
+    // Key-value interface (Value != void):
+    // Put inserts or overwrites, Get copies the value out, Update overwrites only existing keys.
+    void Put(const Key& key, const ValueType& value);
+    bool Get(const Key& key, ValueType* value) const;
+    bool Update(const Key& key, const ValueType& value);
+    // MultiGet: batched Get in the manner of MultiContains; values[i] is written only if found[i].
+    void MultiGet(const Key* keys, size_t n, ValueType* values, bool* found) const;
+
+    // ScanKV function:
+    // Like Scan, but returns (key, pointer to value) pairs without copying the values.
+    // The pointers stay valid until the next modification of the tree.
+    std::vector<std::pair<Key, const ValueType*>> ScanKV(const Key& key, const int scan_num) const;
+
+    // Verify function:
+    // Checks the structure of the tree: sorted keys within the separator bounds of every node,
+    // all leaves at the same depth, node sizes (with the minimum fill of the current merge
+    // mode, see Underfull), the prev/next leaf chain and the key count. Returns false and
+    // describes the first violation in 'error'. For tests and debugging; O(N).
+    bool Verify(std::string* error = nullptr) const;
+
     // Print function:
     // Traverses and prints the internal structure of the B+ Tree.
     // This function is helpful for debugging and verifying that the tree is constructed correctly.
     void Print() const;
 
+    // Number of keys in the tree.
+    size_t Size() const { return num_keys; }
+
+    // Degree in use (after clamping to the node capacity).
+    int Degree() const { return degree; }
+
+    // Returns an estimate of the number of bytes used by the tree:
+    // every allocated node plus the out-of-line values.
+    size_t ApproximateMemoryUsage() const {
+        return num_leaves * sizeof(LeafNode) + num_internals * sizeof(InternalNode) +
+               (Slot::kOutOfLine ? num_keys * sizeof(ValueType) : 0);
+    }
+
    private:
-    // Base Node structure. All nodes (internal and leaf) derive from this.
+    // Base Node structure. All nodes (internal and leaf) start with this header.
+    // There is no vtable: is_leaf selects the concrete type (see FreeNode).
     struct Node {
-        bool is_leaf; // Indicates whether the node is a leaf
+        bool is_leaf;   // Indicates whether the node is a leaf
+        uint16_t count; // Number of keys in use (an internal node has count + 1 children)
+
+        explicit Node(bool leaf) : is_leaf(leaf), count(0) {}
+
         // Helper functions to cast a Node pointer to InternalNode or LeafNode pointers.
         LeafNode* as_leaf() { return static_cast<LeafNode*>(this); }
         const LeafNode* as_leaf() const { return static_cast<const LeafNode*>(this); }
 
         InternalNode* as_internal() { return static_cast<InternalNode*>(this); }
         const InternalNode* as_internal() const { return static_cast<const InternalNode*>(this); }
-
-        virtual ~Node() = default;
     };
 
     // Internal node structure for the B+ Tree.
     // Stores keys and child pointers.
-    struct InternalNode : public Node {
-        std::vector<Key> keys;         // Keys used to direct search to the correct child
-        std::vector<Node*> children;   // Pointers to child nodes
-        InternalNode() { this->is_leaf = false; }
+    struct alignas(kCacheLineSize) InternalNode : public Node {
+        Key keys[kInternalKeys];            // Keys used to direct search to the correct child
+        Node* children[kInternalKeys + 1];  // Pointers to child nodes
+        InternalNode() : Node(false) {}
     };
 
     // Leaf node structure for the B+ Tree.
-    // Stores actual keys and a pointer to the next leaf for efficient range queries.
-    struct LeafNode : public Node {
-        std::vector<Key> keys; // Keys stored in the leaf node
-        LeafNode* next;        // Pointer to the next leaf node for range scanning
-        LeafNode() : next(nullptr) { this->is_leaf = true; }
+    // Stores actual keys and pointers to the neighbouring leaves for efficient range queries.
+    struct alignas(kCacheLineSize) LeafNode : public Node {
+        LeafNode* next;                       // Pointer to the next leaf node for range scanning
+        LeafNode* prev;                       // Pointer to the previous leaf node for reverse scanning
+        Key keys[kLeafKeys];                  // Keys stored in the leaf node
+        LeafSlots<Value, kLeafKeys> values;   // Values, parallel to keys (empty for set-only trees)
+        LeafNode() : Node(true), next(nullptr), prev(nullptr) {}
     };
 
+    static_assert(sizeof(InternalNode) <= (NodeBytes + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize,
+                  "internal node exceeds NodeBytes");
+    static_assert(sizeof(LeafNode) <= (NodeBytes + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize,
+                  "leaf node exceeds NodeBytes");
+
     // Helper function to insert a key into an internal node.
     // 'new_child' and 'new_key' are output parameters if the node splits.
     // TODO: Implement insertion into an internal node and handle splitting of nodes.
     void InsertInternal(Node* current, const Key& key, Node*& new_child, Key& new_key);
 
-    // Helper function to delete a key from the tree recursively.
-    // TODO: Implement deletion from internal nodes with proper merging or rebalancing.
-    bool DeleteInternal(Node* current, const Key& key);
+    // Helper functions for Delete and Compact.
+    // DeleteInternal removes 'key' from the subtree of 'current' and tells the caller (the
+    // parent) whether 'current' is now underfull. FixChild repairs an underfull children[i]
+    // with its left sibling (the right one for the first child); CompactRecursive repairs
+    // the underfull nodes below 'node', children first. It returns true if it had to leave one
+    // in place because its parent had no other child (a later pass fixes it once the parent
+    // has been merged with a sibling).
+    enum class DeleteStatus { kNotFound, kDeleted, kUnderflow };
+    DeleteStatus DeleteInternal(Node* current, const Key& key);
+    void FixChild(InternalNode* parent, size_t i);
+    bool CompactRecursive(Node* node);
+    // Replaces an internal root with a single child by that child (repeatedly)
+    void ShrinkRoot();
+
+    // Minimum fill of a node: half of the leaf capacity (degree - 1 keys) and half of the
+    // internal capacity (degree children), rounded up. In lazy merge mode Delete only asks
+    // for one key per leaf and two children per internal node.
+    bool Underfull(const Node* node, bool lazy) const {
+        if (node->is_leaf) return node->count < (lazy ? 1 : degree / 2);
+        return node->count + 1 < (lazy ? 2 : (degree + 1) / 2);
+    }
+
+    // Helper function to insert a key, or overwrite its value if 'overwrite' is set and the key exists.
+    void Upsert(const Key& key, const ValueType& value, bool overwrite);
+
+    // A node created by a split during InsertBatch, with the separator key in front of it.
+    struct Split {
+        Key key;
+        Node* node;
+    };
+
+    // One node visited by InsertBatch, with the part of the batch that belongs under it.
+    template<typename Entry>
+    struct BatchRun {
+        Node* node;
+        size_t parent;        // Index of the parent's run on the level above
+        size_t child;         // Index of 'node' among the parent's children
+        const Entry* first;
+        const Entry* last;
+        size_t split_begin;   // Splits of 'node' in the level's split list: [split_begin, split_end)
+        size_t split_end;
+    };
+
+    // Helper functions for InsertBatch.
+    // InsertBatchLeaf merges a run of sorted, duplicate-free entries into one leaf and appends
+    // the new leaves (if it had to split) to 'splits'.
+    // Redistribute spreads the merged contents of an internal node over as few nodes as
+    // possible, reusing 'internal' for the first one.
+    template<typename Entry>
+    void InsertBatchLeaf(LeafNode* leaf, const Entry* first, const Entry* last, std::vector<Split>& splits);
+    void Redistribute(InternalNode* internal, const std::vector<Key>& keys, const std::vector<Node*>& children,
+                      std::vector<Split>& splits);
+
+    // Helper function to free a subtree (and the out-of-line values in its leaves).
+    void DestroyRecursive(Node* node);
+
+    // Helper functions to allocate nodes and to free a single node as its concrete type.
+    LeafNode* NewLeaf() {
+        num_leaves++;
+        return new LeafNode();
+    }
+    InternalNode* NewInternal() {
+        num_internals++;
+        return new InternalNode();
+    }
+    void FreeNode(Node* node) {
+        if (node->is_leaf) {
+            num_leaves--;
+            delete node->as_leaf();
+        } else {
+            num_internals--;
+            delete node->as_internal();
+        }
+    }
+
+    // Helper functions to shift the first 'count' entries of a node array.
+    // ArrayInsert opens a gap at 'pos' for 'value'; ArrayErase closes the gap at 'pos'.
+    template<typename T>
+    static void ArrayInsert(T* array, size_t count, size_t pos, const T& value) {
+        std::copy_backward(array + pos, array + count, array + count + 1);
+        array[pos] = value;
+    }
+    template<typename T>
+    static void ArrayErase(T* array, size_t count, size_t pos) {
+        std::copy(array + pos + 1, array + count, array + pos);
+    }
+
+    // Helper functions to read a bulk-load entry: a bare key, or a (key, value) pair.
+    static const Key& EntryKey(const Key& key) { return key; }
+    template<typename K, typename V>
+    static const Key& EntryKey(const std::pair<K, V>& entry) { return entry.first; }
+    static ValueType EntryValue(const Key&) { return ValueType(); }
+    template<typename K, typename V>
+    static const V& EntryValue(const std::pair<K, V>& entry) { return entry.second; }
+
+    // Helper functions for in-node search (SIMD accelerated for uint64_t keys, see simd_search.h).
+    // ChildIndex: index of the child of 'internal' that covers 'key' (number of separators <= key).
+    // LeafPosition: index of the first key in 'leaf' that is >= 'key'.
+    static size_t ChildIndex(const InternalNode* internal, const Key& key) {
+        return simd_search::UpperBound(internal->keys, internal->count, key);
+    }
+    static size_t LeafPosition(const LeafNode* leaf, const Key& key) {
+        return simd_search::LowerBound(leaf->keys, leaf->count, key);
+    }
 
     // Helper function to find the leaf node where the key should reside.
     // TODO: Implement traversal from the root to the appropriate leaf node.
     LeafNode* FindLeaf(const Key& key) const;
 
+    // Batched lookups descend this many keys side by side (enough misses in flight to cover
+    // the memory latency without thrashing the line fill buffers).
+    static constexpr size_t kLookupGroup = 16;
+    // Only the head of a node is prefetched: the header and the first keys, which is where
+    // the in-node search starts (the whole node for the default 256-byte nodes).
+    static constexpr size_t kPrefetchBytes = std::min<size_t>(NodeBytes, 4 * kCacheLineSize);
+    static void Prefetch(const Node* node) {
+        const char* p = reinterpret_cast<const char*>(node);
+        for (size_t offset = 0; offset < kPrefetchBytes; offset += kCacheLineSize) {
+            _mm_prefetch(p + offset, _MM_HINT_T0);
+        }
+    }
+
+    // Helper function for the scans: walks the leaves from the first key >= start and calls
+    // emit(first, last) for each run of consecutive keys, stopping before 'end' (if not null)
+    // or after 'limit' keys. Returns the number of keys emitted.
+    template<typename Emit>
+    size_t ScanRuns(const Key& start, const Key* end, size_t limit, Emit&& emit) const;
+
+    // Helper function for MultiContains/MultiGet: finds the leaf of every key in the batch and
+    // calls visit(i, leaf, pos) with the input index i and LeafPosition(leaf, keys[i]).
+    template<typename Visit>
+    void MultiFindLeaf(const Key* keys, size_t n, Visit&& visit) const;
+
     // Helper function to recursively print the tree structure.
     void PrintRecursive(const Node* node, int level) const;
 
+    // Helper function for Verify: checks the subtree of 'node', whose keys must lie in
+    // [low, high) (null = unbounded), and appends its leaves in order. Returns the first
+    // problem found (empty if none).
+    std::string VerifyRecursive(const Node* node, int depth, const Key* low, const Key* high, int& leaf_depth,
+                                std::vector<const LeafNode*>& leaves, size_t& keys) const;
+
     Node* root;   // Root node of the B+ Tree
     int degree;   // Maximum number of children per internal node
+    size_t num_keys = 0;      // Keys currently stored
+    size_t num_leaves = 0;    // Allocated leaf nodes
+    size_t num_internals = 0; // Allocated internal nodes
+    bool lazy_merge = false;  // See SetLazyMerge
+    size_t deletes_since_compact = 0;
 };
 
 // Constructor implementation
 // Initializes the tree by creating an empty leaf node as the root.
-template<typename Key>
-Bplustree<Key>::Bplustree(int degree) : degree(degree) {
-    root = new LeafNode();
+template<typename Key, typename Value, size_t NodeBytes>
+Bplustree<Key, Value, NodeBytes>::Bplustree(int degree)
+    : degree(std::max(3, std::min(degree, kMaxDegree))) {
+    root = NewLeaf();
     // To be implemented by students
 }
 
+// Bulk-load constructor implementation
+template<typename Key, typename Value, size_t NodeBytes>
+template<typename Iter>
+Bplustree<Key, Value, NodeBytes>::Bplustree(Iter begin, Iter end, double fill_factor, int degree)
+    : Bplustree(degree) {
+    BulkLoad(begin, end, fill_factor);
+}
+
+// Destructor: frees every node
+template<typename Key, typename Value, size_t NodeBytes>
+Bplustree<Key, Value, NodeBytes>::~Bplustree() {
+    DestroyRecursive(root);
+}
+
+template<typename Key, typename Value, size_t NodeBytes>
+void Bplustree<Key, Value, NodeBytes>::DestroyRecursive(Node* node) {
+    if (node->is_leaf) {
+        LeafNode* leaf = node->as_leaf();
+        for (size_t i = 0; i < leaf->count; ++i) {
+            leaf->values[i].DestroyValue();
+        }
+    } else {
+        InternalNode* internal = node->as_internal();
+        for (size_t i = 0; i <= internal->count; ++i) {
+            DestroyRecursive(internal->children[i]);
+        }
+    }
+    FreeNode(node);
+}
+
+// BulkLoad function: Builds the tree bottom-up from sorted entries.
+template<typename Key, typename Value, size_t NodeBytes>
+template<typename Iter>
+void Bplustree<Key, Value, NodeBytes>::BulkLoad(Iter begin, Iter end, double fill_factor) {
+    DestroyRecursive(root);
+    fill_factor = std::min(1.0, std::max(0.0, fill_factor));
+
+    const size_t n = std::distance(begin, end);
+    num_keys = n;
+    deletes_since_compact = 0; // 새로 만든 트리에는 부족한 노드가 없다
+
+    // 리프 층: 리프 수를 먼저 정하고 키를 고르게 나눠 왼쪽부터 채운다
+    size_t leaf_fill = std::max<long>(1, std::lround(fill_factor * (degree - 1)));
+    size_t leaves = std::max<size_t>(1, (n + leaf_fill - 1) / leaf_fill);
+
+    std::vector<Node*> level;   // 현재 층의 노드들 (왼쪽부터)
+    std::vector<Key> low_keys;  // 각 노드 서브트리의 최소 키 (부모의 구분 키가 된다)
+    level.reserve(leaves);
+    low_keys.reserve(leaves);
+
+    LeafNode* prev = nullptr;
+    for (size_t l = 0; l < leaves; ++l) {
+        size_t count = n / leaves + (l < n % leaves ? 1 : 0);
+        LeafNode* leaf = NewLeaf();
+        for (size_t j = 0; j < count; ++j, ++begin) {
+            leaf->keys[j] = EntryKey(*begin);
+            leaf->values[j].InitValue(EntryValue(*begin));
+        }
+        leaf->count = count;
+        if (prev != nullptr) prev->next = leaf;
+        leaf->prev = prev;
+        prev = leaf;
+        level.push_back(leaf);
+        low_keys.push_back(count > 0 ? leaf->keys[0] : Key());
+    }
+
+    // 내부 층: 아래 층을 같은 방식으로 묶어 루트 하나가 남을 때까지 쌓는다
+    // (자식이 최소 3개씩은 묶여야 분배 후에도 자식이 1개인 노드가 생기지 않는다)
+    size_t child_fill = std::min<long>(degree, std::max<long>(3, std::lround(fill_factor * degree)));
+    while (level.size() > 1) {
+        size_t m = level.size();
+        size_t parents = (m + child_fill - 1) / child_fill;
+        size_t in = 0;
+        for (size_t p = 0; p < parents; ++p) {
+            size_t children = m / parents + (p < m % parents ? 1 : 0);
+            InternalNode* internal = NewInternal();
+            Key low = low_keys[in];
+            for (size_t j = 0; j < children; ++j, ++in) {
+                internal->children[j] = level[in];
+                if (j > 0) internal->keys[j - 1] = low_keys[in];
+            }
+            internal->count = children - 1;
+            level[p] = internal; // p < in 이므로 아직 읽지 않은 항목을 덮어쓰지 않는다
+            low_keys[p] = low;
+        }
+        level.resize(parents);
+        low_keys.resize(parents);
+    }
+    root = level[0];
+}
+
+// SaveSnapshot function: Streams the leaves into a snapshot file.
+template<typename Key, typename Value, size_t NodeBytes>
+bool Bplustree<Key, Value, NodeBytes>::SaveSnapshot(const std::string& path, std::string* error) const {
+    SnapshotWriter<Key, ValueType> writer(path, num_keys, degree);
+    Iterator it(this);
+    for (it.SeekToFirst(); it.Valid(); it.Next()) {
+        writer.Add(it.key(), it.value());
+    }
+    if (writer.Finish()) return true;
+    if (error != nullptr) *error = writer.Error();
+    return false;
+}
+
+// LoadSnapshot function: Bulk-loads the tree from a mapped snapshot file.
+template<typename Key, typename Value, size_t NodeBytes>
+bool Bplustree<Key, Value, NodeBytes>::LoadSnapshot(const std::string& path, double fill_factor, std::string* error) {
+    SnapshotReader<Key, ValueType> reader;
+    if (!reader.Open(path)) {
+        if (error != nullptr) *error = reader.Error();
+        return false;
+    }
+    BulkLoad(reader.Begin(), reader.End(), fill_factor);
+    return true;
+}
+
+// InsertBatch function: Sorts the batch and inserts it in one pass over the tree.
+template<typename Key, typename Value, size_t NodeBytes>
+template<typename Iter>
+void Bplustree<Key, Value, NodeBytes>::InsertBatch(Iter begin, Iter end) {
+    typedef typename std::iterator_traits<Iter>::value_type Entry;
+    std::vector<Entry> batch(begin, end);
+    auto key_less = [](const Entry& a, const Entry& b) { return EntryKey(a) < EntryKey(b); };
+    std::stable_sort(batch.begin(), batch.end(), key_less);
+    // 배치 안의 중복 키는 처음 것만 남긴다 (Insert를 차례로 부른 것과 같은 결과)
+    batch.erase(std::unique(batch.begin(), batch.end(),
+                            [](const Entry& a, const Entry& b) { return EntryKey(a) == EntryKey(b); }),
+                batch.end());
+    if (batch.empty()) return;
+
+    // 1) 한 층씩 내려가며 배치를 자식별 구간으로 나눈다. 한 층의 자식 노드를 모두 미리
+    //    요청해 두므로 서로 다른 서브트리로 가는 키들의 cache miss가 겹친다.
+    //    공통 경로의 노드는 한 번만 탐색된다.
+    typedef BatchRun<Entry> Run;
+    std::vector<std::vector<Run>> levels(1);
+    levels[0].push_back(Run{root, 0, 0, batch.data(), batch.data() + batch.size(), 0, 0});
+    while (!levels.back()[0].node->is_leaf) {
+        std::vector<Run> below;
+        const std::vector<Run>& above = levels.back();
+        for (size_t p = 0; p < above.size(); ++p) {
+            const InternalNode* internal = above[p].node->as_internal();
+            for (const Entry* first = above[p].first; first != above[p].last;) {
+                size_t i = ChildIndex(internal, EntryKey(*first));
+                const Entry* end = above[p].last;
+                if (i < internal->count) {
+                    end = std::lower_bound(first, end, internal->keys[i],
+                                           [](const Entry& e, const Key& key) { return EntryKey(e) < key; });
+                }
+                below.push_back(Run{internal->children[i], p, i, first, end, 0, 0});
+                Prefetch(internal->children[i]);
+                first = end;
+            }
+        }
+        levels.push_back(std::move(below));
+    }
+
+    // 2) 리프에 병합하고, 분할 결과를 아래 층부터 부모에 반영한다 (노드마다 한 번씩만 고친다)
+    std::vector<Split> splits;
+    for (Run& run : levels.back()) {
+        run.split_begin = splits.size();
+        InsertBatchLeaf(run.node->as_leaf(), run.first, run.last, splits);
+        run.split_end = splits.size();
+    }
+    std::vector<Key> keys;
+    std::vector<Node*> children;
+    for (size_t level = levels.size() - 1; level-- > 0;) {
+        std::vector<Split> parent_splits;
+        const std::vector<Run>& below = levels[level + 1];
+        size_t c = 0;
+        for (size_t p = 0; p < levels[level].size(); ++p) {
+            Run& run = levels[level][p];
+            run.split_begin = parent_splits.size();
+            size_t c_end = c;
+            bool split = false;
+            for (; c_end < below.size() && below[c_end].parent == p; ++c_end) {
+                split |= below[c_end].split_end > below[c_end].split_begin;
+            }
+            if (split) {
+                // 자식들의 분할 결과를 끼워 넣은 배열을 만든다
+                InternalNode* internal = run.node->as_internal();
+                keys.clear();
+                children.clear();
+                for (size_t i = 0; i <= internal->count; ++i) {
+                    children.push_back(internal->children[i]);
+                    for (; c < c_end && below[c].child == i; ++c) {
+                        for (size_t k = below[c].split_begin; k < below[c].split_end; ++k) {
+                            keys.push_back(splits[k].key);
+                            children.push_back(splits[k].node);
+                        }
+                    }
+                    if (i < internal->count) keys.push_back(internal->keys[i]);
+                }
+                Redistribute(internal, keys, children, parent_splits);
+            }
+            run.split_end = parent_splits.size();
+            c = c_end;
+        }
+        splits.swap(parent_splits);
+    }
+
+    // 3) 루트가 쪼개졌으면 그 위에 새 루트를 올린다 (조각이 degree개를 넘으면 여러 층)
+    while (!splits.empty()) {
+        keys.clear();
+        children.assign(1, root);
+        for (const Split& split : splits) {
+            keys.push_back(split.key);
+            children.push_back(split.node);
+        }
+        splits.clear();
+        InternalNode* new_root = NewInternal();
+        root = new_root;
+        Redistribute(new_root, keys, children, splits);
+    }
+}
+
+template<typename Key, typename Value, size_t NodeBytes>
+void Bplustree<Key, Value, NodeBytes>::Redistribute(InternalNode* internal, const std::vector<Key>& keys,
+                                                    const std::vector<Node*>& children, std::vector<Split>& splits) {
+    // 노드당 자식 degree개 이하로, 조각 수를 최소로 해서 고르게 나눈다
+    const size_t n = children.size();
+    const size_t pieces = (n + degree - 1) / degree;
+    size_t c = 0;
+    for (size_t p = 0; p < pieces; ++p) {
+        size_t take = n / pieces + (p < n % pieces ? 1 : 0);
+        InternalNode* target = internal;
+        if (p > 0) {
+            target = NewInternal();
+            splits.push_back({keys[c - 1], target}); // 조각 사이의 키는 부모로 올라간다
+        }
+        std::copy(children.begin() + c, children.begin() + c + take, target->children);
+        std::copy(keys.begin() + c, keys.begin() + c + take - 1, target->keys);
+        target->count = take - 1;
+        c += take;
+    }
+}
+
+template<typename Key, typename Value, size_t NodeBytes>
+template<typename Entry>
+void Bplustree<Key, Value, NodeBytes>::InsertBatchLeaf(LeafNode* leaf, const Entry* first, const Entry* last,
+                                                       std::vector<Split>& splits) {
+    // 리프에 아직 없는 키의 수
+    size_t added = 0;
+    size_t i = 0;
+    for (const Entry* e = first; e != last; ++e) {
+        while (i < leaf->count && leaf->keys[i] < EntryKey(*e)) ++i;
+        if (i == leaf->count || leaf->keys[i] != EntryKey(*e)) ++added;
+    }
+    if (added == 0) return;
+    num_keys += added;
+    const size_t total = leaf->count + added;
+
+    if (total < static_cast<size_t>(degree)) {
+        // 분할이 필요 없으면 뒤에서부터 제자리 병합
+        size_t k = total;
+        size_t j = leaf->count;
+        for (const Entry* e = last; e != first;) {
+            const Entry& entry = *(e - 1);
+            if (j > 0 && EntryKey(entry) < leaf->keys[j - 1]) {
+                --j;
+                --k;
+                leaf->keys[k] = leaf->keys[j];
+                leaf->values[k] = leaf->values[j];
+            } else {
+                --e;
+                if (j > 0 && leaf->keys[j - 1] == EntryKey(entry)) continue; // 이미 있는 키
+                --k;
+                leaf->keys[k] = EntryKey(entry);
+                leaf->values[k].InitValue(EntryValue(entry));
+            }
+        }
+        leaf->count = total;
+        return;
+    }
+
+    // 넘치면 병합 결과를 따로 만든 뒤 리프 여러 개에 고르게 나눈다 (분할은 이 리프당 한 번)
+    std::vector<Key> keys;
+    std::vector<Slot> slots;
+    keys.reserve(total);
+    slots.reserve(total);
+    size_t j = 0;
+    for (const Entry* e = first; e != last; ++e) {
+        for (; j < leaf->count && leaf->keys[j] < EntryKey(*e); ++j) {
+            keys.push_back(leaf->keys[j]);
+            slots.push_back(leaf->values[j]);
+        }
+        if (j < leaf->count && leaf->keys[j] == EntryKey(*e)) continue;
+        Slot slot;
+        slot.InitValue(EntryValue(*e));
+        keys.push_back(EntryKey(*e));
+        slots.push_back(slot);
+    }
+    for (; j < leaf->count; ++j) {
+        keys.push_back(leaf->keys[j]);
+        slots.push_back(leaf->values[j]);
+    }
+
+    const size_t per_leaf = degree - 1;
+    const size_t pieces = (total + per_leaf - 1) / per_leaf;
+    LeafNode* next = leaf->next;
+    LeafNode* target = leaf;
+    size_t c = 0;
+    for (size_t p = 0; p < pieces; ++p) {
+        size_t take = total / pieces + (p < total % pieces ? 1 : 0);
+        if (p > 0) {
+            LeafNode* new_leaf = NewLeaf();
+            new_leaf->prev = target;
+            target->next = new_leaf;
+            target = new_leaf;
+            splits.push_back({keys[c], new_leaf});
+        }
+        std::copy(keys.begin() + c, keys.begin() + c + take, target->keys);
+        for (size_t t = 0; t < take; ++t) {
+            target->values[t] = slots[c + t];
+        }
+        target->count = take;
+        c += take;
+    }
+    target->next = next;
+    if (next != nullptr) next->prev = target;
+}
+
 // Insert function: Inserts a key into the B+ Tree.
-template<typename Key>
-void Bplustree<Key>::Insert(const Key& key) {
+template<typename Key, typename Value, size_t NodeBytes>
+void Bplustree<Key, Value, NodeBytes>::Insert(const Key& key) {
     // TODO: Implement insertion logic here.
-    LeafNode* leaf = FindLeaf(key); // 키가 들어갈 리프 찾기
-    auto it = std::lower_bound(leaf->keys.begin(), leaf->keys.end(), key); // 정렬 유지하며 위치 찾기
-    if (it != leaf->keys.end() && *it == key) return; // 중복이면 삽입하지 않음
+    Upsert(key, ValueType(), false);
+}
 
-    leaf->keys.insert(it, key); // 키 삽입
+template<typename Key, typename Value, size_t NodeBytes>
+void Bplustree<Key, Value, NodeBytes>::Put(const Key& key, const ValueType& value) {
+    Upsert(key, value, true);
+}
 
-    if (leaf->keys.size() < degree) return; // 분할 필요 없음
+template<typename Key, typename Value, size_t NodeBytes>
+void Bplustree<Key, Value, NodeBytes>::Upsert(const Key& key, const ValueType& value, bool overwrite) {
+    LeafNode* leaf = FindLeaf(key); // 키가 들어갈 리프 찾기
+    size_t pos = LeafPosition(leaf, key); // 정렬 유지하며 위치 찾기
+    if (pos < leaf->count && leaf->keys[pos] == key) { // 중복이면 삽입하지 않음 (Put이면 값만 덮어쓴다)
+        if (overwrite) leaf->values[pos].SetValue(value);
+        return;
+    }
 
-    // 노드 분할
-    LeafNode* new_leaf = new LeafNode();
-    int mid = leaf->keys.size() / 2;
+    ArrayInsert(leaf->keys, leaf->count, pos, key); // 키 삽입
+    Slot slot;
+    slot.InitValue(value);
+    leaf->values.Insert(pos, leaf->count, slot);
+    leaf->count++;
+    num_keys++;
 
-    new_leaf->keys.assign(leaf->keys.begin() + mid, leaf->keys.end()); // 오른쪽 절반 복사
-    leaf->keys.resize(mid); // 왼쪽 절반 유지
+    if (leaf->count < degree) return; // 분할 필요 없음
 
-    new_leaf->next = leaf->next; // next 포인터 조정
+    // 노드 분할
+    LeafNode* new_leaf = NewLeaf();
+    int mid = leaf->count / 2;
+
+    // 오른쪽 절반을 새 리프로 복사하고 왼쪽 절반 유지
+    std::copy(leaf->keys + mid, leaf->keys + leaf->count, new_leaf->keys);
+    leaf->values.MoveTo(mid, leaf->count - mid, new_leaf->values, 0);
+    new_leaf->count = leaf->count - mid;
+    leaf->count = mid;
+
+    new_leaf->next = leaf->next; // next/prev 포인터 조정
+    new_leaf->prev = leaf;
+    if (leaf->next != nullptr) leaf->next->prev = new_leaf;
     leaf->next = new_leaf;
 
-    Key new_key = new_leaf->keys.front(); // 부모에 올릴 키
+    Key new_key = new_leaf->keys[0]; // 부모에 올릴 키
 
     if (leaf == root) {
         // 루트였으면 새로운 루트 생성
-        InternalNode* new_root = new InternalNode();
-        new_root->keys.push_back(new_key);
-        new_root->children.push_back(leaf);
-        new_root->children.push_back(new_leaf);
+        InternalNode* new_root = NewInternal();
+        new_root->keys[0] = new_key;
+        new_root->children[0] = leaf;
+        new_root->children[1] = new_leaf;
+        new_root->count = 1;
         root = new_root;
     } else {
         // 루트가 아니면 내부 노드에 삽입 요청
@@ -165,101 +922,255 @@ void Bplustree<Key>::Insert(const Key& key) {
 
 
 // Contains function: Checks if a key exists in the B+ Tree.
-template<typename Key>
-bool Bplustree<Key>::Contains(const Key& key) const {
+template<typename Key, typename Value, size_t NodeBytes>
+bool Bplustree<Key, Value, NodeBytes>::Contains(const Key& key) const {
     // TODO: Implement lookup logic here.
     LeafNode* leaf = FindLeaf(key);
-    return std::binary_search(leaf->keys.begin(), leaf->keys.end(), key);
+    size_t pos = LeafPosition(leaf, key);
+    return pos < leaf->count && leaf->keys[pos] == key;
+}
+
+// MultiContains function: Batched Contains (see MultiFindLeaf).
+template<typename Key, typename Value, size_t NodeBytes>
+void Bplustree<Key, Value, NodeBytes>::MultiContains(const Key* keys, size_t n, bool* found) const {
+    MultiFindLeaf(keys, n, [&](size_t i, const LeafNode* leaf, size_t pos) {
+        found[i] = pos < leaf->count && leaf->keys[pos] == keys[i];
+    });
+}
+
+// MultiGet function: Batched Get (see MultiFindLeaf).
+template<typename Key, typename Value, size_t NodeBytes>
+void Bplustree<Key, Value, NodeBytes>::MultiGet(const Key* keys, size_t n, ValueType* values, bool* found) const {
+    MultiFindLeaf(keys, n, [&](size_t i, const LeafNode* leaf, size_t pos) {
+        found[i] = pos < leaf->count && leaf->keys[pos] == keys[i];
+        if (found[i]) values[i] = *leaf->values[pos].GetValue();
+    });
+}
+
+template<typename Key, typename Value, size_t NodeBytes>
+template<typename Visit>
+void Bplustree<Key, Value, NodeBytes>::MultiFindLeaf(const Key* keys, size_t n, Visit&& visit) const {
+    // 키 순서로 정렬하면 한 그룹 안의 키들이 경로를 공유해 같은 노드를 다시 읽게 된다
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+    const Node* nodes[kLookupGroup];
+    for (size_t base = 0; base < n; base += kLookupGroup) {
+        const uint32_t* group = order.data() + base;
+        const size_t group_size = std::min(kLookupGroup, n - base);
+        for (size_t g = 0; g < group_size; ++g) {
+            nodes[g] = root;
+        }
+        // 모든 리프의 깊이가 같으므로 그룹 전체가 한 층씩 함께 내려간다
+        while (!nodes[0]->is_leaf) {
+            for (size_t g = 0; g < group_size; ++g) {
+                const InternalNode* internal = nodes[g]->as_internal();
+                nodes[g] = internal->children[ChildIndex(internal, keys[group[g]])];
+                Prefetch(nodes[g]); // 다음 층 탐색 전에 미리 요청
+            }
+        }
+        for (size_t g = 0; g < group_size; ++g) {
+            const LeafNode* leaf = nodes[g]->as_leaf();
+            visit(group[g], leaf, LeafPosition(leaf, keys[group[g]]));
+        }
+    }
+}
+
+// Get function: Copies the value of a key into *value.
+template<typename Key, typename Value, size_t NodeBytes>
+bool Bplustree<Key, Value, NodeBytes>::Get(const Key& key, ValueType* value) const {
+    LeafNode* leaf = FindLeaf(key);
+    size_t pos = LeafPosition(leaf, key);
+    if (pos == leaf->count || leaf->keys[pos] != key) return false;
+    *value = *leaf->values[pos].GetValue();
+    return true;
+}
+
+// Update function: Overwrites the value of an existing key.
+template<typename Key, typename Value, size_t NodeBytes>
+bool Bplustree<Key, Value, NodeBytes>::Update(const Key& key, const ValueType& value) {
+    LeafNode* leaf = FindLeaf(key);
+    size_t pos = LeafPosition(leaf, key);
+    if (pos == leaf->count || leaf->keys[pos] != key) return false;
+    leaf->values[pos].SetValue(value);
+    return true;
 }
 
 
 // Scan function: Performs a range query starting from a given key.
-template<typename Key>
-std::vector<Key> Bplustree<Key>::Scan(const Key& key, const int scan_num) {
+template<typename Key, typename Value, size_t NodeBytes>
+std::vector<Key> Bplustree<Key, Value, NodeBytes>::Scan(const Key& key, const int scan_num) const {
     // TODO: Implement range query logic here.
     std::vector<Key> result;
-    LeafNode* leaf = FindLeaf(key);
-    while (leaf && result.size() < scan_num) {
-        for (const Key& k : leaf->keys) {
-            if (k >= key) result.push_back(k);
-            if (result.size() == scan_num) break;
-        }
-        leaf = leaf->next;
-    }
+    if (scan_num <= 0) return result;
+    result.reserve(std::min<size_t>(scan_num, num_keys));
+    ScanRuns(key, nullptr, scan_num, [&](const Key* first, const Key* last) {
+        result.insert(result.end(), first, last);
+    });
     return result;
 }
 
+template<typename Key, typename Value, size_t NodeBytes>
+size_t Bplustree<Key, Value, NodeBytes>::Scan(const Key& key, size_t scan_num, Key* out) const {
+    return ScanRuns(key, nullptr, scan_num, [&](const Key* first, const Key* last) {
+        out = std::copy(first, last, out);
+    });
+}
 
-// Delete function: Removes a key from the B+ Tree.
-template<typename Key>
-bool Bplustree<Key>::Delete(const Key& key) {
-    // TODO: Implement deletion logic here.
-    if (!Contains(key)) return false; // 없으면 삭제 실패
+// ScanRange function: Keys in [start, end).
+template<typename Key, typename Value, size_t NodeBytes>
+std::vector<Key> Bplustree<Key, Value, NodeBytes>::ScanRange(const Key& start, const Key& end) const {
+    std::vector<Key> result;
+    ScanRuns(start, &end, SIZE_MAX, [&](const Key* first, const Key* last) {
+        result.insert(result.end(), first, last);
+    });
+    return result;
+}
 
-    LeafNode* leaf = FindLeaf(key);
-    auto it = std::find(leaf->keys.begin(), leaf->keys.end(), key);
-    if (it != leaf->keys.end()) leaf->keys.erase(it); // 삭제
+template<typename Key, typename Value, size_t NodeBytes>
+size_t Bplustree<Key, Value, NodeBytes>::ScanRange(const Key& start, const Key& end, size_t scan_num, Key* out) const {
+    return ScanRuns(start, &end, scan_num, [&](const Key* first, const Key* last) {
+        out = std::copy(first, last, out);
+    });
+}
 
-    if (leaf == root) {
-        if (leaf->keys.empty()) {
-            delete root;
-            root = new LeafNode();
+template<typename Key, typename Value, size_t NodeBytes>
+template<typename Emit>
+size_t Bplustree<Key, Value, NodeBytes>::ScanRuns(const Key& start, const Key* end, size_t limit, Emit&& emit) const {
+    const LeafNode* leaf = FindLeaf(start);
+    size_t pos = LeafPosition(leaf, start); // 첫 리프에서만 위치 탐색
+    size_t emitted = 0;
+    while (leaf != nullptr && emitted < limit) {
+        // 현재 리프를 복사하는 동안 다음 리프를 미리 가져온다
+        const LeafNode* next = leaf->next;
+        if (next != nullptr) Prefetch(next);
+
+        size_t n = std::min<size_t>(leaf->count - pos, limit - emitted);
+        const Key* first = leaf->keys + pos;
+        if (end != nullptr && n > 0 && !(first[n - 1] < *end)) {
+            // 끝 키가 이 리프 안에 있으면 그 앞까지만 복사하고 종료
+            n = simd_search::LowerBound(first, n, *end);
+            emit(first, first + n);
+            return emitted + n;
         }
-        return true;
+        emit(first, first + n);
+        emitted += n;
+        leaf = next;
+        pos = 0;
+    }
+    return emitted;
+}
+
+// ReverseScan function: Walks the leaf chain backwards from the last key <= key.
+template<typename Key, typename Value, size_t NodeBytes>
+std::vector<Key> Bplustree<Key, Value, NodeBytes>::ReverseScan(const Key& key, const int scan_num) const {
+    std::vector<Key> result;
+    if (scan_num <= 0) return result;
+    Iterator it(this);
+    for (it.SeekForPrev(key); it.Valid() && result.size() < static_cast<size_t>(scan_num); it.Prev()) {
+        result.push_back(it.key());
     }
+    return result;
+}
 
-    int min_keys = std::ceil(degree / 2.0);
-    if (leaf->keys.size() < min_keys) {
-        DeleteInternal(root, key); // 부모에게 구조 조정 요청
+// ScanKV function: Range query returning keys with pointers to their values.
+template<typename Key, typename Value, size_t NodeBytes>
+std::vector<std::pair<Key, const typename Bplustree<Key, Value, NodeBytes>::ValueType*>>
+Bplustree<Key, Value, NodeBytes>::ScanKV(const Key& key, const int scan_num) const {
+    std::vector<std::pair<Key, const ValueType*>> result;
+    if (scan_num <= 0) return result;
+    result.reserve(std::min<size_t>(scan_num, num_keys));
+    Iterator it(this);
+    for (it.Seek(key); it.Valid() && result.size() < static_cast<size_t>(scan_num); it.Next()) {
+        result.emplace_back(it.key(), it.value());
     }
+    return result;
+}
+
 
+// Delete function: Removes a key from the B+ Tree.
+template<typename Key, typename Value, size_t NodeBytes>
+bool Bplustree<Key, Value, NodeBytes>::Delete(const Key& key) {
+    // 루트에서 리프까지 한 번만 내려가고, 돌아오면서 부족해진 노드를 부모가 고친다
+    // (루트 리프는 비어 있어도 그대로 재사용)
+    if (DeleteInternal(root, key) == DeleteStatus::kNotFound) return false; // 없으면 삭제 실패
+    ShrinkRoot();
+
+    // lazy 모드: 남은 키보다 삭제가 많아지면 한 번에 정리
+    if (lazy_merge && ++deletes_since_compact > num_keys) {
+        Compact();
+    }
     return true;
 }
 
+// Compact function: Repairs every underfull node (used by the lazy merge mode).
+template<typename Key, typename Value, size_t NodeBytes>
+void Bplustree<Key, Value, NodeBytes>::Compact() {
+    // 자식이 하나뿐인 노드 아래의 부족한 노드는 그 노드가 병합된 뒤에야 고칠 수 있으므로 한 번 더
+    while (CompactRecursive(root)) {
+        ShrinkRoot();
+    }
+    ShrinkRoot();
+    deletes_since_compact = 0;
+}
+
+template<typename Key, typename Value, size_t NodeBytes>
+void Bplustree<Key, Value, NodeBytes>::ShrinkRoot() {
+    while (!root->is_leaf && root->count == 0) {
+        Node* child = root->as_internal()->children[0];
+        FreeNode(root);
+        root = child;
+    }
+}
+
 // InsertInternal function: Helper function to insert a key into an internal node.
-template<typename Key>
-void Bplustree<Key>::InsertInternal(Node* current, const Key& key, Node*& new_child, Key& new_key) {
+template<typename Key, typename Value, size_t NodeBytes>
+void Bplustree<Key, Value, NodeBytes>::InsertInternal(Node* current, const Key& key, Node*& new_child, Key& new_key) {
     // TODO: Implement internal node insertion logic here.
     if (current->is_leaf) return; // 잘못된 호출 방지
 
     InternalNode* internal = current->as_internal();
-    size_t i = 0;
-    while (i < internal->keys.size() && key >= internal->keys[i]) ++i;
+    size_t i = ChildIndex(internal, key);
 
     Node* child = internal->children[i];
 
     if (child->is_leaf) {
         // 이미 처리한 경우
-        internal->keys.insert(internal->keys.begin() + i, new_key);
-        internal->children.insert(internal->children.begin() + i + 1, new_child);
+        ArrayInsert(internal->keys, internal->count, i, new_key);
+        ArrayInsert(internal->children, internal->count + 1, i + 1, new_child);
+        internal->count++;
     } else {
-        Node* new_grandchild = nullptr;
-        Key promoted_key;
+        // 리프에서 올라온 분할 정보(new_child, new_key)를 아래 단계로 그대로 전달
+        Node* new_grandchild = new_child;
+        Key promoted_key = new_key;
         InsertInternal(child, key, new_grandchild, promoted_key);
         if (new_grandchild != nullptr) {
-            internal->keys.insert(internal->keys.begin() + i, promoted_key);
-            internal->children.insert(internal->children.begin() + i + 1, new_grandchild);
+            ArrayInsert(internal->keys, internal->count, i, promoted_key);
+            ArrayInsert(internal->children, internal->count + 1, i + 1, new_grandchild);
+            internal->count++;
         }
     }
 
-    if (internal->keys.size() >= degree) {
-        InternalNode* new_internal = new InternalNode();
-        int mid = internal->keys.size() / 2;
+    if (internal->count >= degree) {
+        InternalNode* new_internal = NewInternal();
+        int mid = internal->count / 2;
 
         new_key = internal->keys[mid];
-        new_internal->keys.assign(internal->keys.begin() + mid + 1, internal->keys.end());
-        new_internal->children.assign(internal->children.begin() + mid + 1, internal->children.end());
+        std::copy(internal->keys + mid + 1, internal->keys + internal->count, new_internal->keys);
+        std::copy(internal->children + mid + 1, internal->children + internal->count + 1, new_internal->children);
+        new_internal->count = internal->count - mid - 1;
 
-        internal->keys.resize(mid);
-        internal->children.resize(mid + 1);
+        internal->count = mid;
 
         new_child = new_internal;
 
         if (current == root) {
-            InternalNode* new_root = new InternalNode();
-            new_root->keys.push_back(new_key);
-            new_root->children.push_back(internal);
-            new_root->children.push_back(new_child);
+            InternalNode* new_root = NewInternal();
+            new_root->keys[0] = new_key;
+            new_root->children[0] = internal;
+            new_root->children[1] = new_child;
+            new_root->count = 1;
             root = new_root;
             new_child = nullptr;
         }
@@ -269,177 +1180,232 @@ void Bplustree<Key>::InsertInternal(Node* current, const Key& key, Node*& new_ch
 }
 
 
-// DeleteInternal function: Helper function to delete a key from an internal node.
-template<typename Key>
-bool Bplustree<Key>::DeleteInternal(Node* current, const Key& key) {
-    if (current->is_leaf) return false; // 이 함수는 Internal 노드에서만 호출됨
+// DeleteInternal function: Removes 'key' below 'current' and reports whether 'current' underflowed.
+template<typename Key, typename Value, size_t NodeBytes>
+typename Bplustree<Key, Value, NodeBytes>::DeleteStatus
+Bplustree<Key, Value, NodeBytes>::DeleteInternal(Node* current, const Key& key) {
+    if (current->is_leaf) {
+        LeafNode* leaf = current->as_leaf();
+        size_t pos = LeafPosition(leaf, key);
+        if (pos == leaf->count || leaf->keys[pos] != key) return DeleteStatus::kNotFound; // 키 없음
+
+        // 키 삭제 (값도 함께 해제)
+        leaf->values[pos].DestroyValue();
+        leaf->values.Erase(pos, leaf->count);
+        ArrayErase(leaf->keys, leaf->count, pos);
+        leaf->count--;
+        num_keys--;
+        return Underfull(leaf, lazy_merge) ? DeleteStatus::kUnderflow : DeleteStatus::kDeleted;
+    }
 
+    // 내려갈 자식을 찾아 재귀 호출 (호출 스택이 곧 부모 경로)
     InternalNode* internal = current->as_internal();
-    size_t i = 0;
+    size_t i = ChildIndex(internal, key);
+    DeleteStatus status = DeleteInternal(internal->children[i], key);
+    if (status != DeleteStatus::kUnderflow) return status;
 
-    // 적절한 자식 인덱스를 찾음
-    while (i < internal->keys.size() && key >= internal->keys[i]) ++i;
-    Node* child = internal->children[i];
+    // 자식이 부족해졌으면 형제와 병합 또는 재분배
+    FixChild(internal, i);
+    return Underfull(internal, lazy_merge) ? DeleteStatus::kUnderflow : DeleteStatus::kDeleted;
+}
 
-    // 리프 노드 처리
-    if (child->is_leaf) {
-        LeafNode* leaf = child->as_leaf();
-        auto it = std::find(leaf->keys.begin(), leaf->keys.end(), key);
-        if (it == leaf->keys.end()) return false; // 키 없음
-
-        // 키 삭제
-        leaf->keys.erase(it);
-
-        // 최소 키 수 이상이면 OK
-        int min_keys = std::ceil(degree / 2.0);
-        if (leaf->keys.size() >= min_keys) return true;
-
-        // 재분배 또는 병합
-        bool merged = false;
-
-        // 왼쪽 형제에서 빌리기
-        if (i > 0) {
-            LeafNode* left = internal->children[i - 1]->as_leaf();
-            if (left->keys.size() > min_keys) {
-                leaf->keys.insert(leaf->keys.begin(), left->keys.back());
-                left->keys.pop_back();
-                internal->keys[i - 1] = leaf->keys.front();
-                return true;
-            }
+// FixChild function: Merges children[i] with a sibling, or evens the two out if they do not fit in one node.
+template<typename Key, typename Value, size_t NodeBytes>
+void Bplustree<Key, Value, NodeBytes>::FixChild(InternalNode* parent, size_t i) {
+    if (parent->count == 0) return; // 형제가 없으면 부모 쪽에서 처리
+
+    // 왼쪽 형제와 짝을 짓고, 첫 번째 자식이면 오른쪽 형제와 짝을 짓는다
+    size_t j = i > 0 ? i - 1 : i; // 구분 키 parent->keys[j]
+    Node* left_node = parent->children[j];
+    Node* right_node = parent->children[j + 1];
+
+    if (left_node->is_leaf) {
+        LeafNode* left = left_node->as_leaf();
+        LeafNode* right = right_node->as_leaf();
+        size_t total = left->count + right->count;
+
+        if (total <= static_cast<size_t>(degree - 1)) {
+            // 병합: 오른쪽 리프를 왼쪽에 붙이고 해제
+            std::copy(right->keys, right->keys + right->count, left->keys + left->count);
+            right->values.MoveTo(0, right->count, left->values, left->count);
+            left->count = total;
+            left->next = right->next;
+            if (right->next != nullptr) right->next->prev = left;
+            FreeNode(right);
+            ArrayErase(parent->children, parent->count + 1, j + 1);
+            ArrayErase(parent->keys, parent->count, j);
+            parent->count--;
+            return;
         }
 
-        // 오른쪽 형제에서 빌리기
-        if (i + 1 < internal->children.size()) {
-            LeafNode* right = internal->children[i + 1]->as_leaf();
-            if (right->keys.size() > min_keys) {
-                leaf->keys.push_back(right->keys.front());
-                right->keys.erase(right->keys.begin());
-                internal->keys[i] = right->keys.front();
-                return true;
-            }
+        // 재분배: 두 리프의 키 수를 반반으로
+        size_t target = total / 2;
+        if (left->count > target) {
+            size_t m = left->count - target; // 왼쪽 끝 m개를 오른쪽 앞으로
+            std::copy_backward(right->keys, right->keys + right->count, right->keys + right->count + m);
+            right->values.ShiftUp(right->count, m);
+            std::copy(left->keys + target, left->keys + left->count, right->keys);
+            left->values.MoveTo(target, m, right->values, 0);
+        } else {
+            size_t m = target - left->count; // 오른쪽 앞 m개를 왼쪽 끝으로
+            std::copy(right->keys, right->keys + m, left->keys + left->count);
+            right->values.MoveTo(0, m, left->values, left->count);
+            std::copy(right->keys + m, right->keys + right->count, right->keys);
+            right->values.MoveTo(m, right->count - m, right->values, 0);
         }
+        right->count = total - target;
+        left->count = target;
+        parent->keys[j] = right->keys[0];
+        return;
+    }
 
-        // 병합 시도
-        if (i > 0) {
-            // 왼쪽과 병합
-            LeafNode* left = internal->children[i - 1]->as_leaf();
-            left->keys.insert(left->keys.end(), leaf->keys.begin(), leaf->keys.end());
-            left->next = leaf->next;
-            delete leaf;
-            internal->children.erase(internal->children.begin() + i);
-            internal->keys.erase(internal->keys.begin() + i - 1);
-            merged = true;
-        } else if (i + 1 < internal->children.size()) {
-            // 오른쪽과 병합
-            LeafNode* right = internal->children[i + 1]->as_leaf();
-            leaf->keys.insert(leaf->keys.end(), right->keys.begin(), right->keys.end());
-            leaf->next = right->next;
-            delete right;
-            internal->children.erase(internal->children.begin() + i + 1);
-            internal->keys.erase(internal->keys.begin() + i);
-            merged = true;
-        }
-
-        // 루트가 비어있으면 루트 축소
-        if (internal == root && internal->keys.empty()) {
-            root = internal->children[0];
-            delete internal;
-        }
-
-        return merged;
-    }
-
-    // 내부 노드일 경우 재귀 호출
-    bool deleted = DeleteInternal(child, key);
-
-    // 이후 병합이나 재분배 필요 여부 확인
-    InternalNode* child_internal = child->as_internal();
-    int min_children = std::ceil(degree / 2.0);
-    if (child_internal->children.size() >= min_children) return deleted;
-
-    // 재분배 또는 병합
-    if (i > 0) {
-        InternalNode* left = internal->children[i - 1]->as_internal();
-        if (left->children.size() > min_children) {
-            // 왼쪽 형제에서 빌려오기
-            child_internal->children.insert(child_internal->children.begin(), left->children.back());
-            left->children.pop_back();
-            child_internal->keys.insert(child_internal->keys.begin(), internal->keys[i - 1]);
-            internal->keys[i - 1] = left->keys.back();
-            left->keys.pop_back();
-            return true;
-        }
-    }
-
-    if (i + 1 < internal->children.size()) {
-        InternalNode* right = internal->children[i + 1]->as_internal();
-        if (right->children.size() > min_children) {
-            // 오른쪽 형제에서 빌려오기
-            child_internal->children.push_back(right->children.front());
-            right->children.erase(right->children.begin());
-            child_internal->keys.push_back(internal->keys[i]);
-            internal->keys[i] = right->keys.front();
-            right->keys.erase(right->keys.begin());
-            return true;
-        }
-    }
-
-    // 병합
-    if (i > 0) {
-        InternalNode* left = internal->children[i - 1]->as_internal();
-        left->keys.push_back(internal->keys[i - 1]);
-        left->keys.insert(left->keys.end(), child_internal->keys.begin(), child_internal->keys.end());
-        left->children.insert(left->children.end(), child_internal->children.begin(), child_internal->children.end());
-        delete child_internal;
-        internal->children.erase(internal->children.begin() + i);
-        internal->keys.erase(internal->keys.begin() + i - 1);
-    } else if (i + 1 < internal->children.size()) {
-        InternalNode* right = internal->children[i + 1]->as_internal();
-        child_internal->keys.push_back(internal->keys[i]);
-        child_internal->keys.insert(child_internal->keys.end(), right->keys.begin(), right->keys.end());
-        child_internal->children.insert(child_internal->children.end(), right->children.begin(), right->children.end());
-        delete right;
-        internal->children.erase(internal->children.begin() + i + 1);
-        internal->keys.erase(internal->keys.begin() + i);
-    }
-
-    // 루트가 비어 있다면 축소
-    if (internal == root && internal->keys.empty()) {
-        root = internal->children[0];
-        delete internal;
+    InternalNode* left = left_node->as_internal();
+    InternalNode* right = right_node->as_internal();
+    size_t total = left->count + right->count + 2; // 자식 수
+
+    if (total <= static_cast<size_t>(degree)) {
+        // 병합: 구분 키를 내려 받고 오른쪽 노드를 붙인다
+        left->keys[left->count] = parent->keys[j];
+        std::copy(right->keys, right->keys + right->count, left->keys + left->count + 1);
+        std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+        left->count += right->count + 1;
+        FreeNode(right);
+        ArrayErase(parent->children, parent->count + 1, j + 1);
+        ArrayErase(parent->keys, parent->count, j);
+        parent->count--;
+        return;
     }
 
-    return true;
+    // 재분배: 구분 키를 거쳐 자식 m개를 회전
+    size_t target = total / 2; // 왼쪽에 남길 자식 수
+    size_t left_children = left->count + 1;
+    if (left_children > target) {
+        size_t m = left_children - target;
+        std::copy_backward(right->keys, right->keys + right->count, right->keys + right->count + m);
+        std::copy_backward(right->children, right->children + right->count + 1, right->children + right->count + 1 + m);
+        right->keys[m - 1] = parent->keys[j];
+        std::copy(left->keys + left->count - m + 1, left->keys + left->count, right->keys);
+        std::copy(left->children + left->count + 1 - m, left->children + left->count + 1, right->children);
+        parent->keys[j] = left->keys[left->count - m];
+        left->count -= m;
+        right->count += m;
+    } else if (left_children < target) {
+        size_t m = target - left_children;
+        left->keys[left->count] = parent->keys[j];
+        std::copy(right->keys, right->keys + m - 1, left->keys + left->count + 1);
+        std::copy(right->children, right->children + m, left->children + left->count + 1);
+        parent->keys[j] = right->keys[m - 1];
+        std::copy(right->keys + m, right->keys + right->count, right->keys);
+        std::copy(right->children + m, right->children + right->count + 1, right->children);
+        left->count += m;
+        right->count -= m;
+    }
+}
+
+// CompactRecursive function: Repairs the underfull nodes below 'node', children first.
+template<typename Key, typename Value, size_t NodeBytes>
+bool Bplustree<Key, Value, NodeBytes>::CompactRecursive(Node* node) {
+    if (node->is_leaf) return false;
+
+    InternalNode* internal = node->as_internal();
+    bool left_behind = false;
+    for (size_t i = 0; i <= internal->count; ++i) {
+        left_behind |= CompactRecursive(internal->children[i]);
+    }
+
+    for (size_t i = 0; i <= internal->count && internal->count > 0;) {
+        if (!Underfull(internal->children[i], false)) {
+            ++i;
+            continue;
+        }
+        size_t count = internal->count;
+        FixChild(internal, i);
+        if (internal->count == count) {
+            ++i; // 재분배: 두 노드 모두 절반 이상
+        } else if (i > 0) {
+            --i; // 왼쪽에 병합됨: 합친 노드를 다시 검사
+        }
+    }
+    // 형제 없이 남은 자식이 아직 부족하면 다음 패스에서 처리
+    return left_behind || (internal->count == 0 && Underfull(internal->children[0], false));
 }
 
 // FindLeaf function: Traverses the B+ Tree from the root to find the leaf node that should contain the given key.
 // FindLeaf 함수: 키가 삽입/검색/삭제될 위치를 찾기 위해 루트부터 리프까지 내려가는 함수
-template<typename Key>
-typename Bplustree<Key>::LeafNode* Bplustree<Key>::FindLeaf(const Key& key) const {
+template<typename Key, typename Value, size_t NodeBytes>
+typename Bplustree<Key, Value, NodeBytes>::LeafNode* Bplustree<Key, Value, NodeBytes>::FindLeaf(const Key& key) const {
     // TODO: Implement the traversal logic to locate the correct leaf node.
     Node* current = root;
     // leaf까지 내려가는 루프
     while (!current->is_leaf) {
         InternalNode* internal = current->as_internal();
-        size_t i = 0;
-        // 키를 왼쪽에서 부터 찾으려는 키 전까지 (혹은 끝까지) i가 인덱스로 가르킴
-        while (i < internal->keys.size() && key >= internal->keys[i]) {
-            ++i;
-        }
+        // key 이하인 구분 키의 개수가 곧 내려갈 자식 인덱스 (SIMD 비교)
+        size_t i = ChildIndex(internal, key);
         current = internal->children[i]; // 자식으로 내려감
     }
     return current->as_leaf();
 }
 
 // Print function: Public interface to print the B+ Tree structure.
-template<typename Key>
-void Bplustree<Key>::Print() const {
+template<typename Key, typename Value, size_t NodeBytes>
+void Bplustree<Key, Value, NodeBytes>::Print() const {
     PrintRecursive(root, 0);
 }
 
+template<typename Key, typename Value, size_t NodeBytes>
+bool Bplustree<Key, Value, NodeBytes>::Verify(std::string* error) const {
+    int leaf_depth = -1;
+    std::vector<const LeafNode*> leaves;
+    size_t keys = 0;
+    std::string problem = VerifyRecursive(root, 0, nullptr, nullptr, leaf_depth, leaves, keys);
+    // 리프 체인은 트리의 왼쪽부터의 순서와 같아야 한다
+    for (size_t i = 0; problem.empty() && i < leaves.size(); ++i) {
+        const LeafNode* next = i + 1 < leaves.size() ? leaves[i + 1] : nullptr;
+        const LeafNode* prev = i > 0 ? leaves[i - 1] : nullptr;
+        if (leaves[i]->next != next || leaves[i]->prev != prev) problem = "leaf chain out of order";
+    }
+    if (problem.empty() && keys != num_keys) problem = "key count does not match Size()";
+    if (!problem.empty() && error != nullptr) *error = problem;
+    return problem.empty();
+}
+
+template<typename Key, typename Value, size_t NodeBytes>
+std::string Bplustree<Key, Value, NodeBytes>::VerifyRecursive(const Node* node, int depth, const Key* low,
+                                                              const Key* high, int& leaf_depth,
+                                                              std::vector<const LeafNode*>& leaves,
+                                                              size_t& keys) const {
+    if (node->count > degree - 1) return "node holds more than degree - 1 keys";
+    if (node != root && Underfull(node, lazy_merge)) return "non-root node below the minimum fill";
+    const Key* node_keys = node->is_leaf ? node->as_leaf()->keys : node->as_internal()->keys;
+    for (size_t i = 0; i < node->count; ++i) {
+        if (i > 0 && !(node_keys[i - 1] < node_keys[i])) return "keys not strictly increasing in a node";
+        if ((low != nullptr && node_keys[i] < *low) || (high != nullptr && !(node_keys[i] < *high))) {
+            return "key outside the separator bounds of its node";
+        }
+    }
+    if (node->is_leaf) {
+        if (leaf_depth < 0) leaf_depth = depth;
+        if (depth != leaf_depth) return "leaves at different depths";
+        leaves.push_back(node->as_leaf());
+        keys += node->count;
+        return std::string();
+    }
+    const InternalNode* internal = node->as_internal();
+    if (internal->count == 0) return "internal node without separators";
+    // 자식 i의 키는 [keys[i - 1], keys[i]) 범위
+    for (size_t i = 0; i <= internal->count; ++i) {
+        const Key* child_low = i > 0 ? &internal->keys[i - 1] : low;
+        const Key* child_high = i < internal->count ? &internal->keys[i] : high;
+        std::string problem = VerifyRecursive(internal->children[i], depth + 1, child_low, child_high, leaf_depth,
+                                              leaves, keys);
+        if (!problem.empty()) return problem;
+    }
+    return std::string();
+}
+
 // Helper function: Recursively prints the tree structure with indentation based on tree level.
-template<typename Key>
-void Bplustree<Key>::PrintRecursive(const Node* node, int level) const {
+template<typename Key, typename Value, size_t NodeBytes>
+void Bplustree<Key, Value, NodeBytes>::PrintRecursive(const Node* node, int level) const {
     if (node == nullptr) return;
     // Indent based on the level in the tree.
     for (int i = 0; i < level; ++i)
@@ -448,17 +1414,17 @@ void Bplustree<Key>::PrintRecursive(const Node* node, int level) const {
         // Print leaf node keys.
         const LeafNode* leaf = node->as_leaf();
         std::cout << "[Leaf] ";
-        for (const Key& key : leaf->keys)
-            std::cout << key << " ";
+        for (size_t i = 0; i < leaf->count; ++i)
+            std::cout << leaf->keys[i] << " ";
         std::cout << std::endl;
     } else {
         // Print internal node keys and recursively print children.
         const InternalNode* internal = node->as_internal();
         std::cout << "[Internal] ";
-        for (const Key& key : internal->keys)
-            std::cout << key << " ";
+        for (size_t i = 0; i < internal->count; ++i)
+            std::cout << internal->keys[i] << " ";
         std::cout << std::endl;
-        for (const Node* child : internal->children)
-            PrintRecursive(child, level + 1);
+        for (size_t i = 0; i <= internal->count; ++i)
+            PrintRecursive(internal->children[i], level + 1);
     }
-}
\ No newline at end of file
+}
@@ -10,215 +10,556 @@
 #include <vector>
 #include <thread>
 #include <cstdio>
+#include <cstring>
 
 #include "zipf.h"
 #include "latest-generator.h"
 #include "bplustree.h"
+#include "olc_bplustree.h"
+#include "paged_bplustree.h"
+#include "wal.h"
+#include "benchmark.h"
+
+// Number of threads each phase is split across (--threads)
+static int num_threads = 1;
+
+// Leaf fill factor of the bulk-load benchmark (--fill)
+static double fill_factor = 1.0;
+
+// Leave underfull nodes for periodic compaction instead of merging on every delete (--lazy-delete)
+static bool lazy_delete = false;
+
+// Disk-backed tree: page file, buffer pool size in pages and O_DIRECT (--paged, --pool-pages, --page-file, --direct-io)
+static bool paged = false;
+static size_t pool_pages = 1024;
+static std::string page_file = "bplustree.pages";
+static bool direct_io = false;
+
+// Snapshot file written after the benchmark and reloaded from (--snapshot)
+static std::string snapshot_path;
+
+// Write-ahead log in front of the tree: log file, sync policy and interval (--wal, --sync, --sync-interval)
+static std::string wal_path;
+static SyncPolicy sync_policy = SyncPolicy::kEveryOp;
+static int sync_interval_ms = 10;
+
+template<size_t NodeBytes> using PlainTree = Bplustree<Key, void, NodeBytes>;
+template<size_t NodeBytes> using ConcurrentTree = OLCBplustree<Key, NodeBytes>;
+template<size_t NodeBytes> using LoggedPlainTree = Logged<Key, PlainTree<NodeBytes>>;
+template<size_t NodeBytes> using LoggedConcurrentTree = Logged<Key, ConcurrentTree<NodeBytes>>;
+
+// Constructs a Tree<NodeBytes> with the smallest node size (128B .. 4KB) whose
+// capacity fits 'degree' and calls fn(tree). Degrees above the 4KB capacity are clamped.
+// Extra constructor arguments ('args') are passed before the degree.
+template<template<size_t> class Tree, typename Fn, typename... Args>
+int WithTree(int degree, Fn fn, Args&... args) {
+    if (degree <= Tree<128>::kMaxDegree) { Tree<128> tree(args..., degree); return fn(tree); }
+    if (degree <= Tree<256>::kMaxDegree) { Tree<256> tree(args..., degree); return fn(tree); }
+    if (degree <= Tree<512>::kMaxDegree) { Tree<512> tree(args..., degree); return fn(tree); }
+    if (degree <= Tree<1024>::kMaxDegree) { Tree<1024> tree(args..., degree); return fn(tree); }
+    if (degree <= Tree<2048>::kMaxDegree) { Tree<2048> tree(args..., degree); return fn(tree); }
+    Tree<4096> tree(args..., degree);
+    return fn(tree);
+}
+
+// Results of the most recent benchmark (collected by --sweep)
+static PhaseResult last_write, last_read;
+
+// Print the results of a benchmark and append them to output.csv
+void Report(const char* label, const char* csv_name, const char* read_label,
+            const int write, const int read, const PhaseResult& w, const PhaseResult& r) {
+    float w_time = w.time_us;
+    float r_time = r.time_us;
+    last_write = w;
+    last_read = r;
+
+    // Display results
+    printf("\n[%s] Insertion = %.2lf µs, %s = %.2lf µs\n", label, w_time, read_label, r_time);
+    PrintThroughput("Insertion", w);
+    PrintThroughput(read_label, r);
+
+    // 파일에 저장
+    std::ofstream outFile("output.csv", std::ios::app); // append 모드
+    if (outFile.is_open()) {
+        outFile << write << "," << read << "," << csv_name << "," << w_time << "," << r_time << ","
+                << num_threads << "," << static_cast<long>(w.OpsPerSec()) << "," << static_cast<long>(r.OpsPerSec()) << ",";
+        WriteLatencyColumns(outFile, w.latency);
+        outFile << ",";
+        WriteLatencyColumns(outFile, r.latency);
+        outFile << "\n";
+        outFile.close();
+    }
+}
 
-void Zipfian(const int write, const int read, Bplustree<Key>& bpt) {
+template<typename Tree>
+void Zipfian(const int write, const int read, Tree& bpt) {
     // Zipfian distribution generator
     init_zipf_generator(0, write);
+    const unsigned int seed = std::random_device{}();
 
     // Insert keys following Zipfian distribution
-    auto w_start = Clock::now();
-    for (int i = 1; i <= write; ++i) {
-        Key key = nextValue() % write+1;        
-        bpt.Insert(key);
-    }
-    auto w_end = Clock::now();
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        unsigned int thread_seed = seed + tid; // 스레드별 난수 상태
+        for (int i = begin; i < end; ++i) {
+            Key key = nextValue_r(&thread_seed) % write+1;
+            auto op_start = PhaseClock::now();
+            bpt.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
     std::cout << "After Insert\n";
 
-    // Calculate insertion time
-    float w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
-
     // Search for keys following Zipfian distribution
-    auto r_start = Clock::now();
-    for (int i = 1; i <= read; ++i) {
-        Key key = nextValue() % read+1;
-        bpt.Contains(key);
-    }
-    auto r_end = Clock::now();
-
-    // Calculate search time
-    float r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
-
-    // Display results
-    printf("\n[Zipfian] Insertion = %.2lf µs, Lookup = %.2lf µs\n", w_time, r_time);
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        unsigned int thread_seed = seed + num_threads + tid;
+        for (int i = begin; i < end; ++i) {
+            Key key = nextValue_r(&thread_seed) % read+1;
+            auto op_start = PhaseClock::now();
+            bpt.Contains(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Zipfian", "Zipfian", "Lookup", write, read, w, r);
 }
 
-void Uniform(const int write, const int read, Bplustree<Key>& bpt) {
-    // Uniformly distributed random generator
+template<typename Tree>
+void Uniform(const int write, const int read, Tree& bpt) {
+    // Uniformly distributed random generator (one engine per thread)
     std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> distr(1, write);
+    const unsigned int seed = rd();
 
     // Insert random keys
-    auto w_start = Clock::now();
-    for (int i = 1; i <= write; ++i) {
-        bpt.Insert(distr(gen)+1);
-    }
-    auto w_end = Clock::now();
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        for (int i = begin; i < end; ++i) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            bpt.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
     std::cout << "After Insert\n";
 
-    // Calculate insertion time
-    float w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
-
     // Search for random keys
-    auto r_start = Clock::now();
-    for (int i = 1; i <= read; ++i) {
-        bpt.Contains(distr(gen)+1);
-    }
-    auto r_end = Clock::now();
-
-    // Calculate search time
-    float r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
-
-    // Display results
-    printf("\n[Uniform] Insertion = %.2lf µs, Lookup = %.2lf µs\n", w_time, r_time);
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + num_threads + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        for (int i = begin; i < end; ++i) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            bpt.Contains(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Uniform", "Uniform", "Lookup", write, read, w, r);
 }
 
-void RevSequential(const int write, const int read, Bplustree<Key>& bpt) {
-    // Insert keys reverse sequentially
-    auto w_start = Clock::now();
-    for (int i = write; i > 0; i--) {
-        bpt.Insert(i);
-    }
-    auto w_end = Clock::now();
+template<typename Tree>
+void RevSequential(const int write, const int read, Tree& bpt) {
+    // Insert keys reverse sequentially (each thread takes a contiguous range)
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = write - begin; i > write - end; i--) {
+            auto op_start = PhaseClock::now();
+            bpt.Insert(i);
+            latency.Add(NanosSince(op_start));
+        }
+    });
     std::cout << "After Insert\n";
 
-    // Calculate insertion time
-    float w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
-
     // Search for keys reverse sequentially
-    auto r_start = Clock::now();
-    for (int i = read; i > 0; i--) {
-        bpt.Contains(i);
-    }
-    auto r_end = Clock::now();
-
-    // Calculate search time
-    float r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
-
-    // Display results
-    printf("\n[Rev-Sequential] Insertion = %.2lf µs, Lookup = %.2lf µs\n", w_time, r_time);
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = read - begin; i > read - end; i--) {
+            auto op_start = PhaseClock::now();
+            bpt.Contains(i);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Rev-Sequential", "RevSequential", "Lookup", write, read, w, r);
 }
 
-void Sequential(const int write, const int read, Bplustree<Key>& bpt) {
-    // Insert keys sequentially
-    auto w_start = Clock::now();
-    for (int i = 1; i <= write; ++i) {
-        bpt.Insert(i);
-    }
-    auto w_end = Clock::now();
+template<typename Tree>
+void Sequential(const int write, const int read, Tree& bpt) {
+    // Insert keys sequentially (each thread takes a contiguous range)
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = begin + 1; i <= end; ++i) {
+            auto op_start = PhaseClock::now();
+            bpt.Insert(i);
+            latency.Add(NanosSince(op_start));
+        }
+    });
     std::cout << "After Insert\n";
 
-    // Calculate insertion time
-    float w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
-
     // Search for keys sequentially
-    auto r_start = Clock::now();
-    for (int i = 1; i <= read; ++i) {
-        bpt.Contains(i);
-    }
-    auto r_end = Clock::now();
-
-    // Calculate search time
-    float r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
-
-    // Display results
-    printf("\n[Sequential] Insertion = %.2lf µs, Lookup = %.2lf µs\n", w_time, r_time);
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = begin + 1; i <= end; ++i) {
+            auto op_start = PhaseClock::now();
+            bpt.Contains(i);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Sequential", "Sequential", "Lookup", write, read, w, r);
 }
 
-void Zipfian_Delete(const int write, const int read, Bplustree<Key>& bpt) {
+template<typename Tree>
+void Zipfian_Delete(const int write, const int read, Tree& bpt) {
     // Zipfian distribution generator
     init_zipf_generator(0, write);
+    const unsigned int seed = std::random_device{}();
 
     // Insert keys following Zipfian distribution
-    auto w_start = Clock::now();
-    for (int i = 1; i <= write; ++i) {
-        Key key = nextValue() % write+1;        
-        bpt.Insert(key);
-    }
-    auto w_end = Clock::now();
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        unsigned int thread_seed = seed + tid;
+        for (int i = begin; i < end; ++i) {
+            Key key = nextValue_r(&thread_seed) % write+1;
+            auto op_start = PhaseClock::now();
+            bpt.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
     std::cout << "After Insert\n";
 
-    // Calculate insertion time
-    float w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
+    // Insert Print
+    // bpt.Print();
 
     // Delete for keys following Zipfian distribution
-    auto r_start = Clock::now();
-    for (int i = 1; i <= read; ++i) {
-        Key key = nextValue() % read+1;
-        bpt.Delete(key);
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        unsigned int thread_seed = seed + num_threads + tid;
+        for (int i = begin; i < end; ++i) {
+            Key key = nextValue_r(&thread_seed) % read+1;
+            auto op_start = PhaseClock::now();
+            bpt.Delete(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Zipfian Delete", "ZipfianDelete", "Deletion", write, read, w, r);
+}
+
+template<typename Tree>
+void Uniform_Delete(const int write, const int read, Tree& bpt) {
+    // Uniformly distributed random generator (one engine per thread)
+    std::random_device rd;
+    const unsigned int seed = rd();
+
+    // Insert random keys
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        for (int i = begin; i < end; ++i) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            bpt.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+    std::cout << "After Insert\n";
+
+    // Insert Print
+    // bpt.Print();
+
+    // Delete for random keys
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + num_threads + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        for (int i = begin; i < end; ++i) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            bpt.Delete(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Uniform Delete", "UniformDelete", "Deletion", write, read, w, r);
+}
+
+template<typename Tree>
+void Uniform_Scan(const int write, const int read, Tree &bpt) {
+    std::random_device rd;
+    const unsigned int seed = rd();
+
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = begin + 1; i <= end; i++) {
+            //Key key = distr(gen)+1;
+            Key key = i;
+            auto op_start = PhaseClock::now();
+            bpt.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+    printf("After Insert\n");
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + tid);
+        std::uniform_int_distribution<int> distr(0, write);
+        std::vector<Key> buffer(1000); // 스레드별 결과 버퍼 (스캔마다 재사용)
+        for (int i = begin; i < end; i++) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            bpt.Scan(key, buffer.size(), buffer.data());
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Uniform-Scan", "UniformScan", "Lookup", write, read, w, r);
+}
+
+template<typename Tree>
+void Bulk_Load(const int write, const int read, Tree& bpt) {
+    // Sorted input (prepared outside the timed phase)
+    std::vector<Key> keys(write);
+    for (int i = 0; i < write; ++i) {
+        keys[i] = i + 1;
     }
-    auto r_end = Clock::now();
 
-    // Calculate search time
-    float r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
+    // Build the whole tree bottom-up in one call (single-threaded);
+    // the latency sample is the amortized cost per key.
+    PhaseResult w = RunPhase(1, write, [&](int tid, int begin, int end, Histogram& latency) {
+        auto op_start = PhaseClock::now();
+        bpt.BulkLoad(keys.begin(), keys.end(), fill_factor);
+        latency.Add(NanosSince(op_start) / std::max(1, end - begin));
+    });
+    std::cout << "After Insert\n";
 
-    // Display results
-    printf("\n[Zipfian Delete] Insertion = %.2lf µs, Deletion = %.2lf µs\n", w_time, r_time);
+    // Search for keys sequentially
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = begin + 1; i <= end; ++i) {
+            auto op_start = PhaseClock::now();
+            bpt.Contains(i);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Bulk Load", "BulkLoad", "Lookup", write, read, w, r);
 }
 
-void Uniform_Delete(const int write, const int read, Bplustree<Key>& bpt) {
-    // Uniformly distributed random generator
+template<typename Tree>
+void Reverse_Scan(const int write, const int read, Tree& bpt) {
     std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> distr(1, write);
+    const unsigned int seed = rd();
+
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        for (int i = begin + 1; i <= end; i++) {
+            Key key = i;
+            auto op_start = PhaseClock::now();
+            bpt.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+    printf("After Insert\n");
+
+    // 최신(큰 키)부터 거꾸로 1000개씩 읽기
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + tid);
+        std::uniform_int_distribution<int> distr(0, write);
+        for (int i = begin; i < end; i++) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            bpt.ReverseScan(key, 1000);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Reverse-Scan", "ReverseScan", "Lookup", write, read, w, r);
+}
+
+// Keys per MultiContains call in the Multi-Get benchmark
+static const int kMultiGetBatch = 64;
+
+template<typename Tree>
+void Uniform_MultiGet(const int write, const int read, Tree& bpt) {
+    // Uniformly distributed random generator (one engine per thread)
+    std::random_device rd;
+    const unsigned int seed = rd();
 
     // Insert random keys
-    auto w_start = Clock::now();
-    for (int i = 1; i <= write; ++i) {
-        bpt.Insert(distr(gen)+1);
-    }
-    auto w_end = Clock::now();
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        for (int i = begin; i < end; ++i) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            bpt.Insert(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
     std::cout << "After Insert\n";
 
-    // Calculate insertion time
-    float w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
+    // Search for random keys in batches; the latency sample is the amortized cost per key
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + num_threads + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        Key keys[kMultiGetBatch];
+        bool found[kMultiGetBatch];
+        for (int i = begin; i < end; i += kMultiGetBatch) {
+            int batch = std::min(kMultiGetBatch, end - i);
+            for (int j = 0; j < batch; ++j) {
+                keys[j] = distr(gen)+1;
+            }
+            auto op_start = PhaseClock::now();
+            bpt.MultiContains(keys, batch, found);
+            latency.Add(NanosSince(op_start) / batch);
+        }
+    });
+
+    Report("Uniform Multi-Get", "UniformMultiGet", "Lookup", write, read, w, r);
+}
 
-    // Delete for random keys
-    auto r_start = Clock::now();
-    for (int i = 1; i <= read; ++i) {
-        bpt.Delete(distr(gen)+1);
+// Keys per InsertBatch call in the Insert-Batch benchmark
+static const int kInsertBatch = 256;
+
+template<typename Tree>
+void Uniform_InsertBatch(const int write, const int read, Tree& bpt) {
+    // Uniformly distributed random generator (one engine per thread)
+    std::random_device rd;
+    const unsigned int seed = rd();
+
+    // Insert random keys in batches; the latency sample is the amortized cost per key
+    PhaseResult w = RunPhase(num_threads, write, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        std::vector<Key> keys(kInsertBatch);
+        for (int i = begin; i < end; i += kInsertBatch) {
+            int batch = std::min(kInsertBatch, end - i);
+            for (int j = 0; j < batch; ++j) {
+                keys[j] = distr(gen)+1;
+            }
+            auto op_start = PhaseClock::now();
+            bpt.InsertBatch(keys.begin(), keys.begin() + batch);
+            latency.Add(NanosSince(op_start) / batch);
+        }
+    });
+    std::cout << "After Insert\n";
+
+    // Search for random keys
+    PhaseResult r = RunPhase(num_threads, read, [&](int tid, int begin, int end, Histogram& latency) {
+        std::mt19937 gen(seed + num_threads + tid);
+        std::uniform_int_distribution<int> distr(1, write);
+        for (int i = begin; i < end; ++i) {
+            Key key = distr(gen)+1;
+            auto op_start = PhaseClock::now();
+            bpt.Contains(key);
+            latency.Add(NanosSince(op_start));
+        }
+    });
+
+    Report("Uniform Insert-Batch", "UniformInsertBatch", "Lookup", write, read, w, r);
+}
+
+// Saves the tree to snapshot_path after a benchmark, then restarts from the file twice:
+// serving lookups straight from the mapping (SnapshotReader) and rebuilding a tree (LoadSnapshot)
+template<typename Tree>
+int RunSnapshot(const Tree& bpt, const int read) {
+    std::string error;
+    auto start = PhaseClock::now();
+    if (!bpt.SaveSnapshot(snapshot_path, &error)) {
+        std::cerr << "SaveSnapshot failed: " << error << "\n";
+        return 1;
+    }
+    double save_s = NanosSince(start) * 1e-9;
+
+    start = PhaseClock::now();
+    SnapshotReader<Key> reader;
+    if (!reader.Open(snapshot_path)) {
+        std::cerr << "SnapshotReader failed: " << reader.Error() << "\n";
+        return 1;
     }
-    auto r_end = Clock::now();
+    double open_s = NanosSince(start) * 1e-9;
+
+    // 매핑에서 바로 조회 (키 범위 안의 임의의 키)
+    size_t found = 0;
+    std::mt19937_64 gen(std::random_device{}());
+    Key low = reader.Size() > 0 ? reader.Keys()[0] : 0;
+    Key high = reader.Size() > 0 ? reader.Keys()[reader.Size() - 1] : 0;
+    std::uniform_int_distribution<Key> distr(low, high);
+    start = PhaseClock::now();
+    for (int i = 0; i < read; ++i) {
+        found += reader.Contains(distr(gen));
+    }
+    double lookup_s = NanosSince(start) * 1e-9;
 
-    // Calculate search time
-    float r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
+    start = PhaseClock::now();
+    Tree loaded(bpt.Degree());
+    if (!loaded.LoadSnapshot(snapshot_path, 1.0, &error) || loaded.Size() != bpt.Size()) {
+        std::cerr << "LoadSnapshot failed: " << (error.empty() ? "size mismatch" : error) << "\n";
+        return 1;
+    }
+    double load_s = NanosSince(start) * 1e-9;
 
-    // Display results
-    printf("\n[Uniform Delete] Insertion = %.2lf µs, Deletion = %.2lf µs\n", w_time, r_time);
+    printf("\n[Snapshot] %zu keys, %.1f MB in %s\n", reader.Size(), reader.FileBytes() / 1048576.0, snapshot_path.c_str());
+    printf("  Save = %.3f s, Open + verify = %.3f s, LoadSnapshot (rebuild) = %.3f s\n", save_s, open_s, load_s);
+    printf("  Lookups from the mapping = %.0f ops/s (%zu of %d found)\n", read / std::max(lookup_s, 1e-9), found, read);
+    return 0;
 }
 
-void Uniform_Scan(const int write, const int read, Bplustree<Key> &bpt) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<int> distr(0, write);
-
-    auto w_start = Clock::now();
-    for(int i = 1; i <= write; i++) {
-        //Key key = distr(gen)+1;
-        Key key = i;
-        bpt.Insert(key);
+const char* SyncPolicyName(SyncPolicy policy) {
+    switch (policy) {
+        case SyncPolicy::kEveryOp: return "every";
+        case SyncPolicy::kInterval: return "interval";
+        case SyncPolicy::kNone: return "none";
     }
-    auto w_end = Clock::now();
-    printf("After Insert\n");
-    auto r_start = Clock::now();
-    for(int i = 1; i <= read; i++) {
-        Key key = distr(gen)+1;
-        bpt.Scan(key, 1000);
+    return "?";
+}
+
+// Runs a benchmark on a tree behind a write-ahead log (--wal), then reopens the log and times
+// its replay into an empty tree, which is what a restart would do. 'setup' configures each tree.
+template<template<size_t> class Tree, typename Setup>
+int RunLogged(const int W, const int R, const int B, int degree, Setup setup, const char* programName) {
+    std::remove(wal_path.c_str()); // 이전 실행의 로그는 버린다
+    WriteAheadLog<Key>::Stats stats;
+    {
+        WriteAheadLog<Key> log(wal_path, sync_policy, sync_interval_ms);
+        int ret = WithTree<Tree>(degree, [&](auto& bpt) {
+            setup(bpt);
+            return RunBenchmark(W, R, B, bpt, programName);
+        }, log);
+        if (ret != 0) return ret;
+        stats = log.GetStats();
     }
-    auto r_end = Clock::now();
 
-    float r_time, w_time;
-    r_time = std::chrono::duration_cast<std::chrono::nanoseconds>(r_end - r_start).count() * 0.001;
-    w_time = std::chrono::duration_cast<std::chrono::nanoseconds>(w_end - w_start).count() * 0.001;
-    printf("\n[Uniform-Scan] Insertion = %.2lf µs, Lookup = %.2lf µs\n", w_time, r_time);
+    auto start = PhaseClock::now();
+    WriteAheadLog<Key> log(wal_path, sync_policy, sync_interval_ms);
+    return WithTree<Tree>(degree, [&](auto& bpt) {
+        setup(bpt);
+        size_t records = bpt.Replay();
+        double replay_s = NanosSince(start) * 1e-9;
+
+        printf("\n[WAL] sync = %s", SyncPolicyName(sync_policy));
+        if (sync_policy == SyncPolicy::kInterval) printf(" (%d ms)", sync_interval_ms);
+        printf(", %llu records, %.1f MB in %s\n", static_cast<unsigned long long>(stats.records),
+               stats.bytes / 1048576.0, wal_path.c_str());
+        printf("  During the run: fsyncs = %llu (%.1f records per fsync), writes = %llu\n", static_cast<unsigned long long>(stats.syncs),
+               stats.RecordsPerSync(), static_cast<unsigned long long>(stats.writes));
+        printf("  Recovery: replayed %zu records into %zu keys in %.3f s\n", records, bpt.Size(), replay_s);
+        if (records != stats.records) {
+            std::cerr << "Replay found " << records << " records, expected " << stats.records << "\n";
+            return 1;
+        }
+        return 0;
+    }, log);
+}
+
+// Print the buffer pool counters of a paged benchmark (both phases together)
+void ReportPool(const BufferPool& pool, const int write, const int read, size_t file_bytes, int degree) {
+    const BufferPool::Stats& stats = pool.GetStats();
+    const double ops = std::max(1, write + read);
+    printf("Buffer pool: %zu frames (%.1f MB), file %.1f MB, degree %d\n", pool.NumFrames(),
+           pool.NumFrames() * pool.PageSize() / 1048576.0, file_bytes / 1048576.0, degree);
+    printf("  Hits = %llu, Misses = %llu, Hit ratio = %.4f\n", static_cast<unsigned long long>(stats.hits),
+           static_cast<unsigned long long>(stats.misses), stats.HitRatio());
+    printf("  Page reads = %llu, Page writes = %llu, I/O per op = %.3f\n",
+           static_cast<unsigned long long>(stats.reads), static_cast<unsigned long long>(stats.writes),
+           (stats.reads + stats.writes) / ops);
 }
 
 void printUsage(const char* programName) {
-    std::cerr << "\nUsage: " << programName << " [Write Count] [Read Count] [Benchmark #]\n\n"
+    std::cerr << "\nUsage: " << programName << " [Write Count] [Read Count] [Benchmark #] [--degree D] [--fill F] [--lazy-delete] [--snapshot PATH] [--threads N]\n"
+              << "       " << programName << " [Write Count] [Read Count] [Benchmark #] --wal PATH [--sync every|interval|none] [--sync-interval MS] [...]\n"
+              << "       " << programName << " [Write Count] [Read Count] [Benchmark #] --paged [--pool-pages P] [--page-file PATH] [--direct-io]\n"
+              << "       " << programName << " --sweep [--sweep-keys N1,N2,...] [--sweep-degrees D1,D2,...]\n\n"
               << "Benchmark can be selected by number or name.\n\n"
               << "Synthetic Benchmarks:\n"
               << " 0 - Sequential\n"
@@ -227,41 +568,223 @@ void printUsage(const char* programName) {
               << " 3 - Zipfian\n"
               << " 4 - Uniform Delete\n"
               << " 5 - Zipfian Delete\n"
-              << " 6 - Scan\n";
+              << " 6 - Scan\n"
+              << " 7 - Bulk Load (sorted keys, then sequential lookups)\n"
+              << " 8 - Reverse Scan (1000 keys <= a random key, largest first)\n"
+              << " 9 - Uniform Multi-Get (lookups in batches of 64 via MultiContains)\n"
+              << " 10 - Uniform Insert-Batch (inserts in batches of 256 via InsertBatch)\n\n"
+              << "Options:\n"
+              << " --degree D  - maximum children per node (default: fill a 256-byte node);\n"
+              << "               the node size is the smallest of 128B..4KB that fits D\n"
+              << " --fill F    - leaf fill factor of the bulk-load benchmark, 0 < F <= 1 (default 1.0)\n"
+              << " --lazy-delete - merge underfull nodes lazily in periodic Compact passes\n"
+              << "               (see Bplustree::SetLazyMerge; single-threaded tree only)\n"
+              << " --snapshot PATH - after the benchmark save the tree to PATH, then time reopening it:\n"
+              << "               lookups served from the mapped file and a rebuild with LoadSnapshot\n"
+              << " --wal PATH  - log every Insert/Delete to PATH first (a new log; with --threads the writers\n"
+              << "               share fsyncs), then report fsyncs and time a replay of the log\n"
+              << " --sync P    - when a logged operation is durable: every (fsync before it returns, default),\n"
+              << "               interval (background fsync every --sync-interval MS, default 10) or none\n"
+              << " --threads N - split every phase across N threads sharing one OLCBplustree\n"
+              << " --paged     - use the disk-backed PagedBplustree (4KB pages, single-threaded) and\n"
+              << "               report buffer pool hits, misses and page I/O per operation\n"
+              << "               (the default degree then fills a 4KB page)\n"
+              << " --pool-pages P - buffer pool size in 4KB pages (default 1024 = 4MB)\n"
+              << " --page-file PATH - scratch page file, removed at exit (default bplustree.pages)\n"
+              << " --direct-io - open the page file with O_DIRECT so misses bypass the OS page cache\n"
+              << " --sweep     - run every benchmark for each key count (write = read = N) and degree,\n"
+              << "               print a throughput / memory-per-key table and write it to sweep.csv\n";
 }
 
-int main(int argc, char *argv[]) {
-    if (argc != 4) {
-        printUsage(argv[0]);
-        return 1;
-    }
-
-    const int W = std::atoi(argv[1]);  // Insertion count
-    const int R = std::atoi(argv[2]);  // Lookup count
-    const int B = std::atoi(argv[3]);  // Benchmark type
-
-    Bplustree<Key> bpt;
-
-    auto runBenchmarkType1 = [&](const std::string& name, void (*benchmarkFunc)(int, int, Bplustree<Key>&)) {
+template<typename Tree>
+int RunBenchmark(const int W, const int R, const int B, Tree& bpt, const char* programName) {
+    auto runBenchmarkType1 = [&](const std::string& name, void (*benchmarkFunc)(int, int, Tree&)) {
         std::cout << "\n[" << name << " Benchmark in progress...]\n\n";
         benchmarkFunc(W, R, bpt);
     };
 
     switch (B) {
         // Type 1:
-        case 0: runBenchmarkType1("Sequential", Sequential); break;
-        case 1: runBenchmarkType1("Rev-Sequential", RevSequential); break;
-        case 2: runBenchmarkType1("Uniform", Uniform); break;
-        case 3: runBenchmarkType1("Zipfian", Zipfian); break;
-        case 4: runBenchmarkType1("Uniform Delete", Uniform_Delete); break;
-        case 5: runBenchmarkType1("Zipfian Delete", Zipfian_Delete); break;
-        case 6: runBenchmarkType1("Scan", Uniform_Scan); break;
+        case 0: runBenchmarkType1("Sequential", Sequential<Tree>); break;
+        case 1: runBenchmarkType1("Rev-Sequential", RevSequential<Tree>); break;
+        case 2: runBenchmarkType1("Uniform", Uniform<Tree>); break;
+        case 3: runBenchmarkType1("Zipfian", Zipfian<Tree>); break;
+        case 4: runBenchmarkType1("Uniform Delete", Uniform_Delete<Tree>); break;
+        case 5: runBenchmarkType1("Zipfian Delete", Zipfian_Delete<Tree>); break;
+        case 6: runBenchmarkType1("Scan", Uniform_Scan<Tree>); break;
+        case 7: runBenchmarkType1("Bulk Load", Bulk_Load<Tree>); break;
+        case 8: runBenchmarkType1("Reverse Scan", Reverse_Scan<Tree>); break;
+        case 9: runBenchmarkType1("Uniform Multi-Get", Uniform_MultiGet<Tree>); break;
+        case 10: runBenchmarkType1("Uniform Insert-Batch", Uniform_InsertBatch<Tree>); break;
 
         default:
             std::cerr << "Invalid benchmark option provided.\n";
-            printUsage(argv[0]);
+            printUsage(programName);
             return 1;
     }
+
+    // 노드 메모리 사용량
+    printf("Degree = %d, node size = %zu bytes, memory usage = %zu bytes (%.1lf bytes/key)\n",
+           bpt.Degree(), Tree::kNodeBytes, bpt.ApproximateMemoryUsage(),
+           bpt.Size() > 0 ? static_cast<double>(bpt.ApproximateMemoryUsage()) / bpt.Size() : 0.0);
+
     // bpt.Print();
+
     return 0;
-}
\ No newline at end of file
+}
+
+// One row of the --sweep table
+struct SweepRow {
+    int keys;
+    int degree;
+    size_t node_bytes;
+    int benchmark;
+    double write_ops;
+    double read_ops;
+    double bytes_per_key;
+};
+
+// Parses a comma separated list of positive integers ("4,16,64")
+std::vector<int> ParseList(const char* arg) {
+    std::vector<int> values;
+    for (const char* p = arg; *p != '\0';) {
+        values.push_back(std::atoi(p));
+        p = std::strchr(p, ',');
+        if (p == nullptr) break;
+        ++p;
+    }
+    return values;
+}
+
+// Runs the whole benchmark matrix for every (key count, degree) pair on a fresh tree
+int RunSweep(const std::vector<int>& key_counts, const std::vector<int>& degrees, const char* programName) {
+    static const char* kNames[] = {"Sequential", "RevSequential", "Uniform", "Zipfian",
+                                   "UniformDelete", "ZipfianDelete", "UniformScan", "BulkLoad",
+                                   "ReverseScan", "UniformMultiGet", "UniformInsertBatch"};
+    const int kNumBenchmarks = 11;
+
+    std::vector<SweepRow> rows;
+    for (int keys : key_counts) {
+        for (int degree : degrees) {
+            for (int b = 0; b < kNumBenchmarks; ++b) {
+                int ret = WithTree<PlainTree>(degree, [&](auto& bpt) {
+                    int r = RunBenchmark(keys, keys, b, bpt, programName);
+                    double bytes_per_key = bpt.Size() > 0 ? static_cast<double>(bpt.ApproximateMemoryUsage()) / bpt.Size() : 0.0;
+                    rows.push_back({keys, bpt.Degree(), std::decay_t<decltype(bpt)>::kNodeBytes, b,
+                                    last_write.OpsPerSec(), last_read.OpsPerSec(), bytes_per_key});
+                    return r;
+                });
+                if (ret != 0) return ret;
+            }
+        }
+    }
+
+    // 결과 표 출력 및 sweep.csv 저장
+    std::ofstream outFile("sweep.csv");
+    outFile << "Keys,Degree,NodeBytes,Benchmark,InsertOps/s,Read/DeleteOps/s,BytesPerKey\n";
+    printf("\n%10s %7s %10s %-18s %14s %18s %12s\n",
+           "Keys", "Degree", "NodeBytes", "Benchmark", "Insert ops/s", "Read/Delete ops/s", "Bytes/key");
+    for (const SweepRow& row : rows) {
+        printf("%10d %7d %10zu %-18s %14.0lf %18.0lf %12.1lf\n", row.keys, row.degree, row.node_bytes,
+               kNames[row.benchmark], row.write_ops, row.read_ops, row.bytes_per_key);
+        outFile << row.keys << "," << row.degree << "," << row.node_bytes << "," << kNames[row.benchmark] << ","
+                << static_cast<long>(row.write_ops) << "," << static_cast<long>(row.read_ops) << ","
+                << row.bytes_per_key << "\n";
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    // 옵션(--threads, --degree, --sweep...)을 분리하고 나머지는 위치 인자로 처리
+    std::vector<char*> args;
+    bool concurrent = false;
+    bool sweep = false;
+    int degree = 0; // 0: the default of the selected tree
+    std::vector<int> sweep_keys = {10000, 100000, 1000000};
+    std::vector<int> sweep_degrees = {4, 8, 16, 32, 64, 128, 255};
+    for (int i = 0; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            num_threads = std::atoi(argv[++i]);
+            concurrent = true;
+        } else if (std::strcmp(argv[i], "--degree") == 0 && i + 1 < argc) {
+            degree = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--fill") == 0 && i + 1 < argc) {
+            fill_factor = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--lazy-delete") == 0) {
+            lazy_delete = true;
+        } else if (std::strcmp(argv[i], "--paged") == 0) {
+            paged = true;
+        } else if (std::strcmp(argv[i], "--pool-pages") == 0 && i + 1 < argc) {
+            pool_pages = std::strtoul(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--page-file") == 0 && i + 1 < argc) {
+            page_file = argv[++i];
+        } else if (std::strcmp(argv[i], "--direct-io") == 0) {
+            direct_io = true;
+        } else if (std::strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+            snapshot_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--wal") == 0 && i + 1 < argc) {
+            wal_path = argv[++i];
+        } else if (std::strcmp(argv[i], "--sync") == 0 && i + 1 < argc) {
+            ++i;
+            if (std::strcmp(argv[i], "every") == 0) sync_policy = SyncPolicy::kEveryOp;
+            else if (std::strcmp(argv[i], "interval") == 0) sync_policy = SyncPolicy::kInterval;
+            else if (std::strcmp(argv[i], "none") == 0) sync_policy = SyncPolicy::kNone;
+            else sync_interval_ms = -1; // 잘못된 정책: 아래에서 사용법 출력
+        } else if (std::strcmp(argv[i], "--sync-interval") == 0 && i + 1 < argc) {
+            sync_interval_ms = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--sweep") == 0) {
+            sweep = true;
+        } else if (std::strcmp(argv[i], "--sweep-keys") == 0 && i + 1 < argc) {
+            sweep_keys = ParseList(argv[++i]);
+        } else if (std::strcmp(argv[i], "--sweep-degrees") == 0 && i + 1 < argc) {
+            sweep_degrees = ParseList(argv[++i]);
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+
+    if (sweep && args.size() == 1 && !concurrent && !paged) {
+        return RunSweep(sweep_keys, sweep_degrees, argv[0]);
+    }
+
+    // --degree가 없으면 트리 종류에 맞는 기본값 (페이지 트리는 4KB 페이지를 채운다)
+    if (degree == 0) degree = paged ? PagedBplustree<Key>::kMaxDegree : Bplustree<Key>::kMaxDegree;
+
+    if (sweep || args.size() != 4 || num_threads < 1 || degree < 3 || fill_factor <= 0 || fill_factor > 1 ||
+        (lazy_delete && concurrent) || (paged && (concurrent || lazy_delete)) ||
+        (!snapshot_path.empty() && (concurrent || paged)) ||
+        (!wal_path.empty() && (paged || !snapshot_path.empty())) || sync_interval_ms < 1) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    const int W = std::atoi(args[1]);  // Insertion count
+    const int R = std::atoi(args[2]);  // Lookup count
+    const int B = std::atoi(args[3]);  // Benchmark type
+
+    if (paged) {
+        PagedBplustree<Key> bpt(page_file, pool_pages, degree, direct_io, true); // scratch: 매번 빈 파일에서 시작
+        int ret = RunBenchmark(W, R, B, bpt, argv[0]);
+        if (ret == 0) ReportPool(bpt.Pool(), W, R, bpt.FileBytes(), bpt.Degree());
+        return ret;
+    }
+
+    if (!wal_path.empty()) {
+        if (concurrent) {
+            return RunLogged<LoggedConcurrentTree>(W, R, B, degree, [](auto&) {}, argv[0]);
+        }
+        return RunLogged<LoggedPlainTree>(W, R, B, degree, [](auto& bpt) { bpt.SetLazyMerge(lazy_delete); }, argv[0]);
+    }
+
+    // 멀티스레드 모드에서는 optimistic lock coupling 트리를 공유
+    if (concurrent) {
+        return WithTree<ConcurrentTree>(degree, [&](auto& bpt) { return RunBenchmark(W, R, B, bpt, argv[0]); });
+    }
+
+    return WithTree<PlainTree>(degree, [&](auto& bpt) {
+        bpt.SetLazyMerge(lazy_delete);
+        int ret = RunBenchmark(W, R, B, bpt, argv[0]);
+        if (ret == 0 && !snapshot_path.empty()) ret = RunSnapshot(bpt, R);
+        return ret;
+    });
+}
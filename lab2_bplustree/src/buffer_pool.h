@@ -0,0 +1,221 @@
+#ifndef LAB2_BPLUSTREE_BUFFER_POOL_H_
+#define LAB2_BPLUSTREE_BUFFER_POOL_H_
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Page id inside the page file (page i lives at byte offset i * page_size)
+typedef uint32_t PageId;
+static constexpr PageId kInvalidPage = UINT32_MAX;
+
+// BufferPool: caches fixed-size pages of one file in a fixed number of frames.
+//
+// - Pin returns the frame holding a page, reading it with pread on a miss.
+//   A pinned frame is never evicted; every Pin is paired with an Unpin.
+// - Eviction uses the clock algorithm: each frame has a reference bit that
+//   Pin sets and the clock hand clears, so a frame is only evicted after the
+//   hand has passed it once without it being used.
+// - Dirty pages are written back with pwrite when they are evicted, by
+//   FlushAll and when the pool is destroyed; clean pages are dropped.
+// - A scratch pool truncates the file when it opens it and removes it when it
+//   is destroyed, without writing anything back. Otherwise the file keeps its
+//   pages and can be opened again.
+//
+// The pool is not thread-safe (the paged tree it serves is single-threaded).
+// I/O errors are fatal: the process prints the error and aborts.
+class BufferPool {
+   public:
+    // Statistics since construction (or ResetStats)
+    struct Stats {
+        uint64_t hits = 0;   // Pins served from a frame
+        uint64_t misses = 0; // Pins that had to read the page (or allocate it)
+        uint64_t reads = 0;  // Pages read from the file
+        uint64_t writes = 0; // Pages written to the file
+
+        double HitRatio() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0; }
+    };
+
+    // Opens the page file at 'path', creating it if needed; its existing pages are kept
+    // unless the pool is 'scratch' (see above). With 'direct_io' the file is opened
+    // with O_DIRECT so that misses really go to the device instead of the OS page
+    // cache; file systems that do not support it fall back to buffered I/O.
+    BufferPool(const std::string& path, size_t page_size, size_t num_frames, bool direct_io = false,
+               bool scratch = false)
+        : path(path), page_size(page_size), scratch(scratch), frames(std::max<size_t>(num_frames, kMinFrames)),
+          hand(0), num_pages(0) {
+        int flags = O_RDWR | O_CREAT | (scratch ? O_TRUNC : 0);
+        fd = direct_io ? open(path.c_str(), flags | O_DIRECT, 0644) : -1;
+        if (fd < 0) fd = open(path.c_str(), flags, 0644);
+        if (fd < 0) Fatal("open");
+        struct stat st;
+        if (fstat(fd, &st) != 0) Fatal("fstat");
+        num_pages = st.st_size / page_size; // 마지막의 잘린 페이지는 버린다
+        page_table.assign(num_pages, -1);
+
+        // 프레임은 한 번에 할당 (O_DIRECT를 위해 페이지 크기로 정렬)
+        memory = static_cast<char*>(::operator new(frames.size() * page_size, std::align_val_t(kAlign)));
+        for (size_t f = 0; f < frames.size(); ++f) {
+            frames[f].data = memory + f * page_size;
+        }
+    }
+
+    // Writes back the dirty pages, or removes the file of a scratch pool
+    ~BufferPool() {
+        if (!scratch) FlushAll();
+        close(fd);
+        if (scratch) unlink(path.c_str());
+        ::operator delete(memory, std::align_val_t(kAlign));
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // Returns the frame holding page 'id' (pinned)
+    char* Pin(PageId id) {
+        int32_t f = page_table[id];
+        if (f >= 0) {
+            stats.hits++;
+        } else {
+            stats.misses++;
+            f = Evict();
+            ReadPage(id, frames[f].data);
+            frames[f].page = id;
+            page_table[id] = f;
+        }
+        Frame& frame = frames[f];
+        frame.pins++;
+        frame.referenced = true;
+        return frame.data;
+    }
+
+    // Releases a pin taken by Pin or NewPage; 'dirty' marks the page for write-back
+    void Unpin(PageId id, bool dirty) {
+        Frame& frame = frames[page_table[id]];
+        frame.pins--;
+        frame.dirty |= dirty;
+    }
+
+    // Appends a zeroed page to the file and returns its frame (pinned, dirty)
+    char* NewPage(PageId* id) {
+        *id = num_pages++;
+        page_table.push_back(-1);
+        stats.misses++;
+        int32_t f = Evict();
+        std::memset(frames[f].data, 0, page_size);
+        frames[f].page = *id;
+        frames[f].pins = 1;
+        frames[f].referenced = true;
+        frames[f].dirty = true;
+        page_table[*id] = f;
+        return frames[f].data;
+    }
+
+    // Writes back every dirty page
+    void FlushAll() {
+        for (Frame& frame : frames) {
+            if (frame.page != kInvalidPage && frame.dirty) {
+                WritePage(frame.page, frame.data);
+                frame.dirty = false;
+            }
+        }
+    }
+
+    // Drops every page (nothing may be pinned) and truncates the file
+    void Clear() {
+        for (Frame& frame : frames) {
+            frame = Frame{frame.data};
+        }
+        page_table.clear();
+        num_pages = 0;
+        if (ftruncate(fd, 0) != 0) Fatal("ftruncate");
+    }
+
+    const Stats& GetStats() const { return stats; }
+    void ResetStats() { stats = Stats(); }
+
+    size_t PageSize() const { return page_size; }
+    size_t NumFrames() const { return frames.size(); }
+    size_t NumPages() const { return num_pages; }
+    bool Scratch() const { return scratch; }
+    size_t MemoryUsage() const { return frames.size() * page_size + page_table.size() * sizeof(int32_t); }
+
+   private:
+    // Enough frames for the pages a tree operation holds pinned at once
+    static constexpr size_t kMinFrames = 8;
+    static constexpr size_t kAlign = 4096;
+
+    struct Frame {
+        char* data;
+        PageId page = kInvalidPage;
+        uint32_t pins = 0;
+        bool referenced = false;
+        bool dirty = false;
+    };
+
+    [[noreturn]] static void Fatal(const char* what) {
+        std::fprintf(stderr, "BufferPool: %s failed: %s\n", what, std::strerror(errno));
+        std::abort();
+    }
+
+    // Picks a frame for a new page with the clock algorithm, writing back its old page if dirty
+    int32_t Evict() {
+        // 핀 된 프레임은 건너뛰고, 참조 비트가 켜진 프레임은 한 번 봐준다 (두 바퀴면 충분)
+        for (size_t step = 0; step < 2 * frames.size() + 1; ++step) {
+            size_t f = hand;
+            hand = (hand + 1) % frames.size();
+            Frame& frame = frames[f];
+            if (frame.pins > 0) continue;
+            if (frame.referenced) {
+                frame.referenced = false;
+                continue;
+            }
+            if (frame.page != kInvalidPage) {
+                if (frame.dirty) WritePage(frame.page, frame.data);
+                page_table[frame.page] = -1;
+            }
+            frame = Frame{frame.data};
+            return static_cast<int32_t>(f);
+        }
+        std::fprintf(stderr, "BufferPool: all %zu frames are pinned\n", frames.size());
+        std::abort();
+    }
+
+    void ReadPage(PageId id, char* data) {
+        stats.reads++;
+        ssize_t n = pread(fd, data, page_size, static_cast<off_t>(id) * page_size);
+        if (n < 0) Fatal("pread");
+        // 아직 한 번도 쓰이지 않은 페이지 (파일 끝 너머)는 0으로 본다
+        if (static_cast<size_t>(n) < page_size) std::memset(data + n, 0, page_size - n);
+    }
+
+    void WritePage(PageId id, const char* data) {
+        stats.writes++;
+        if (pwrite(fd, data, page_size, static_cast<off_t>(id) * page_size) != static_cast<ssize_t>(page_size)) {
+            Fatal("pwrite");
+        }
+    }
+
+    std::string path;
+    int fd;
+    size_t page_size;
+    bool scratch;                   // Truncated on open, removed on destruction
+    char* memory;                   // Backing memory of all frames
+    std::vector<Frame> frames;
+    size_t hand;                    // Clock hand
+    std::vector<int32_t> page_table; // Page id -> frame index (-1 if not cached)
+    size_t num_pages;
+    Stats stats;
+};
+
+#endif  // LAB2_BPLUSTREE_BUFFER_POOL_H_
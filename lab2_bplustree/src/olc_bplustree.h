@@ -0,0 +1,1043 @@
+#ifndef LAB2_BPLUSTREE_OLC_BPLUSTREE_H_
+#define LAB2_BPLUSTREE_OLC_BPLUSTREE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <atomic>
+
+// Concurrent B+ tree with optimistic lock coupling (Leis et al., "The ART of Practical
+// Synchronization", DaMoN 2016).
+//
+// Every node carries a version word: bit 1 = locked, bit 0 = obsolete, the upper bits a
+// counter that every write unlock advances.
+// - Readers never write shared memory. They remember the version of each node they pass,
+//   read its contents and re-check the version before trusting what they read or moving
+//   on to a child. A changed version means a writer got in between: restart from the root.
+// - Writers descend the same way and upgrade to a write lock (CAS on the version they read)
+//   only on the nodes they modify: the leaf for a plain insert or delete, plus the parent
+//   (and a sibling) when a node splits or two leaves merge. Full nodes are split on the
+//   way down, so a split never propagates upwards.
+// - Delete merges an underfull leaf with a sibling under the same parent. Mirroring the
+//   eager splits of Insert, an internal node below the minimum number of children is
+//   merged with a sibling (or borrows a child from it) on the way down, and the root
+//   collapses when it is left with a single child.
+//
+// Taking a lock never blocks (the CAS fails if the node is locked or changed), so there is
+// no lock order to follow and no deadlock; a failed attempt restarts the operation.
+// Node contents are accessed with relaxed atomic loads/stores and a release fence follows
+// every lock acquisition (seqlock style), so optimistic reads are well defined.
+// Nodes unlinked by a merge may still be in use by readers. They are reclaimed with the
+// epoch scheme of ConcurrentSkipList (lab1): every operation pins the global epoch, an
+// unlinked node goes onto the limbo list of the epoch it was retired in, and that list
+// is freed once the epoch has advanced twice, i.e. after every operation that could still
+// hold one of its nodes has finished.
+template<typename Key, size_t NodeBytes = 256>
+class OLCBplustree {
+    static_assert(std::is_trivially_copyable<Key>::value && sizeof(Key) <= 8,
+                  "keys are read optimistically with atomic loads");
+
+   private:
+    struct Node;
+    struct InternalNode;
+    struct LeafNode;
+
+    static constexpr size_t kCacheLineSize = 64;
+    // Space taken by the node header (version, count, is_leaf, retired_next) before the first key
+    static constexpr size_t kHeaderBytes = 24;
+    static constexpr size_t kInternalKeys =
+        (NodeBytes - kHeaderBytes - sizeof(Node*)) / (sizeof(Key) + sizeof(Node*));
+    static constexpr size_t kLeafKeys = (NodeBytes - kHeaderBytes - sizeof(Node*)) / sizeof(Key);
+
+   public:
+    // Largest degree whose nodes fit in NodeBytes (a node holds at most degree - 1 keys).
+    static constexpr int kMaxDegree = static_cast<int>(std::min(kInternalKeys, kLeafKeys) + 1);
+    static_assert(kMaxDegree >= 3, "NodeBytes is too small for a degree 3 node");
+    static constexpr size_t kNodeBytes = NodeBytes;
+
+    // The degree is clamped to [3, kMaxDegree]; by default nodes are filled to their capacity.
+    OLCBplustree(int degree = kMaxDegree);
+    ~OLCBplustree();
+
+    OLCBplustree(const OLCBplustree&) = delete;
+    OLCBplustree& operator=(const OLCBplustree&) = delete;
+
+    // All operations may be called concurrently from any number of threads.
+    void Insert(const Key& key);
+    bool Contains(const Key& key) const;
+    // Batched Contains with the interface of Bplustree::MultiContains. The keys are looked up
+    // in sorted order, but one at a time: each descent has to validate its own versions.
+    void MultiContains(const Key* keys, size_t n, bool* found) const;
+    // Batched Insert with the interface of Bplustree::InsertBatch. The keys are inserted in
+    // sorted order, each with its own descent (consecutive keys mostly hit the same leaf).
+    template<typename Iter>
+    void InsertBatch(Iter begin, Iter end);
+    std::vector<Key> Scan(const Key& key, const int scan_num) const;
+    // Scan into a caller-provided buffer of at least 'scan_num' keys; returns the number copied.
+    size_t Scan(const Key& key, size_t scan_num, Key* out) const;
+    // Up to scan_num keys <= key, largest first. Leaves have no back links (a split could
+    // not update the right neighbour without locking it out of order), so each step to
+    // the left is a fresh descent below the low fence of the leaf just read.
+    std::vector<Key> ReverseScan(const Key& key, const int scan_num) const;
+    bool Delete(const Key& key);
+
+    // Replaces the contents with the sorted, duplicate-free keys in [begin, end), built
+    // bottom-up like Bplustree::BulkLoad. Not thread-safe: no other operation may run.
+    template<typename Iter>
+    void BulkLoad(Iter begin, Iter end, double fill_factor = 1.0);
+
+    // Not thread-safe; for debugging only.
+    void Print() const;
+
+    size_t Size() const { return num_keys.load(std::memory_order_relaxed); }
+    int Degree() const { return degree; }
+
+    // Returns an estimate of the number of bytes used by the nodes, including the ones
+    // that are unlinked but not freed yet (RetiredBytes()).
+    size_t ApproximateMemoryUsage() const {
+        return num_leaves.load(std::memory_order_relaxed) * sizeof(LeafNode) +
+               num_internals.load(std::memory_order_relaxed) * sizeof(InternalNode);
+    }
+    // Bytes of merged-away nodes waiting for the epoch to advance.
+    size_t RetiredBytes() const { return retired_bytes.load(std::memory_order_relaxed); }
+
+   private:
+    static constexpr uint64_t kObsoleteBit = 1;
+    static constexpr uint64_t kLockedBit = 2;
+    static constexpr int kEpochSlots = 64; // Pin counters; threads share them round-robin
+    static constexpr uint64_t kAdvanceInterval = 64; // Retires between attempts to advance the epoch
+
+    struct Node {
+        std::atomic<uint64_t> version;
+        std::atomic<uint16_t> count; // Number of keys in use (an internal node has count + 1 children)
+        const bool is_leaf;
+        Node* retired_next; // Chain of a limbo list (never read by traversals)
+
+        explicit Node(bool leaf) : version(kLockedBit << 1), count(0), is_leaf(leaf), retired_next(nullptr) {}
+
+        LeafNode* as_leaf() { return static_cast<LeafNode*>(this); }
+        const LeafNode* as_leaf() const { return static_cast<const LeafNode*>(this); }
+        InternalNode* as_internal() { return static_cast<InternalNode*>(this); }
+        const InternalNode* as_internal() const { return static_cast<const InternalNode*>(this); }
+    };
+
+    struct alignas(kCacheLineSize) InternalNode : public Node {
+        Key keys[kInternalKeys];
+        Node* children[kInternalKeys + 1];
+        InternalNode() : Node(false) {}
+    };
+
+    struct alignas(kCacheLineSize) LeafNode : public Node {
+        std::atomic<LeafNode*> next; // Right sibling for range scans
+        Key keys[kLeafKeys];
+        LeafNode() : Node(true), next(nullptr) {}
+    };
+
+    // Per-thread-slot number of operations pinned at each epoch (mod 3), one cache line per slot
+    struct alignas(kCacheLineSize) EpochSlot {
+        std::atomic<uint32_t> pinned[3];
+    };
+
+    // Pins the current epoch for the lifetime of an operation
+    class EpochGuard {
+       public:
+        explicit EpochGuard(const OLCBplustree* tree);
+        ~EpochGuard() { counter->fetch_sub(1, std::memory_order_release); }
+        EpochGuard(const EpochGuard&) = delete;
+        EpochGuard& operator=(const EpochGuard&) = delete;
+
+       private:
+        std::atomic<uint32_t>* counter;
+    };
+
+    // Relaxed atomic access to node arrays (read optimistically, written under the node lock)
+    template<typename T>
+    static T Load(const T& slot) {
+        T value;
+        __atomic_load(&slot, &value, __ATOMIC_RELAXED);
+        return value;
+    }
+    template<typename T>
+    static void Store(T& slot, T value) {
+        __atomic_store(&slot, &value, __ATOMIC_RELAXED);
+    }
+
+    // Optimistic read lock: returns the current version, or sets 'restart' if the node is locked or obsolete.
+    static uint64_t ReadLock(const Node* node, bool& restart) {
+        uint64_t version = node->version.load(std::memory_order_acquire);
+        if ((version & (kLockedBit | kObsoleteBit)) != 0) restart = true;
+        return version;
+    }
+    // Sets 'restart' if the node changed since ReadLock returned 'version'.
+    static void Validate(const Node* node, uint64_t version, bool& restart) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (node->version.load(std::memory_order_relaxed) != version) restart = true;
+    }
+    // Turns an optimistic read into a write lock, failing if the node changed in between.
+    static void UpgradeToWriteLock(Node* node, uint64_t version, bool& restart) {
+        if (node->version.compare_exchange_strong(version, version + kLockedBit, std::memory_order_acquire)) {
+            std::atomic_thread_fence(std::memory_order_release);
+        } else {
+            restart = true;
+        }
+    }
+    static void WriteLock(Node* node, bool& restart) {
+        uint64_t version = ReadLock(node, restart);
+        if (!restart) UpgradeToWriteLock(node, version, restart);
+    }
+    static void WriteUnlock(Node* node) { node->version.fetch_add(kLockedBit, std::memory_order_release); }
+    static void WriteUnlockObsolete(Node* node) {
+        node->version.fetch_add(kLockedBit | kObsoleteBit, std::memory_order_release);
+    }
+    // Called before retrying an operation that had to restart
+    static void Backoff() { std::this_thread::yield(); }
+
+    // In-node search over the first 'n' keys (binary search on relaxed loads).
+    // UpperBound: number of keys <= key (child index). LowerBound: number of keys < key.
+    static size_t UpperBound(const Key* keys, size_t n, const Key& key) {
+        size_t lo = 0, hi = n;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (!(key < Load(keys[mid]))) lo = mid + 1; else hi = mid;
+        }
+        return lo;
+    }
+    static size_t LowerBound(const Key* keys, size_t n, const Key& key) {
+        size_t lo = 0, hi = n;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (Load(keys[mid]) < key) lo = mid + 1; else hi = mid;
+        }
+        return lo;
+    }
+
+    // Array helpers for a locked node: shift the first 'count' entries.
+    template<typename T>
+    static void ArrayInsert(T* array, size_t count, size_t pos, const T& value) {
+        for (size_t i = count; i > pos; --i) Store(array[i], Load(array[i - 1]));
+        Store(array[pos], value);
+    }
+    template<typename T>
+    static void ArrayErase(T* array, size_t count, size_t pos) {
+        for (size_t i = pos; i + 1 < count; ++i) Store(array[i], Load(array[i + 1]));
+    }
+    template<typename T>
+    static void ArrayCopy(const T* src, size_t n, T* dst) {
+        for (size_t i = 0; i < n; ++i) Store(dst[i], Load(src[i]));
+    }
+
+    LeafNode* NewLeaf() {
+        num_leaves.fetch_add(1, std::memory_order_relaxed);
+        return new LeafNode();
+    }
+    InternalNode* NewInternal() {
+        num_internals.fetch_add(1, std::memory_order_relaxed);
+        return new InternalNode();
+    }
+    void FreeNode(Node* node) {
+        if (node->is_leaf) {
+            num_leaves.fetch_sub(1, std::memory_order_relaxed);
+            delete node->as_leaf();
+        } else {
+            num_internals.fetch_sub(1, std::memory_order_relaxed);
+            delete node->as_internal();
+        }
+    }
+    static size_t NodeSize(const Node* node) { return node->is_leaf ? sizeof(LeafNode) : sizeof(InternalNode); }
+    static size_t ThreadSlot();
+    // Keeps an unlinked node alive until no operation can still hold it (see EpochGuard)
+    void Retire(Node* node);
+    void TryAdvanceEpoch();
+    void FreeList(Node* node);
+    void DestroyRecursive(Node* node);
+
+    // Descends to the leaf covering 'key' with optimistic lock coupling.
+    // On success the leaf is read-locked at 'version'; otherwise 'restart' is set.
+    const LeafNode* FindLeaf(const Key& key, uint64_t& version, bool& restart) const;
+    // Like FindLeaf, but descends to the leaf holding the largest key <= key (< key if not
+    // 'inclusive'). 'low_fence' receives the separator that bounds the leaf from the left;
+    // 'has_low_fence' is false for the leftmost leaf.
+    const LeafNode* FindLeafBefore(const Key& key, bool inclusive, uint64_t& version, bool& restart,
+                                   Key& low_fence, bool& has_low_fence) const;
+
+    // One attempt of Insert/Delete; set 'restart' when the attempt must be retried.
+    void TryInsert(const Key& key, bool& restart);
+    bool TryDelete(const Key& key, bool& restart);
+    // Merges the underfull internal 'node' (read-locked at 'version') with a sibling under
+    // 'parent' (read-locked at 'parent_version'), or moves one child over from the sibling
+    // if both do not fit in one node. Always sets 'restart': the caller descends again.
+    void FixUnderfull(InternalNode* parent, uint64_t parent_version, InternalNode* node, uint64_t version,
+                      const Key& key, bool& restart);
+
+    // Split helpers (callers hold the write locks of the node and its parent).
+    // The right half moves to a new node whose first key (or separator) is returned in 'separator'.
+    InternalNode* SplitInternal(InternalNode* node, Key& separator);
+    LeafNode* SplitLeaf(LeafNode* leaf, Key& separator);
+    // Links 'right' next to its left sibling: into the locked 'parent', or under a new root.
+    void InsertSplit(InternalNode* parent, Node* left, const Key& separator, Node* right);
+
+    void PrintRecursive(const Node* node, int level) const;
+
+    std::atomic<Node*> root;
+    int degree;
+    std::atomic<size_t> num_keys{0};
+    std::atomic<size_t> num_leaves{0};
+    std::atomic<size_t> num_internals{0};
+    std::atomic<size_t> retired_bytes{0}; // Bytes on the limbo lists
+    std::atomic<uint64_t> retire_count{0}; // Retires so far (paces TryAdvanceEpoch)
+    std::atomic<uint64_t> epoch{0}; // Global epoch
+    std::atomic<Node*> limbo[3]; // Nodes retired in each epoch (mod 3)
+    mutable EpochSlot slots[kEpochSlots];
+};
+
+template<typename Key, size_t NodeBytes>
+OLCBplustree<Key, NodeBytes>::OLCBplustree(int degree)
+    : degree(std::max(3, std::min(degree, kMaxDegree))) {
+    for (std::atomic<Node*>& list : limbo) list.store(nullptr, std::memory_order_relaxed);
+    for (EpochSlot& slot : slots) {
+        for (std::atomic<uint32_t>& pinned : slot.pinned) pinned.store(0, std::memory_order_relaxed);
+    }
+    root.store(NewLeaf(), std::memory_order_relaxed);
+}
+
+// 소멸자: 다른 스레드가 더 이상 접근하지 않는다고 가정
+template<typename Key, size_t NodeBytes>
+OLCBplustree<Key, NodeBytes>::~OLCBplustree() {
+    DestroyRecursive(root.load(std::memory_order_relaxed));
+    for (std::atomic<Node*>& list : limbo) FreeList(list.load(std::memory_order_relaxed));
+}
+
+template<typename Key, size_t NodeBytes>
+void OLCBplustree<Key, NodeBytes>::DestroyRecursive(Node* node) {
+    if (!node->is_leaf) {
+        InternalNode* internal = node->as_internal();
+        for (size_t i = 0; i <= internal->count.load(std::memory_order_relaxed); ++i) {
+            DestroyRecursive(internal->children[i]);
+        }
+    }
+    FreeNode(node);
+}
+
+// Slot of the calling thread (assigned round-robin on first use, shared by all trees)
+template<typename Key, size_t NodeBytes>
+size_t OLCBplustree<Key, NodeBytes>::ThreadSlot() {
+    static std::atomic<size_t> next_slot(0);
+    thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed) % kEpochSlots;
+    return slot;
+}
+
+template<typename Key, size_t NodeBytes>
+OLCBplustree<Key, NodeBytes>::EpochGuard::EpochGuard(const OLCBplustree* tree) {
+    EpochSlot& slot = tree->slots[ThreadSlot()];
+    while (true) {
+        uint64_t e = tree->epoch.load(std::memory_order_seq_cst);
+        counter = &slot.pinned[e % 3];
+        counter->fetch_add(1, std::memory_order_seq_cst);
+        // 카운터를 올리는 사이 epoch가 넘어갔으면 그 epoch는 보호되지 않으므로 다시 시도
+        if (tree->epoch.load(std::memory_order_seq_cst) == e) return;
+        counter->fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+// Push an unlinked node onto the limbo list of the current epoch (Treiber stack)
+template<typename Key, size_t NodeBytes>
+void OLCBplustree<Key, NodeBytes>::Retire(Node* node) {
+    retired_bytes.fetch_add(NodeSize(node), std::memory_order_relaxed);
+    std::atomic<Node*>& list = limbo[epoch.load(std::memory_order_seq_cst) % 3];
+    Node* top = list.load(std::memory_order_relaxed);
+    do {
+        node->retired_next = top;
+    } while (!list.compare_exchange_weak(top, node, std::memory_order_release,
+                                         std::memory_order_relaxed));
+    if (retire_count.fetch_add(1, std::memory_order_relaxed) % kAdvanceInterval == kAdvanceInterval - 1) {
+        TryAdvanceEpoch();
+    }
+}
+
+// Moves the epoch from e to e + 1 if no operation is pinned at e - 1, then frees the
+// nodes retired in e - 1: every operation that could still reach them has finished
+template<typename Key, size_t NodeBytes>
+void OLCBplustree<Key, NodeBytes>::TryAdvanceEpoch() {
+    uint64_t e = epoch.load(std::memory_order_seq_cst);
+    size_t previous = (e + 2) % 3;
+    for (const EpochSlot& slot : slots) {
+        if (slot.pinned[previous].load(std::memory_order_seq_cst) != 0) return;
+    }
+    if (!epoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst)) return;
+    FreeList(limbo[previous].exchange(nullptr, std::memory_order_acquire));
+}
+
+template<typename Key, size_t NodeBytes>
+void OLCBplustree<Key, NodeBytes>::FreeList(Node* node) {
+    while (node != nullptr) {
+        Node* next = node->retired_next;
+        retired_bytes.fetch_sub(NodeSize(node), std::memory_order_relaxed);
+        FreeNode(node);
+        node = next;
+    }
+}
+
+template<typename Key, size_t NodeBytes>
+const typename OLCBplustree<Key, NodeBytes>::LeafNode*
+OLCBplustree<Key, NodeBytes>::FindLeaf(const Key& key, uint64_t& version, bool& restart) const {
+    const Node* node = root.load(std::memory_order_acquire);
+    version = ReadLock(node, restart);
+    // 읽는 사이 루트가 분할되어 바뀌었으면 처음부터
+    if (restart || node != root.load(std::memory_order_acquire)) {
+        restart = true;
+        return nullptr;
+    }
+    while (!node->is_leaf) {
+        const InternalNode* internal = node->as_internal();
+        size_t i = UpperBound(internal->keys, internal->count.load(std::memory_order_relaxed), key);
+        const Node* child = Load(internal->children[i]);
+        Validate(internal, version, restart); // 자식 포인터를 믿기 전에 부모 확인
+        if (restart) return nullptr;
+        uint64_t child_version = ReadLock(child, restart);
+        if (restart) return nullptr;
+        Validate(internal, version, restart);
+        if (restart) return nullptr;
+        node = child;
+        version = child_version;
+    }
+    return node->as_leaf();
+}
+
+template<typename Key, size_t NodeBytes>
+const typename OLCBplustree<Key, NodeBytes>::LeafNode*
+OLCBplustree<Key, NodeBytes>::FindLeafBefore(const Key& key, bool inclusive, uint64_t& version, bool& restart,
+                                             Key& low_fence, bool& has_low_fence) const {
+    has_low_fence = false;
+    const Node* node = root.load(std::memory_order_acquire);
+    version = ReadLock(node, restart);
+    if (restart || node != root.load(std::memory_order_acquire)) {
+        restart = true;
+        return nullptr;
+    }
+    while (!node->is_leaf) {
+        const InternalNode* internal = node->as_internal();
+        size_t n = internal->count.load(std::memory_order_relaxed);
+        // key와 같은 구분 키는 오른쪽 자식을 가리키므로, 미포함이면 왼쪽으로 내려간다
+        size_t i = inclusive ? UpperBound(internal->keys, n, key) : LowerBound(internal->keys, n, key);
+        if (i > 0) {
+            low_fence = Load(internal->keys[i - 1]); // 아래로 갈수록 더 좁은 경계
+            has_low_fence = true;
+        }
+        const Node* child = Load(internal->children[i]);
+        Validate(internal, version, restart);
+        if (restart) return nullptr;
+        uint64_t child_version = ReadLock(child, restart);
+        if (restart) return nullptr;
+        Validate(internal, version, restart);
+        if (restart) return nullptr;
+        node = child;
+        version = child_version;
+    }
+    return node->as_leaf();
+}
+
+template<typename Key, size_t NodeBytes>
+bool OLCBplustree<Key, NodeBytes>::Contains(const Key& key) const {
+    EpochGuard guard(this);
+    while (true) {
+        bool restart = false;
+        uint64_t version;
+        const LeafNode* leaf = FindLeaf(key, version, restart);
+        if (!restart) {
+            size_t n = leaf->count.load(std::memory_order_relaxed);
+            size_t pos = LowerBound(leaf->keys, n, key);
+            bool found = pos < n && Load(leaf->keys[pos]) == key;
+            Validate(leaf, version, restart);
+            if (!restart) return found;
+        }
+        Backoff();
+    }
+}
+
+template<typename Key, size_t NodeBytes>
+void OLCBplustree<Key, NodeBytes>::MultiContains(const Key* keys, size_t n, bool* found) const {
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    for (uint32_t i : order) {
+        found[i] = Contains(keys[i]);
+    }
+}
+
+template<typename Key, size_t NodeBytes>
+template<typename Iter>
+void OLCBplustree<Key, NodeBytes>::InsertBatch(Iter begin, Iter end) {
+    std::vector<Key> batch(begin, end);
+    std::sort(batch.begin(), batch.end());
+    for (const Key& key : batch) {
+        Insert(key);
+    }
+}
+
+template<typename Key, size_t NodeBytes>
+std::vector<Key> OLCBplustree<Key, NodeBytes>::Scan(const Key& key, const int scan_num) const {
+    std::vector<Key> result;
+    if (scan_num <= 0) return result;
+    // scan_num개를 미리 할당하지 않고 트리 크기만큼으로 시작해, 버퍼가 차면 두 배씩 늘려 이어 읽는다
+    const size_t limit = scan_num;
+    result.resize(std::min(limit, std::max(Size(), kLeafKeys)));
+    size_t copied = Scan(key, result.size(), result.data());
+    while (copied == result.size() && copied < limit) {
+        // 마지막 키부터 다시 읽고, 그 키가 아직 있으면 건너뛴다
+        Key last = result[copied - 1];
+        size_t extra = std::min(limit - copied, copied);
+        result.resize(copied + extra + 1);
+        Key* tail = result.data() + copied;
+        size_t n = Scan(last, extra + 1, tail);
+        size_t skip = n > 0 && tail[0] == last ? 1 : 0;
+        n = std::min(n - skip, extra);
+        std::copy(tail + skip, tail + skip + n, tail);
+        copied += n;
+        result.resize(copied);
+        if (n < extra) break; // 끝까지 읽음
+    }
+    result.resize(copied);
+    return result;
+}
+
+template<typename Key, size_t NodeBytes>
+size_t OLCBplustree<Key, NodeBytes>::Scan(const Key& key, size_t scan_num, Key* out) const {
+    EpochGuard guard(this);
+    size_t copied = 0;
+    Key start = key;
+    bool inclusive = true; // 재시작 후에는 마지막으로 가져온 키 다음부터
+
+    while (copied < scan_num) {
+        bool restart = false;
+        uint64_t version;
+        const LeafNode* leaf = FindLeaf(start, version, restart);
+        while (!restart) {
+            // out[copied..]에 복사한 뒤 버전이 그대로일 때만 결과로 확정
+            size_t n = leaf->count.load(std::memory_order_relaxed);
+            size_t pos = inclusive ? LowerBound(leaf->keys, n, start) : UpperBound(leaf->keys, n, start);
+            size_t taken = 0;
+            for (; pos < n && copied + taken < scan_num; ++pos) {
+                out[copied + taken++] = Load(leaf->keys[pos]);
+            }
+            const LeafNode* next = leaf->next.load(std::memory_order_relaxed);
+            Validate(leaf, version, restart);
+            if (restart) break;
+
+            copied += taken;
+            if (taken > 0) {
+                start = out[copied - 1];
+                inclusive = false;
+            }
+            if (copied >= scan_num || next == nullptr) return copied;
+
+            uint64_t next_version = ReadLock(next, restart);
+            if (restart) break;
+            Validate(leaf, version, restart); // next가 여전히 오른쪽 형제인지 확인
+            leaf = next;
+            version = next_version;
+        }
+        Backoff();
+    }
+    return copied;
+}
+
+template<typename Key, size_t NodeBytes>
+std::vector<Key> OLCBplustree<Key, NodeBytes>::ReverseScan(const Key& key, const int scan_num) const {
+    std::vector<Key> result;
+    if (scan_num <= 0) return result;
+    EpochGuard guard(this);
+    Key bound = key;
+    bool inclusive = true; // 처음에만 key 자신을 포함
+    Key buffer[kLeafKeys];
+
+    while (result.size() < static_cast<size_t>(scan_num)) {
+        bool restart = false;
+        uint64_t version;
+        Key low_fence;
+        bool has_low_fence;
+        const LeafNode* leaf = FindLeafBefore(bound, inclusive, version, restart, low_fence, has_low_fence);
+        if (!restart) {
+            size_t n = leaf->count.load(std::memory_order_relaxed);
+            size_t pos = inclusive ? UpperBound(leaf->keys, n, bound) : LowerBound(leaf->keys, n, bound);
+            size_t taken = 0;
+            for (; pos > 0 && result.size() + taken < static_cast<size_t>(scan_num); --pos) {
+                buffer[taken++] = Load(leaf->keys[pos - 1]);
+            }
+            Validate(leaf, version, restart);
+            if (!restart) {
+                result.insert(result.end(), buffer, buffer + taken);
+                // 이 리프의 나머지는 모두 low_fence 이상이므로 그 아래에서 다시 내려간다
+                if (!has_low_fence) return result;
+                bound = low_fence;
+                inclusive = false;
+                continue;
+            }
+        }
+        Backoff();
+    }
+    return result;
+}
+
+template<typename Key, size_t NodeBytes>
+void OLCBplustree<Key, NodeBytes>::Insert(const Key& key) {
+    EpochGuard guard(this);
+    while (true) {
+        bool restart = false;
+        TryInsert(key, restart);
+        if (!restart) return;
+        Backoff();
+    }
+}
+
+template<typename Key, size_t NodeBytes>
+typename OLCBplustree<Key, NodeBytes>::InternalNode*
+OLCBplustree<Key, NodeBytes>::SplitInternal(InternalNode* node, Key& separator) {
+    InternalNode* right = NewInternal();
+    size_t n = node->count.load(std::memory_order_relaxed);
+    size_t mid = n / 2;
+    separator = node->keys[mid];
+    ArrayCopy(node->keys + mid + 1, n - mid - 1, right->keys);
+    ArrayCopy(node->children + mid + 1, n - mid, right->children);
+    right->count.store(n - mid - 1, std::memory_order_relaxed);
+    node->count.store(mid, std::memory_order_relaxed);
+    return right;
+}
+
+template<typename Key, size_t NodeBytes>
+typename OLCBplustree<Key, NodeBytes>::LeafNode*
+OLCBplustree<Key, NodeBytes>::SplitLeaf(LeafNode* leaf, Key& separator) {
+    LeafNode* right = NewLeaf();
+    size_t n = leaf->count.load(std::memory_order_relaxed);
+    size_t mid = n / 2;
+    ArrayCopy(leaf->keys + mid, n - mid, right->keys);
+    right->count.store(n - mid, std::memory_order_relaxed);
+    right->next.store(leaf->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    separator = right->keys[0];
+    leaf->count.store(mid, std::memory_order_relaxed);
+    leaf->next.store(right, std::memory_order_relaxed);
+    return right;
+}
+
+template<typename Key, size_t NodeBytes>
+void OLCBplustree<Key, NodeBytes>::InsertSplit(InternalNode* parent, Node* left, const Key& separator, Node* right) {
+    if (parent == nullptr) {
+        // 루트가 분할됨: 새 루트를 만든다 (이전 루트의 잠금을 풀기 전에 공개)
+        InternalNode* new_root = NewInternal();
+        new_root->keys[0] = separator;
+        new_root->children[0] = left;
+        new_root->children[1] = right;
+        new_root->count.store(1, std::memory_order_relaxed);
+        root.store(new_root, std::memory_order_release);
+        return;
+    }
+    size_t n = parent->count.load(std::memory_order_relaxed);
+    size_t pos = UpperBound(parent->keys, n, separator);
+    ArrayInsert(parent->keys, n, pos, separator);
+    ArrayInsert(parent->children, n + 1, pos + 1, right);
+    parent->count.store(n + 1, std::memory_order_relaxed);
+}
+
+template<typename Key, size_t NodeBytes>
+void OLCBplustree<Key, NodeBytes>::TryInsert(const Key& key, bool& restart) {
+    Node* node = root.load(std::memory_order_acquire);
+    uint64_t version = ReadLock(node, restart);
+    if (restart || node != root.load(std::memory_order_acquire)) {
+        restart = true;
+        return;
+    }
+    InternalNode* parent = nullptr;
+    uint64_t parent_version = 0;
+
+    while (!node->is_leaf) {
+        InternalNode* internal = node->as_internal();
+        // 가득 찬 내부 노드는 내려가는 길에 미리 분할한다 (분할이 위로 전파되지 않도록)
+        if (internal->count.load(std::memory_order_relaxed) == degree - 1) {
+            if (parent != nullptr) {
+                UpgradeToWriteLock(parent, parent_version, restart);
+                if (restart) return;
+            }
+            UpgradeToWriteLock(internal, version, restart);
+            if (restart) {
+                if (parent != nullptr) WriteUnlock(parent);
+                return;
+            }
+            if (parent == nullptr && internal != root.load(std::memory_order_relaxed)) {
+                WriteUnlock(internal); // 그 사이 새 루트가 생김
+                restart = true;
+                return;
+            }
+            Key separator;
+            InternalNode* right = SplitInternal(internal, separator);
+            InsertSplit(parent, internal, separator, right);
+            WriteUnlock(internal);
+            if (parent != nullptr) WriteUnlock(parent);
+            restart = true; // 분할 후 다시 내려간다
+            return;
+        }
+        if (parent != nullptr) {
+            Validate(parent, parent_version, restart);
+            if (restart) return;
+        }
+        parent = internal;
+        parent_version = version;
+
+        node = Load(internal->children[UpperBound(internal->keys, internal->count.load(std::memory_order_relaxed), key)]);
+        Validate(internal, version, restart);
+        if (restart) return;
+        version = ReadLock(node, restart);
+        if (restart) return;
+    }
+
+    LeafNode* leaf = node->as_leaf();
+    size_t n = leaf->count.load(std::memory_order_relaxed);
+    size_t pos = LowerBound(leaf->keys, n, key);
+    if (pos < n && Load(leaf->keys[pos]) == key) {
+        // 이미 있는 키: 잠그지 않고 확인만
+        Validate(leaf, version, restart);
+        return;
+    }
+
+    if (n == static_cast<size_t>(degree - 1)) {
+        // 가득 찬 리프: 부모와 함께 잠그고 분할한 뒤 다시 시도
+        if (parent != nullptr) {
+            UpgradeToWriteLock(parent, parent_version, restart);
+            if (restart) return;
+        }
+        UpgradeToWriteLock(leaf, version, restart);
+        if (restart) {
+            if (parent != nullptr) WriteUnlock(parent);
+            return;
+        }
+        if (parent == nullptr && leaf != root.load(std::memory_order_relaxed)) {
+            WriteUnlock(leaf);
+            restart = true;
+            return;
+        }
+        Key separator;
+        LeafNode* right = SplitLeaf(leaf, separator);
+        InsertSplit(parent, leaf, separator, right);
+        WriteUnlock(leaf);
+        if (parent != nullptr) WriteUnlock(parent);
+        restart = true;
+        return;
+    }
+
+    // 리프만 잠그고 삽입
+    UpgradeToWriteLock(leaf, version, restart);
+    if (restart) return;
+    if (parent != nullptr) {
+        Validate(parent, parent_version, restart);
+        if (restart) {
+            WriteUnlock(leaf);
+            return;
+        }
+    }
+    ArrayInsert(leaf->keys, n, pos, key);
+    leaf->count.store(n + 1, std::memory_order_relaxed);
+    num_keys.fetch_add(1, std::memory_order_relaxed);
+    WriteUnlock(leaf);
+}
+
+template<typename Key, size_t NodeBytes>
+bool OLCBplustree<Key, NodeBytes>::Delete(const Key& key) {
+    EpochGuard guard(this);
+    while (true) {
+        bool restart = false;
+        bool deleted = TryDelete(key, restart);
+        if (!restart) return deleted;
+        Backoff();
+    }
+}
+
+template<typename Key, size_t NodeBytes>
+bool OLCBplustree<Key, NodeBytes>::TryDelete(const Key& key, bool& restart) {
+    Node* node = root.load(std::memory_order_acquire);
+    uint64_t version = ReadLock(node, restart);
+    if (restart || node != root.load(std::memory_order_acquire)) {
+        restart = true;
+        return false;
+    }
+    InternalNode* parent = nullptr;
+    uint64_t parent_version = 0;
+    const size_t min_children = (degree + 1) / 2;
+
+    while (!node->is_leaf) {
+        InternalNode* internal = node->as_internal();
+        // 최소 자식 수 미만인 내부 노드는 내려가는 길에 고친다 (Insert의 미리 분할과 대칭)
+        if (parent != nullptr && static_cast<size_t>(internal->count.load(std::memory_order_relaxed)) + 1 < min_children) {
+            FixUnderfull(parent, parent_version, internal, version, key, restart);
+            return false;
+        }
+        if (parent != nullptr) {
+            Validate(parent, parent_version, restart);
+            if (restart) return false;
+        }
+        parent = internal;
+        parent_version = version;
+
+        node = Load(internal->children[UpperBound(internal->keys, internal->count.load(std::memory_order_relaxed), key)]);
+        Validate(internal, version, restart);
+        if (restart) return false;
+        version = ReadLock(node, restart);
+        if (restart) return false;
+    }
+
+    LeafNode* leaf = node->as_leaf();
+    size_t n = leaf->count.load(std::memory_order_relaxed);
+    size_t pos = LowerBound(leaf->keys, n, key);
+    if (pos == n || Load(leaf->keys[pos]) != key) {
+        Validate(leaf, version, restart);
+        return false;
+    }
+
+    const size_t min_keys = (degree - 1) / 2;
+    if (parent == nullptr || n - 1 >= min_keys) {
+        // 리프만 잠그고 삭제
+        UpgradeToWriteLock(leaf, version, restart);
+        if (restart) return false;
+        ArrayErase(leaf->keys, n, pos);
+        leaf->count.store(n - 1, std::memory_order_relaxed);
+        num_keys.fetch_sub(1, std::memory_order_relaxed);
+        WriteUnlock(leaf);
+        return true;
+    }
+
+    // 최소 키 수 미만이 된다: 부모, 리프, 형제 순으로 잠그고 삭제 후 병합 시도
+    UpgradeToWriteLock(parent, parent_version, restart);
+    if (restart) return false;
+    UpgradeToWriteLock(leaf, version, restart);
+    if (restart) {
+        WriteUnlock(parent);
+        return false;
+    }
+    size_t parent_count = parent->count.load(std::memory_order_relaxed);
+    size_t index = UpperBound(parent->keys, parent_count, key);
+    LeafNode* sibling = nullptr;
+    if (parent_count > 0) {
+        sibling = (index < parent_count ? parent->children[index + 1] : parent->children[index - 1])->as_leaf();
+        WriteLock(sibling, restart);
+        if (restart) {
+            WriteUnlock(leaf);
+            WriteUnlock(parent);
+            return false;
+        }
+    }
+
+    ArrayErase(leaf->keys, n, pos);
+    leaf->count.store(n - 1, std::memory_order_relaxed);
+    num_keys.fetch_sub(1, std::memory_order_relaxed);
+
+    if (sibling == nullptr) {
+        WriteUnlock(leaf);
+        WriteUnlock(parent);
+        return true;
+    }
+
+    // 항상 오른쪽 노드를 왼쪽 노드로 합친다
+    LeafNode* left = index < parent_count ? leaf : sibling;
+    LeafNode* right = index < parent_count ? sibling : leaf;
+    size_t right_index = index < parent_count ? index + 1 : index;
+    size_t left_count = left->count.load(std::memory_order_relaxed);
+    size_t right_count = right->count.load(std::memory_order_relaxed);
+    if (left_count + right_count > static_cast<size_t>(degree - 1)) {
+        WriteUnlock(sibling); // 합치면 넘친다: 그대로 둔다
+        WriteUnlock(leaf);
+        WriteUnlock(parent);
+        return true;
+    }
+    ArrayCopy(right->keys, right_count, left->keys + left_count);
+    left->count.store(left_count + right_count, std::memory_order_relaxed);
+    left->next.store(right->next.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    ArrayErase(parent->children, parent_count + 1, right_index);
+    ArrayErase(parent->keys, parent_count, right_index - 1);
+    parent->count.store(parent_count - 1, std::memory_order_relaxed);
+
+    WriteUnlock(left);
+    WriteUnlockObsolete(right);
+    Retire(right);
+
+    // 자식이 하나만 남은 루트는 축소
+    if (parent_count == 1 && parent == root.load(std::memory_order_relaxed)) {
+        root.store(left, std::memory_order_release);
+        WriteUnlockObsolete(parent);
+        Retire(parent);
+    } else {
+        WriteUnlock(parent);
+    }
+    return true;
+}
+
+template<typename Key, size_t NodeBytes>
+void OLCBplustree<Key, NodeBytes>::FixUnderfull(InternalNode* parent, uint64_t parent_version, InternalNode* node,
+                                                uint64_t version, const Key& key, bool& restart) {
+    UpgradeToWriteLock(parent, parent_version, restart);
+    if (restart) return;
+    UpgradeToWriteLock(node, version, restart);
+    if (restart) {
+        WriteUnlock(parent);
+        return;
+    }
+    restart = true;
+    size_t parent_count = parent->count.load(std::memory_order_relaxed);
+    if (parent_count == 0) {
+        // 형제가 없다: 부모가 루트면 축소하고, 아니면 부모가 먼저 고쳐지도록 다시 내려간다
+        if (parent == root.load(std::memory_order_relaxed)) {
+            root.store(node, std::memory_order_release);
+            WriteUnlock(node);
+            WriteUnlockObsolete(parent);
+            Retire(parent);
+        } else {
+            WriteUnlock(node);
+            WriteUnlock(parent);
+        }
+        return;
+    }
+    size_t index = UpperBound(parent->keys, parent_count, key); // parent->children[index] == node
+    InternalNode* sibling = Load(parent->children[index < parent_count ? index + 1 : index - 1])->as_internal();
+    bool sibling_restart = false;
+    WriteLock(sibling, sibling_restart);
+    if (sibling_restart) {
+        WriteUnlock(node);
+        WriteUnlock(parent);
+        return;
+    }
+
+    InternalNode* left = index < parent_count ? node : sibling;
+    InternalNode* right = index < parent_count ? sibling : node;
+    size_t separator = index < parent_count ? index : index - 1; // parent->keys에서 left와 right 사이의 키
+    size_t left_count = left->count.load(std::memory_order_relaxed);
+    size_t right_count = right->count.load(std::memory_order_relaxed);
+
+    if (left_count + right_count + 2 <= static_cast<size_t>(degree)) {
+        // 합친다: 구분 키를 내려 보내고 오른쪽 노드를 왼쪽 노드 뒤에 붙인다
+        Store(left->keys[left_count], Load(parent->keys[separator]));
+        ArrayCopy(right->keys, right_count, left->keys + left_count + 1);
+        ArrayCopy(right->children, right_count + 1, left->children + left_count + 1);
+        left->count.store(left_count + right_count + 1, std::memory_order_relaxed);
+        ArrayErase(parent->children, parent_count + 1, separator + 1);
+        ArrayErase(parent->keys, parent_count, separator);
+        parent->count.store(parent_count - 1, std::memory_order_relaxed);
+        WriteUnlock(left);
+        WriteUnlockObsolete(right);
+        Retire(right);
+        if (parent_count == 1 && parent == root.load(std::memory_order_relaxed)) {
+            root.store(left, std::memory_order_release);
+            WriteUnlockObsolete(parent);
+            Retire(parent);
+        } else {
+            WriteUnlock(parent);
+        }
+        return;
+    }
+
+    // 합치면 넘친다: 형제에서 자식 하나를 부모의 구분 키를 거쳐 옮겨 온다
+    if (node == left) {
+        Store(left->keys[left_count], Load(parent->keys[separator]));
+        Store(left->children[left_count + 1], Load(right->children[0]));
+        left->count.store(left_count + 1, std::memory_order_relaxed);
+        Store(parent->keys[separator], Load(right->keys[0]));
+        ArrayErase(right->keys, right_count, 0);
+        ArrayErase(right->children, right_count + 1, 0);
+        right->count.store(right_count - 1, std::memory_order_relaxed);
+    } else {
+        ArrayInsert(right->keys, right_count, 0, Load(parent->keys[separator]));
+        ArrayInsert(right->children, right_count + 1, 0, Load(left->children[left_count]));
+        right->count.store(right_count + 1, std::memory_order_relaxed);
+        Store(parent->keys[separator], Load(left->keys[left_count - 1]));
+        left->count.store(left_count - 1, std::memory_order_relaxed);
+    }
+    WriteUnlock(sibling);
+    WriteUnlock(node);
+    WriteUnlock(parent);
+}
+
+// BulkLoad: 동시 접근이 없다고 가정하고 Bplustree::BulkLoad와 같은 방식으로 쌓는다
+template<typename Key, size_t NodeBytes>
+template<typename Iter>
+void OLCBplustree<Key, NodeBytes>::BulkLoad(Iter begin, Iter end, double fill_factor) {
+    DestroyRecursive(root.load(std::memory_order_relaxed));
+    fill_factor = std::min(1.0, std::max(0.0, fill_factor));
+
+    const size_t n = std::distance(begin, end);
+    num_keys.store(n, std::memory_order_relaxed);
+
+    size_t leaf_fill = std::max<long>(1, std::lround(fill_factor * (degree - 1)));
+    size_t leaves = std::max<size_t>(1, (n + leaf_fill - 1) / leaf_fill);
+
+    std::vector<Node*> level;
+    std::vector<Key> low_keys;
+    level.reserve(leaves);
+    low_keys.reserve(leaves);
+
+    LeafNode* prev = nullptr;
+    for (size_t l = 0; l < leaves; ++l) {
+        size_t count = n / leaves + (l < n % leaves ? 1 : 0);
+        LeafNode* leaf = NewLeaf();
+        for (size_t j = 0; j < count; ++j, ++begin) {
+            leaf->keys[j] = *begin;
+        }
+        leaf->count.store(count, std::memory_order_relaxed);
+        if (prev != nullptr) prev->next.store(leaf, std::memory_order_relaxed);
+        prev = leaf;
+        level.push_back(leaf);
+        low_keys.push_back(count > 0 ? leaf->keys[0] : Key());
+    }
+
+    size_t child_fill = std::min<long>(degree, std::max<long>(3, std::lround(fill_factor * degree)));
+    while (level.size() > 1) {
+        size_t m = level.size();
+        size_t parents = (m + child_fill - 1) / child_fill;
+        size_t in = 0;
+        for (size_t p = 0; p < parents; ++p) {
+            size_t children = m / parents + (p < m % parents ? 1 : 0);
+            InternalNode* internal = NewInternal();
+            Key low = low_keys[in];
+            for (size_t j = 0; j < children; ++j, ++in) {
+                internal->children[j] = level[in];
+                if (j > 0) internal->keys[j - 1] = low_keys[in];
+            }
+            internal->count.store(children - 1, std::memory_order_relaxed);
+            level[p] = internal;
+            low_keys[p] = low;
+        }
+        level.resize(parents);
+        low_keys.resize(parents);
+    }
+    root.store(level[0], std::memory_order_release);
+}
+
+template<typename Key, size_t NodeBytes>
+void OLCBplustree<Key, NodeBytes>::Print() const {
+    PrintRecursive(root.load(std::memory_order_acquire), 0);
+}
+
+template<typename Key, size_t NodeBytes>
+void OLCBplustree<Key, NodeBytes>::PrintRecursive(const Node* node, int level) const {
+    for (int i = 0; i < level; ++i)
+        std::cout << "  ";
+    size_t n = node->count.load(std::memory_order_relaxed);
+    if (node->is_leaf) {
+        std::cout << "[Leaf] ";
+        for (size_t i = 0; i < n; ++i)
+            std::cout << node->as_leaf()->keys[i] << " ";
+        std::cout << std::endl;
+    } else {
+        const InternalNode* internal = node->as_internal();
+        std::cout << "[Internal] ";
+        for (size_t i = 0; i < n; ++i)
+            std::cout << internal->keys[i] << " ";
+        std::cout << std::endl;
+        for (size_t i = 0; i <= n; ++i)
+            PrintRecursive(internal->children[i], level + 1);
+    }
+}
+
+#endif  // LAB2_BPLUSTREE_OLC_BPLUSTREE_H_
@@ -0,0 +1,679 @@
+#ifndef LAB2_BPLUSTREE_PAGED_BPLUSTREE_H_
+#define LAB2_BPLUSTREE_PAGED_BPLUSTREE_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "buffer_pool.h"
+#include "simd_search.h"
+
+// Disk-backed B+ Tree (set of keys) for indexes larger than memory.
+//
+// Nodes are PageBytes-sized pages of a file, addressed by PageId instead of
+// Node*, and are only reached through a BufferPool: an operation pins the page
+// it is reading, copies out what it needs (the next child id, the keys of a
+// scan) and unpins it before moving on, so only a handful of pages are pinned
+// at any time and the pool can be far smaller than the tree. Inserts remember
+// the page ids of the path instead of parent pointers, and re-pin the parents
+// only when a split has to be propagated.
+//
+// The layout, split and merge rules follow Bplustree: a delete that leaves a
+// page below half full merges it with a sibling, or evens the two out, on the
+// way back up the path. Pages freed by merges (and by a shrinking root) go onto
+// a free list chained through their headers, and new pages reuse them before
+// the file grows.
+//
+// Page 0 of the file is a header with the root, the page count, the degree, the
+// free list and the number of keys. It is written when the tree is destroyed,
+// after which the pool writes back every dirty page, so opening the same file
+// again restores the tree. A scratch tree instead starts from an empty file and
+// removes it (see BufferPool).
+//
+// Not thread-safe.
+template<typename Key, size_t PageBytes = 4096>
+class PagedBplustree {
+   private:
+    static_assert(std::is_trivially_copyable<Key>::value, "keys are copied to and from pages as bytes");
+
+    // Header at the start of every page. next/prev link the leaves (unused in internal pages).
+    struct PageHeader {
+        uint8_t is_leaf;
+        uint16_t count; // Number of keys in use (an internal page has count + 1 children)
+        PageId next;
+        PageId prev;
+    };
+
+    static constexpr size_t kHeaderBytes = (sizeof(PageHeader) + alignof(Key) - 1) / alignof(Key) * alignof(Key);
+    static constexpr size_t kLeafKeys = (PageBytes - kHeaderBytes) / sizeof(Key);
+    static constexpr size_t kInternalKeys = (PageBytes - kHeaderBytes - sizeof(PageId)) / (sizeof(Key) + sizeof(PageId));
+
+    struct LeafPage : PageHeader {
+        Key keys[kLeafKeys];
+    };
+    struct InternalPage : PageHeader {
+        Key keys[kInternalKeys];
+        PageId children[kInternalKeys + 1];
+    };
+
+    static constexpr uint64_t kFileMagic = 0x3145474150544250ULL; // "PBTPAGE1"
+    static constexpr PageId kFileHeaderPage = 0;
+    struct FileHeader {
+        uint64_t magic;
+        uint32_t page_bytes;
+        uint32_t key_bytes;
+        uint32_t degree;
+        PageId root;
+        PageId num_pages;
+        PageId free_list;
+        uint64_t num_free_pages;
+        uint64_t num_keys;
+    };
+    static_assert(sizeof(FileHeader) <= PageBytes, "file header exceeds PageBytes");
+
+   public:
+    // Pages overflow to 'degree' keys before they split
+    static constexpr int kMaxDegree = static_cast<int>(std::min(kInternalKeys, kLeafKeys));
+    static_assert(kMaxDegree >= 3, "PageBytes is too small for a degree 3 page");
+    static_assert(sizeof(LeafPage) <= PageBytes && sizeof(InternalPage) <= PageBytes, "page exceeds PageBytes");
+    static constexpr size_t kNodeBytes = PageBytes;
+
+    // Opens the tree in the page file 'path', cached by a pool of 'pool_pages' frames. An
+    // empty (or 'scratch') file starts an empty tree with the degree clamped to
+    // [3, kMaxDegree]; otherwise the tree and its degree come from the file header, and a
+    // file written by a different tree type is fatal. 'direct_io' opens it with O_DIRECT.
+    PagedBplustree(const std::string& path, size_t pool_pages, int degree = kMaxDegree, bool direct_io = false,
+                   bool scratch = false);
+    // Writes the file header; the pool then writes back the dirty pages
+    ~PagedBplustree();
+
+    PagedBplustree(const PagedBplustree&) = delete;
+    PagedBplustree& operator=(const PagedBplustree&) = delete;
+
+    void Insert(const Key& key);
+    bool Contains(const Key& key);
+    bool Delete(const Key& key);
+
+    // Up to scan_num keys >= key, in order (the buffer version returns the number copied).
+    std::vector<Key> Scan(const Key& key, const int scan_num);
+    size_t Scan(const Key& key, size_t scan_num, Key* out);
+    // Up to scan_num keys <= key, largest first, following the prev links.
+    std::vector<Key> ReverseScan(const Key& key, const int scan_num);
+
+    // Batched interfaces of Bplustree. The keys are processed in sorted order so that
+    // neighbouring keys find their pages still in the pool, but one at a time.
+    void MultiContains(const Key* keys, size_t n, bool* found);
+    template<typename Iter>
+    void InsertBatch(Iter begin, Iter end);
+
+    // Replaces the contents with the sorted, duplicate-free keys in [begin, end), built
+    // bottom-up like Bplustree::BulkLoad. The leaves are written to consecutive pages.
+    template<typename Iter>
+    void BulkLoad(Iter begin, Iter end, double fill_factor = 1.0);
+
+    void Print();
+
+    size_t Size() const { return num_keys; }
+    int Degree() const { return degree; }
+    // Memory held by the buffer pool (the tree itself lives in the page file)
+    size_t ApproximateMemoryUsage() const { return pool.MemoryUsage(); }
+    // Bytes of the page file (header page included), and the part of it on the free list
+    size_t FileBytes() const { return pool.NumPages() * PageBytes; }
+    size_t FreeBytes() const { return num_free_pages * PageBytes; }
+
+    BufferPool& Pool() { return pool; }
+
+   private:
+    static LeafPage* AsLeaf(char* page) { return reinterpret_cast<LeafPage*>(page); }
+    static InternalPage* AsInternal(char* page) { return reinterpret_cast<InternalPage*>(page); }
+
+    // Allocates a page (pinned), reusing a free one if there is any, and initializes its header
+    char* NewPage(bool leaf, PageId* id) {
+        char* page;
+        if (free_list != kInvalidPage) {
+            *id = free_list;
+            page = pool.Pin(*id);
+            free_list = reinterpret_cast<PageHeader*>(page)->next;
+            num_free_pages--;
+            std::memset(page, 0, PageBytes);
+        } else {
+            page = pool.NewPage(id);
+        }
+        PageHeader* header = reinterpret_cast<PageHeader*>(page);
+        header->is_leaf = leaf;
+        header->count = 0;
+        header->next = kInvalidPage;
+        header->prev = kInvalidPage;
+        return page;
+    }
+    // Puts the pinned page 'id' on the free list and unpins it
+    void FreePage(PageId id, char* page) {
+        reinterpret_cast<PageHeader*>(page)->next = free_list;
+        free_list = id;
+        num_free_pages++;
+        pool.Unpin(id, true);
+    }
+
+    // Descends to the leaf that covers 'key' and returns it pinned. The ids of the
+    // internal pages on the way are appended to 'path' if it is not null.
+    LeafPage* FindLeaf(const Key& key, PageId* leaf_id, std::vector<PageId>* path);
+
+    // Adds separator 'key' with right child 'right' next to 'left' in the parent at the end
+    // of 'path', splitting parents (and growing a new root) as needed.
+    void InsertIntoParent(std::vector<PageId>& path, PageId left, Key key, PageId right);
+
+    // Merges children[i] of the parent page with a sibling, or evens the two out if they do
+    // not fit in one page (Bplustree::FixChild on pages). The parent is pinned by the caller.
+    void FixChild(InternalPage* parent, size_t i);
+    // Replaces an internal root with a single child by that child (repeatedly)
+    void ShrinkRoot();
+    // Minimum fill of a page, as in Bplustree::Underfull (strict mode)
+    bool Underfull(const PageHeader* page) const {
+        if (page->is_leaf) return page->count < degree / 2;
+        return page->count + 1 < (degree + 1) / 2;
+    }
+
+    void WriteFileHeader();
+    void ReadFileHeader(const std::string& path);
+
+    void PrintRecursive(PageId id, int level);
+
+    template<typename T>
+    static void ArrayInsert(T* array, size_t count, size_t pos, const T& value) {
+        std::copy_backward(array + pos, array + count, array + count + 1);
+        array[pos] = value;
+    }
+    template<typename T>
+    static void ArrayErase(T* array, size_t count, size_t pos) {
+        std::copy(array + pos + 1, array + count, array + pos);
+    }
+
+    BufferPool pool;
+    PageId root;
+    int degree;
+    size_t num_keys = 0;
+    PageId free_list = kInvalidPage; // Freed pages, chained through PageHeader::next
+    size_t num_free_pages = 0;
+    std::vector<PageId> search_path; // Scratch search path of Insert/Delete (kept to avoid an allocation per call)
+};
+
+template<typename Key, size_t PageBytes>
+PagedBplustree<Key, PageBytes>::PagedBplustree(const std::string& path, size_t pool_pages, int degree, bool direct_io,
+                                               bool scratch)
+    : pool(path, PageBytes, pool_pages, direct_io, scratch), degree(std::max(3, std::min(degree, kMaxDegree))) {
+    if (pool.NumPages() > 0) {
+        ReadFileHeader(path);
+        return;
+    }
+    PageId header;
+    pool.NewPage(&header); // 헤더는 항상 0번 페이지
+    pool.Unpin(header, true);
+    NewPage(true, &root);
+    pool.Unpin(root, true);
+}
+
+template<typename Key, size_t PageBytes>
+PagedBplustree<Key, PageBytes>::~PagedBplustree() {
+    if (!pool.Scratch()) WriteFileHeader();
+}
+
+template<typename Key, size_t PageBytes>
+void PagedBplustree<Key, PageBytes>::WriteFileHeader() {
+    FileHeader header{kFileMagic, PageBytes, sizeof(Key), static_cast<uint32_t>(degree), root,
+                      static_cast<PageId>(pool.NumPages()), free_list, num_free_pages, num_keys};
+    std::memcpy(pool.Pin(kFileHeaderPage), &header, sizeof(header));
+    pool.Unpin(kFileHeaderPage, true);
+}
+
+template<typename Key, size_t PageBytes>
+void PagedBplustree<Key, PageBytes>::ReadFileHeader(const std::string& path) {
+    FileHeader header;
+    std::memcpy(&header, pool.Pin(kFileHeaderPage), sizeof(header));
+    pool.Unpin(kFileHeaderPage, false);
+    const char* error = nullptr;
+    if (header.magic != kFileMagic) {
+        error = "is not a page file";
+    } else if (header.page_bytes != PageBytes || header.key_bytes != sizeof(Key)) {
+        error = "has a different page or key size";
+    } else if (header.num_pages != pool.NumPages() || header.degree < 3 ||
+               header.degree > static_cast<uint32_t>(kMaxDegree)) {
+        error = "is truncated or corrupted";
+    }
+    if (error != nullptr) {
+        std::fprintf(stderr, "PagedBplustree: %s %s\n", path.c_str(), error);
+        std::abort();
+    }
+    degree = static_cast<int>(header.degree);
+    root = header.root;
+    free_list = header.free_list;
+    num_free_pages = header.num_free_pages;
+    num_keys = header.num_keys;
+}
+
+template<typename Key, size_t PageBytes>
+typename PagedBplustree<Key, PageBytes>::LeafPage*
+PagedBplustree<Key, PageBytes>::FindLeaf(const Key& key, PageId* leaf_id, std::vector<PageId>* path) {
+    PageId id = root;
+    for (;;) {
+        char* page = pool.Pin(id);
+        if (AsLeaf(page)->is_leaf) {
+            *leaf_id = id;
+            return AsLeaf(page);
+        }
+        // 자식 id만 읽고 바로 unpin (한 번에 한 페이지만 핀)
+        InternalPage* internal = AsInternal(page);
+        PageId child = internal->children[simd_search::UpperBound(internal->keys, internal->count, key)];
+        if (path != nullptr) path->push_back(id);
+        pool.Unpin(id, false);
+        id = child;
+    }
+}
+
+template<typename Key, size_t PageBytes>
+void PagedBplustree<Key, PageBytes>::Insert(const Key& key) {
+    search_path.clear();
+    PageId leaf_id;
+    LeafPage* leaf = FindLeaf(key, &leaf_id, &search_path);
+    size_t pos = simd_search::LowerBound(leaf->keys, leaf->count, key);
+    if (pos < leaf->count && leaf->keys[pos] == key) { // 중복이면 삽입하지 않음
+        pool.Unpin(leaf_id, false);
+        return;
+    }
+
+    ArrayInsert(leaf->keys, leaf->count, pos, key);
+    leaf->count++;
+    num_keys++;
+    if (leaf->count < degree) {
+        pool.Unpin(leaf_id, true);
+        return;
+    }
+
+    // 리프 분할: 오른쪽 절반을 새 페이지로
+    PageId right_id;
+    LeafPage* right = AsLeaf(NewPage(true, &right_id));
+    size_t mid = leaf->count / 2;
+    std::copy(leaf->keys + mid, leaf->keys + leaf->count, right->keys);
+    right->count = leaf->count - mid;
+    leaf->count = mid;
+
+    right->next = leaf->next;
+    right->prev = leaf_id;
+    leaf->next = right_id;
+    if (right->next != kInvalidPage) {
+        AsLeaf(pool.Pin(right->next))->prev = right_id;
+        pool.Unpin(right->next, true);
+    }
+    Key separator = right->keys[0];
+    pool.Unpin(leaf_id, true);
+    pool.Unpin(right_id, true);
+
+    InsertIntoParent(search_path, leaf_id, separator, right_id);
+}
+
+template<typename Key, size_t PageBytes>
+void PagedBplustree<Key, PageBytes>::InsertIntoParent(std::vector<PageId>& path, PageId left, Key key, PageId right) {
+    while (!path.empty()) {
+        PageId parent_id = path.back();
+        path.pop_back();
+        InternalPage* parent = AsInternal(pool.Pin(parent_id));
+        size_t i = simd_search::UpperBound(parent->keys, parent->count, key);
+        ArrayInsert(parent->keys, parent->count, i, key);
+        ArrayInsert(parent->children, parent->count + 1, i + 1, right);
+        parent->count++;
+        if (parent->count < degree) {
+            pool.Unpin(parent_id, true);
+            return;
+        }
+
+        // 내부 페이지 분할: 가운데 키는 위로 올라간다
+        PageId sibling_id;
+        InternalPage* sibling = AsInternal(NewPage(false, &sibling_id));
+        size_t mid = parent->count / 2;
+        key = parent->keys[mid];
+        std::copy(parent->keys + mid + 1, parent->keys + parent->count, sibling->keys);
+        std::copy(parent->children + mid + 1, parent->children + parent->count + 1, sibling->children);
+        sibling->count = parent->count - mid - 1;
+        parent->count = mid;
+        pool.Unpin(parent_id, true);
+        pool.Unpin(sibling_id, true);
+        left = parent_id;
+        right = sibling_id;
+    }
+
+    // 루트가 분할되었으면 새 루트
+    PageId root_id;
+    InternalPage* new_root = AsInternal(NewPage(false, &root_id));
+    new_root->keys[0] = key;
+    new_root->children[0] = left;
+    new_root->children[1] = right;
+    new_root->count = 1;
+    pool.Unpin(root_id, true);
+    root = root_id;
+}
+
+template<typename Key, size_t PageBytes>
+bool PagedBplustree<Key, PageBytes>::Contains(const Key& key) {
+    PageId leaf_id;
+    LeafPage* leaf = FindLeaf(key, &leaf_id, nullptr);
+    size_t pos = simd_search::LowerBound(leaf->keys, leaf->count, key);
+    bool found = pos < leaf->count && leaf->keys[pos] == key;
+    pool.Unpin(leaf_id, false);
+    return found;
+}
+
+template<typename Key, size_t PageBytes>
+bool PagedBplustree<Key, PageBytes>::Delete(const Key& key) {
+    search_path.clear();
+    PageId leaf_id;
+    LeafPage* leaf = FindLeaf(key, &leaf_id, &search_path);
+    size_t pos = simd_search::LowerBound(leaf->keys, leaf->count, key);
+    if (pos == leaf->count || leaf->keys[pos] != key) {
+        pool.Unpin(leaf_id, false);
+        return false;
+    }
+    ArrayErase(leaf->keys, leaf->count, pos);
+    leaf->count--;
+    num_keys--;
+    bool underflow = Underfull(leaf);
+    pool.Unpin(leaf_id, true);
+
+    // 경로를 거슬러 올라가며 부족해진 자식을 부모가 고친다 (루트 리프는 비어 있어도 그대로)
+    while (underflow && !search_path.empty()) {
+        PageId parent_id = search_path.back();
+        search_path.pop_back();
+        InternalPage* parent = AsInternal(pool.Pin(parent_id));
+        FixChild(parent, simd_search::UpperBound(parent->keys, parent->count, key));
+        underflow = Underfull(parent);
+        pool.Unpin(parent_id, true);
+    }
+    ShrinkRoot();
+    return true;
+}
+
+template<typename Key, size_t PageBytes>
+void PagedBplustree<Key, PageBytes>::FixChild(InternalPage* parent, size_t i) {
+    if (parent->count == 0) return; // 형제가 없으면 부모 쪽에서 처리
+
+    // 왼쪽 형제와 짝을 짓고, 첫 번째 자식이면 오른쪽 형제와 짝을 짓는다
+    size_t j = i > 0 ? i - 1 : i; // 구분 키 parent->keys[j]
+    PageId left_id = parent->children[j];
+    PageId right_id = parent->children[j + 1];
+    char* left_page = pool.Pin(left_id);
+    char* right_page = pool.Pin(right_id);
+
+    if (AsLeaf(left_page)->is_leaf) {
+        LeafPage* left = AsLeaf(left_page);
+        LeafPage* right = AsLeaf(right_page);
+        size_t total = left->count + right->count;
+
+        if (total <= static_cast<size_t>(degree - 1)) {
+            // 병합: 오른쪽 리프를 왼쪽에 붙이고 체인에서 빼 free list로
+            std::copy(right->keys, right->keys + right->count, left->keys + left->count);
+            left->count = total;
+            left->next = right->next;
+            if (right->next != kInvalidPage) {
+                AsLeaf(pool.Pin(right->next))->prev = left_id;
+                pool.Unpin(right->next, true);
+            }
+            ArrayErase(parent->children, parent->count + 1, j + 1);
+            ArrayErase(parent->keys, parent->count, j);
+            parent->count--;
+            pool.Unpin(left_id, true);
+            FreePage(right_id, right_page);
+            return;
+        }
+
+        // 재분배: 두 리프의 키 수를 반반으로
+        size_t target = total / 2;
+        if (left->count > target) {
+            size_t m = left->count - target; // 왼쪽 끝 m개를 오른쪽 앞으로
+            std::copy_backward(right->keys, right->keys + right->count, right->keys + right->count + m);
+            std::copy(left->keys + target, left->keys + left->count, right->keys);
+        } else {
+            size_t m = target - left->count; // 오른쪽 앞 m개를 왼쪽 끝으로
+            std::copy(right->keys, right->keys + m, left->keys + left->count);
+            std::copy(right->keys + m, right->keys + right->count, right->keys);
+        }
+        right->count = total - target;
+        left->count = target;
+        parent->keys[j] = right->keys[0];
+        pool.Unpin(left_id, true);
+        pool.Unpin(right_id, true);
+        return;
+    }
+
+    InternalPage* left = AsInternal(left_page);
+    InternalPage* right = AsInternal(right_page);
+    size_t total = left->count + right->count + 2; // 자식 수
+
+    if (total <= static_cast<size_t>(degree)) {
+        // 병합: 구분 키를 내려 받고 오른쪽 페이지를 붙인다
+        left->keys[left->count] = parent->keys[j];
+        std::copy(right->keys, right->keys + right->count, left->keys + left->count + 1);
+        std::copy(right->children, right->children + right->count + 1, left->children + left->count + 1);
+        left->count += right->count + 1;
+        ArrayErase(parent->children, parent->count + 1, j + 1);
+        ArrayErase(parent->keys, parent->count, j);
+        parent->count--;
+        pool.Unpin(left_id, true);
+        FreePage(right_id, right_page);
+        return;
+    }
+
+    // 재분배: 구분 키를 거쳐 자식 m개를 회전
+    size_t target = total / 2; // 왼쪽에 남길 자식 수
+    size_t left_children = left->count + 1;
+    if (left_children > target) {
+        size_t m = left_children - target;
+        std::copy_backward(right->keys, right->keys + right->count, right->keys + right->count + m);
+        std::copy_backward(right->children, right->children + right->count + 1, right->children + right->count + 1 + m);
+        right->keys[m - 1] = parent->keys[j];
+        std::copy(left->keys + left->count - m + 1, left->keys + left->count, right->keys);
+        std::copy(left->children + left->count + 1 - m, left->children + left->count + 1, right->children);
+        parent->keys[j] = left->keys[left->count - m];
+        left->count -= m;
+        right->count += m;
+    } else if (left_children < target) {
+        size_t m = target - left_children;
+        left->keys[left->count] = parent->keys[j];
+        std::copy(right->keys, right->keys + m - 1, left->keys + left->count + 1);
+        std::copy(right->children, right->children + m, left->children + left->count + 1);
+        parent->keys[j] = right->keys[m - 1];
+        std::copy(right->keys + m, right->keys + right->count, right->keys);
+        std::copy(right->children + m, right->children + right->count + 1, right->children);
+        left->count += m;
+        right->count -= m;
+    }
+    pool.Unpin(left_id, true);
+    pool.Unpin(right_id, true);
+}
+
+template<typename Key, size_t PageBytes>
+void PagedBplustree<Key, PageBytes>::ShrinkRoot() {
+    for (;;) {
+        char* page = pool.Pin(root);
+        InternalPage* internal = AsInternal(page);
+        if (internal->is_leaf || internal->count > 0) {
+            pool.Unpin(root, false);
+            return;
+        }
+        PageId child = internal->children[0];
+        FreePage(root, page);
+        root = child;
+    }
+}
+
+template<typename Key, size_t PageBytes>
+std::vector<Key> PagedBplustree<Key, PageBytes>::Scan(const Key& key, const int scan_num) {
+    // 키 수보다 큰 결과는 나올 수 없으므로 그만큼만 할당
+    std::vector<Key> result(std::min<size_t>(std::max(scan_num, 0), num_keys));
+    result.resize(Scan(key, result.size(), result.data()));
+    return result;
+}
+
+template<typename Key, size_t PageBytes>
+size_t PagedBplustree<Key, PageBytes>::Scan(const Key& key, size_t scan_num, Key* out) {
+    if (scan_num == 0) return 0;
+    PageId id;
+    LeafPage* leaf = FindLeaf(key, &id, nullptr);
+    size_t pos = simd_search::LowerBound(leaf->keys, leaf->count, key);
+    size_t copied = 0;
+    for (;;) {
+        // 리프의 키를 한 번에 복사하고 다음 리프로 (핀은 한 페이지씩)
+        size_t n = std::min<size_t>(leaf->count - pos, scan_num - copied);
+        std::copy(leaf->keys + pos, leaf->keys + pos + n, out + copied);
+        copied += n;
+        PageId next = leaf->next;
+        pool.Unpin(id, false);
+        if (copied == scan_num || next == kInvalidPage) return copied;
+        id = next;
+        leaf = AsLeaf(pool.Pin(id));
+        pos = 0;
+    }
+}
+
+template<typename Key, size_t PageBytes>
+std::vector<Key> PagedBplustree<Key, PageBytes>::ReverseScan(const Key& key, const int scan_num) {
+    std::vector<Key> result;
+    if (scan_num <= 0) return result;
+    PageId id;
+    LeafPage* leaf = FindLeaf(key, &id, nullptr);
+    size_t pos = simd_search::UpperBound(leaf->keys, leaf->count, key); // key 이하인 키 수
+    for (;;) {
+        while (pos > 0 && result.size() < static_cast<size_t>(scan_num)) {
+            result.push_back(leaf->keys[--pos]);
+        }
+        PageId prev = leaf->prev;
+        pool.Unpin(id, false);
+        if (result.size() == static_cast<size_t>(scan_num) || prev == kInvalidPage) return result;
+        id = prev;
+        leaf = AsLeaf(pool.Pin(id));
+        pos = leaf->count;
+    }
+}
+
+template<typename Key, size_t PageBytes>
+void PagedBplustree<Key, PageBytes>::MultiContains(const Key* keys, size_t n, bool* found) {
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+    for (size_t i : order) {
+        found[i] = Contains(keys[i]);
+    }
+}
+
+template<typename Key, size_t PageBytes>
+template<typename Iter>
+void PagedBplustree<Key, PageBytes>::InsertBatch(Iter begin, Iter end) {
+    std::vector<Key> batch(begin, end);
+    std::sort(batch.begin(), batch.end());
+    for (const Key& key : batch) {
+        Insert(key);
+    }
+}
+
+template<typename Key, size_t PageBytes>
+template<typename Iter>
+void PagedBplustree<Key, PageBytes>::BulkLoad(Iter begin, Iter end, double fill_factor) {
+    pool.Clear(); // 기존 페이지는 모두 버린다
+    free_list = kInvalidPage;
+    num_free_pages = 0;
+    PageId header;
+    pool.NewPage(&header);
+    pool.Unpin(header, true);
+    fill_factor = std::min(1.0, std::max(0.0, fill_factor));
+
+    const size_t n = std::distance(begin, end);
+    num_keys = n;
+
+    // 리프 층: 연속된 페이지에 왼쪽부터 고르게 채운다 (다음 리프는 항상 id + 1)
+    size_t leaf_fill = std::max<long>(1, std::lround(fill_factor * (degree - 1)));
+    size_t leaves = std::max<size_t>(1, (n + leaf_fill - 1) / leaf_fill);
+
+    std::vector<PageId> level;
+    std::vector<Key> low_keys;
+    level.reserve(leaves);
+    low_keys.reserve(leaves);
+    for (size_t l = 0; l < leaves; ++l) {
+        size_t count = n / leaves + (l < n % leaves ? 1 : 0);
+        PageId id;
+        LeafPage* leaf = AsLeaf(NewPage(true, &id));
+        for (size_t j = 0; j < count; ++j, ++begin) {
+            leaf->keys[j] = *begin;
+        }
+        leaf->count = count;
+        leaf->prev = l > 0 ? id - 1 : kInvalidPage;
+        leaf->next = l + 1 < leaves ? id + 1 : kInvalidPage;
+        level.push_back(id);
+        low_keys.push_back(count > 0 ? leaf->keys[0] : Key());
+        pool.Unpin(id, true);
+    }
+
+    // 내부 층: Bplustree::BulkLoad와 같은 방식으로 루트 하나가 남을 때까지
+    size_t child_fill = std::min<long>(degree, std::max<long>(3, std::lround(fill_factor * degree)));
+    while (level.size() > 1) {
+        size_t m = level.size();
+        size_t parents = (m + child_fill - 1) / child_fill;
+        size_t in = 0;
+        for (size_t p = 0; p < parents; ++p) {
+            size_t children = m / parents + (p < m % parents ? 1 : 0);
+            PageId id;
+            InternalPage* internal = AsInternal(NewPage(false, &id));
+            Key low = low_keys[in];
+            for (size_t j = 0; j < children; ++j, ++in) {
+                internal->children[j] = level[in];
+                if (j > 0) internal->keys[j - 1] = low_keys[in];
+            }
+            internal->count = children - 1;
+            pool.Unpin(id, true);
+            level[p] = id;
+            low_keys[p] = low;
+        }
+        level.resize(parents);
+        low_keys.resize(parents);
+    }
+    root = level[0];
+}
+
+template<typename Key, size_t PageBytes>
+void PagedBplustree<Key, PageBytes>::Print() {
+    PrintRecursive(root, 0);
+}
+
+template<typename Key, size_t PageBytes>
+void PagedBplustree<Key, PageBytes>::PrintRecursive(PageId id, int level) {
+    // 자식을 출력하는 동안 핀을 잡고 있지 않도록 내용을 먼저 복사
+    char* page = pool.Pin(id);
+    bool leaf = AsLeaf(page)->is_leaf;
+    size_t count = AsLeaf(page)->count;
+    std::vector<Key> keys;
+    std::vector<PageId> children;
+    if (leaf) {
+        keys.assign(AsLeaf(page)->keys, AsLeaf(page)->keys + count);
+    } else {
+        keys.assign(AsInternal(page)->keys, AsInternal(page)->keys + count);
+        children.assign(AsInternal(page)->children, AsInternal(page)->children + count + 1);
+    }
+    pool.Unpin(id, false);
+
+    for (int i = 0; i < level; ++i)
+        std::cout << "  ";
+    std::cout << (leaf ? "[Leaf " : "[Internal ") << id << "] ";
+    for (const Key& key : keys)
+        std::cout << key << " ";
+    std::cout << std::endl;
+    for (PageId child : children)
+        PrintRecursive(child, level + 1);
+}
+
+#endif  // LAB2_BPLUSTREE_PAGED_BPLUSTREE_H_
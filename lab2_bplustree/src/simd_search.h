@@ -0,0 +1,179 @@
+#ifndef LAB2_BPLUSTREE_SIMD_SEARCH_H_
+#define LAB2_BPLUSTREE_SIMD_SEARCH_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include <smmintrin.h>
+#include <nmmintrin.h>
+
+// In-node key search for B+ tree nodes.
+//
+// Both searches work on a sorted key array and return a position:
+//   UpperBound(keys, n, key) = number of keys <= key (child index in an internal node)
+//   LowerBound(keys, n, key) = number of keys <  key (insert/lookup position in a leaf)
+//
+// For uint64_t keys the comparison is vectorized (AVX2: 4 keys per compare,
+// SSE4.2: 2 keys per compare) and the position is the popcount of the compare
+// masks. Long arrays are first narrowed with a binary search so that only a
+// short window is scanned. The implementation is picked once at runtime from
+// the CPU features, with a scalar fallback.
+namespace simd_search {
+
+// Below this many keys the remaining window is scanned linearly
+static constexpr size_t kLinearWindow = 32;
+
+typedef size_t (*SearchFn)(const uint64_t* keys, size_t n, uint64_t key);
+
+// Binary search step shared by all variants: skips whole halves until at most
+// kLinearWindow keys remain. 'inclusive' selects <= (UpperBound) or < (LowerBound).
+inline size_t Narrow(const uint64_t*& keys, size_t& n, uint64_t key, bool inclusive) {
+    size_t base = 0;
+    while (n > kLinearWindow) {
+        size_t mid = n / 2;
+        bool go_right = inclusive ? keys[mid] <= key : keys[mid] < key;
+        if (go_right) {
+            base += mid + 1;
+            keys += mid + 1;
+            n -= mid + 1;
+        } else {
+            n = mid;
+        }
+    }
+    return base;
+}
+
+inline size_t UpperBoundScalar(const uint64_t* keys, size_t n, uint64_t key) {
+    size_t base = Narrow(keys, n, key, true);
+    size_t i = 0;
+    while (i < n && keys[i] <= key) ++i;
+    return base + i;
+}
+
+inline size_t LowerBoundScalar(const uint64_t* keys, size_t n, uint64_t key) {
+    size_t base = Narrow(keys, n, key, false);
+    size_t i = 0;
+    while (i < n && keys[i] < key) ++i;
+    return base + i;
+}
+
+// SSE4.2/AVX2 only have signed 64-bit compares; flipping the sign bit of both
+// operands turns them into unsigned compares.
+static constexpr uint64_t kSignBit = 0x8000000000000000ULL;
+
+__attribute__((target("sse4.2,popcnt")))
+inline size_t UpperBoundSSE42(const uint64_t* keys, size_t n, uint64_t key) {
+    size_t base = Narrow(keys, n, key, true);
+    const __m128i sign = _mm_set1_epi64x(static_cast<long long>(kSignBit));
+    const __m128i needle = _mm_xor_si128(_mm_set1_epi64x(static_cast<long long>(key)), sign);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i k = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), sign);
+        // k > key 인 lane이 나오면 그 앞까지가 답 (정렬되어 있으므로)
+        int gt = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(k, needle)));
+        if (gt != 0) return base + i + __builtin_popcount(~gt & 0x3);
+    }
+    if (i < n && keys[i] <= key) ++i;
+    return base + i;
+}
+
+__attribute__((target("sse4.2,popcnt")))
+inline size_t LowerBoundSSE42(const uint64_t* keys, size_t n, uint64_t key) {
+    size_t base = Narrow(keys, n, key, false);
+    const __m128i sign = _mm_set1_epi64x(static_cast<long long>(kSignBit));
+    const __m128i needle = _mm_xor_si128(_mm_set1_epi64x(static_cast<long long>(key)), sign);
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128i k = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i)), sign);
+        int lt = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(needle, k)));
+        if (lt != 0x3) return base + i + __builtin_popcount(lt);
+    }
+    if (i < n && keys[i] < key) ++i;
+    return base + i;
+}
+
+__attribute__((target("avx2,popcnt")))
+inline size_t UpperBoundAVX2(const uint64_t* keys, size_t n, uint64_t key) {
+    size_t base = Narrow(keys, n, key, true);
+    const __m256i sign = _mm256_set1_epi64x(static_cast<long long>(kSignBit));
+    const __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(key)), sign);
+    size_t i = 0;
+    // 한 번에 8개(256bit x 2)씩 비교
+    for (; i + 8 <= n; i += 8) {
+        __m256i k0 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), sign);
+        __m256i k1 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i + 4)), sign);
+        int gt = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(k0, needle))) |
+                 (_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(k1, needle))) << 4);
+        if (gt != 0) return base + i + __builtin_popcount(~gt & 0xff);
+    }
+    for (; i + 4 <= n; i += 4) {
+        __m256i k = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), sign);
+        int gt = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(k, needle)));
+        if (gt != 0) return base + i + __builtin_popcount(~gt & 0xf);
+    }
+    while (i < n && keys[i] <= key) ++i;
+    return base + i;
+}
+
+__attribute__((target("avx2,popcnt")))
+inline size_t LowerBoundAVX2(const uint64_t* keys, size_t n, uint64_t key) {
+    size_t base = Narrow(keys, n, key, false);
+    const __m256i sign = _mm256_set1_epi64x(static_cast<long long>(kSignBit));
+    const __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(key)), sign);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i k0 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), sign);
+        __m256i k1 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i + 4)), sign);
+        int lt = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, k0))) |
+                 (_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, k1))) << 4);
+        if (lt != 0xff) return base + i + __builtin_popcount(lt);
+    }
+    for (; i + 4 <= n; i += 4) {
+        __m256i k = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), sign);
+        int lt = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, k)));
+        if (lt != 0xf) return base + i + __builtin_popcount(lt);
+    }
+    while (i < n && keys[i] < key) ++i;
+    return base + i;
+}
+
+// Runtime dispatch: pick the widest implementation the CPU supports
+inline SearchFn ResolveUpperBound() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return UpperBoundAVX2;
+    if (__builtin_cpu_supports("sse4.2")) return UpperBoundSSE42;
+    return UpperBoundScalar;
+}
+
+inline SearchFn ResolveLowerBound() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return LowerBoundAVX2;
+    if (__builtin_cpu_supports("sse4.2")) return LowerBoundSSE42;
+    return LowerBoundScalar;
+}
+
+inline size_t UpperBound(const uint64_t* keys, size_t n, uint64_t key) {
+    static const SearchFn fn = ResolveUpperBound();
+    return fn(keys, n, key);
+}
+
+inline size_t LowerBound(const uint64_t* keys, size_t n, uint64_t key) {
+    static const SearchFn fn = ResolveLowerBound();
+    return fn(keys, n, key);
+}
+
+// Generic key types fall back to the standard library searches
+template<typename Key>
+inline size_t UpperBound(const Key* keys, size_t n, const Key& key) {
+    return std::upper_bound(keys, keys + n, key) - keys;
+}
+
+template<typename Key>
+inline size_t LowerBound(const Key* keys, size_t n, const Key& key) {
+    return std::lower_bound(keys, keys + n, key) - keys;
+}
+
+}  // namespace simd_search
+
+#endif  // LAB2_BPLUSTREE_SIMD_SEARCH_H_
@@ -0,0 +1,957 @@
+// Regression tests for the B+ trees, the snapshot format and the write-ahead log.
+//
+// Every tree is checked against std::set / std::map: Bplustree with random operations on
+// many degrees (plus Verify after each phase), PagedBplustree through a tiny buffer pool,
+// and OLCBplustree with threads that each own a slice of the key space (so every result
+// on their own keys is exact) while also fighting over a shared hot range.
+// Run with "make test"; "make test-tsan" and "make test-asan" build it with a sanitizer.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "bplustree.h"
+#include "olc_bplustree.h"
+#include "paged_bplustree.h"
+#include "snapshot.h"
+#include "wal.h"
+#include "simd_search.h"
+#include "benchmark.h"
+#include "histogram.h"
+
+static int failures = 0;
+
+#define CHECK(cond)                                                                    \
+    do {                                                                               \
+        if (!(cond)) {                                                                 \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                                \
+        }                                                                              \
+    } while (0)
+
+// Keys of 'model' in [from, ...), at most n of them
+template<typename Model>
+static std::vector<Key> ModelScan(const Model& model, Key from, long n) {
+    std::vector<Key> keys;
+    for (auto it = model.lower_bound(from); it != model.end() && static_cast<long>(keys.size()) < n; ++it) {
+        keys.push_back(*it);
+    }
+    return keys;
+}
+
+// Keys of 'model' <= from, largest first, at most n of them
+template<typename Model>
+static std::vector<Key> ModelReverseScan(const Model& model, Key from, long n) {
+    std::vector<Key> keys;
+    for (auto it = model.upper_bound(from); it != model.begin() && static_cast<long>(keys.size()) < n;) {
+        keys.push_back(*--it);
+    }
+    return keys;
+}
+
+// std::map keeps (key, value) pairs: scan its keys the same way
+struct MapKeys {
+    const std::map<Key, std::string>& map;
+    struct It {
+        std::map<Key, std::string>::const_iterator it;
+        Key operator*() const { return it->first; }
+        It& operator++() { ++it; return *this; }
+        It& operator--() { --it; return *this; }
+        bool operator!=(const It& other) const { return it != other.it; }
+        bool operator==(const It& other) const { return it == other.it; }
+    };
+    It lower_bound(Key key) const { return {map.lower_bound(key)}; }
+    It upper_bound(Key key) const { return {map.upper_bound(key)}; }
+    It begin() const { return {map.begin()}; }
+    It end() const { return {map.end()}; }
+};
+
+static std::string ValueOf(Key key) { return std::to_string(key * 3 + 1) + "-value"; }
+
+// Batched lookups of every size around the group width, unsorted and with duplicates,
+// agree with the model
+template<typename Tree, typename Model>
+static void CheckMultiContains(const Tree& tree, const Model& model, Key range, uint64_t seed) {
+    std::mt19937_64 gen(seed);
+    for (size_t n : {0, 1, 15, 16, 17, 64, 100}) {
+        std::vector<Key> keys(n);
+        for (Key& key : keys) key = gen() % range;
+        if (n > 1) keys[n - 1] = keys[0];
+        std::unique_ptr<bool[]> found(new bool[n + 1]);
+        tree.MultiContains(keys.data(), n, found.get());
+        for (size_t i = 0; i < n; ++i) {
+            auto it = model.lower_bound(keys[i]);
+            CHECK(found[i] == (it != model.end() && *it == keys[i]));
+        }
+    }
+}
+
+static std::string TempPath(const char* name) {
+    return std::string("/tmp/lab2_stress_") + std::to_string(getpid()) + "_" + name;
+}
+
+template<typename Tree>
+static void CheckVerify(const Tree& tree) {
+    std::string error;
+    bool ok = tree.Verify(&error);
+    if (!ok) std::fprintf(stderr, "Verify: %s\n", error.c_str());
+    CHECK(ok);
+}
+
+// Walks the tree with its iterator in both directions, and seeks to random keys,
+// comparing every key and value with the model
+template<typename Tree>
+static void CheckContents(const Tree& tree, const std::map<Key, std::string>& model) {
+    CHECK(tree.Size() == model.size());
+    typename Tree::Iterator it(&tree);
+    auto expected = model.begin();
+    for (it.SeekToFirst(); it.Valid() && expected != model.end(); it.Next(), ++expected) {
+        CHECK(it.key() == expected->first && *it.value() == expected->second);
+    }
+    CHECK(!it.Valid() && expected == model.end());
+    auto reverse = model.rbegin();
+    for (it.SeekToLast(); it.Valid() && reverse != model.rend(); it.Prev(), ++reverse) {
+        CHECK(it.key() == reverse->first);
+    }
+    CHECK(!it.Valid() && reverse == model.rend());
+    std::mt19937_64 gen(model.size());
+    for (int i = 0; i < 100; ++i) {
+        Key target = gen() % 25000;
+        auto lower = model.lower_bound(target);
+        it.Seek(target);
+        CHECK(it.Valid() == (lower != model.end()));
+        if (!it.Valid()) continue;
+        CHECK(it.key() == lower->first);
+        it.Prev();
+        CHECK(it.Valid() == (lower != model.begin()));
+        if (it.Valid()) CHECK(it.key() == std::prev(lower)->first);
+        it.SeekForPrev(target);
+        auto upper = model.upper_bound(target);
+        CHECK(it.Valid() == (upper != model.begin()));
+        if (it.Valid()) CHECK(it.key() == std::prev(upper)->first);
+    }
+}
+
+// Random Put/Delete/Get/Update and every scan of a key-value Bplustree against std::map,
+// deleting down to empty in the last round; Verify runs after every phase
+template<size_t NodeBytes>
+static void TestBplustree(int degree, bool lazy, uint64_t seed) {
+    typedef Bplustree<Key, std::string, NodeBytes> Tree;
+    Tree tree(degree);
+    tree.SetLazyMerge(lazy);
+    size_t peak_memory = 0;
+    CHECK(tree.Degree() == std::min(std::max(degree, 3), Tree::kMaxDegree));
+    std::map<Key, std::string> model;
+    MapKeys keys{model};
+    std::mt19937_64 gen(seed);
+    for (int round = 0; round < 4; ++round) {
+        const Key range = round % 2 == 0 ? 20000 : 2000;
+        for (int i = 0; i < 6000; ++i) {
+            Key key = gen() % range;
+            std::string value;
+            switch (gen() % 10) {
+                case 0: case 1: case 2:
+                    tree.Put(key, ValueOf(key));
+                    model[key] = ValueOf(key);
+                    break;
+                case 3:
+                    CHECK(tree.Delete(key) == (model.erase(key) == 1));
+                    break;
+                case 4:
+                    CHECK(tree.Get(key, &value) == (model.count(key) == 1));
+                    CHECK(model.count(key) == 0 || value == model[key]);
+                    break;
+                case 5:
+                    CHECK(tree.Update(key, "updated") == (model.count(key) == 1));
+                    if (model.count(key) == 1) model[key] = "updated";
+                    break;
+                case 6: {
+                    long n = static_cast<long>(gen() % 80) - 4; // 음수와 0도 포함
+                    CHECK(tree.Scan(key, static_cast<int>(n)) == ModelScan(keys, key, n));
+                    std::vector<Key> buffer(std::max(n, 0L));
+                    buffer.resize(tree.Scan(key, buffer.size(), buffer.data()));
+                    CHECK(buffer == ModelScan(keys, key, n));
+                    break;
+                }
+                case 7: {
+                    Key end = key + gen() % 200;
+                    std::vector<Key> expected;
+                    for (auto it = model.lower_bound(key); it != model.end() && it->first < end; ++it) {
+                        expected.push_back(it->first);
+                    }
+                    CHECK(tree.ScanRange(key, end) == expected);
+                    size_t cap = gen() % 50;
+                    std::vector<Key> buffer(cap);
+                    buffer.resize(tree.ScanRange(key, end, cap, buffer.data()));
+                    expected.resize(std::min(expected.size(), cap));
+                    CHECK(buffer == expected);
+                    break;
+                }
+                case 8: {
+                    long n = static_cast<long>(gen() % 80) - 4;
+                    CHECK(tree.ReverseScan(key, static_cast<int>(n)) == ModelReverseScan(keys, key, n));
+                    break;
+                }
+                case 9: {
+                    int n = static_cast<int>(gen() % 40) - 4;
+                    auto entries = tree.ScanKV(key, n);
+                    std::vector<Key> scanned;
+                    for (const auto& entry : entries) {
+                        scanned.push_back(entry.first);
+                        CHECK(*entry.second == model[entry.first]);
+                    }
+                    CHECK(scanned == ModelScan(keys, key, n));
+                    break;
+                }
+            }
+        }
+        CheckVerify(tree);
+        CheckContents(tree, model);
+        CheckMultiContains(tree, keys, range + 10, seed + round);
+        std::vector<Key> batch(100);
+        for (Key& key : batch) key = gen() % range;
+        std::vector<std::string> values(batch.size());
+        std::unique_ptr<bool[]> found(new bool[batch.size()]);
+        tree.MultiGet(batch.data(), batch.size(), values.data(), found.get());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            CHECK(found[i] == (model.count(batch[i]) == 1));
+            CHECK(!found[i] || values[i] == model[batch[i]]);
+        }
+        CHECK(tree.ApproximateMemoryUsage() >= model.size() * (sizeof(Key) + sizeof(std::string)));
+        peak_memory = std::max(peak_memory, tree.ApproximateMemoryUsage());
+
+        // 앞쪽 키를 몰아서 지워 병합이 일어나게 한다 (마지막 라운드는 전부)
+        size_t to_delete = round == 3 ? model.size() : model.size() * 3 / 4;
+        for (size_t i = 0; i < to_delete; ++i) {
+            auto victim = gen() % 3 == 0 ? model.lower_bound(gen() % range) : model.begin();
+            if (victim == model.end()) victim = model.begin();
+            CHECK(tree.Delete(victim->first));
+            model.erase(victim);
+        }
+        CheckVerify(tree);
+        CheckContents(tree, model);
+        if (lazy) {
+            // Compact 후에는 엄격한 최소 채움을 만족해야 한다
+            tree.Compact();
+            tree.SetLazyMerge(false);
+            CheckVerify(tree);
+            tree.SetLazyMerge(true);
+        }
+    }
+    CHECK(tree.Scan(0, 1).empty());
+    // 전부 지운 트리는 빈 노드를 들고 있지 않아야 한다
+    CHECK(tree.ApproximateMemoryUsage() < peak_memory / 8);
+
+    // 벌크 로드는 내용을 바꾸고, 이후 삽입/배치 삽입/삭제도 구조를 유지해야 한다
+    std::vector<std::pair<Key, std::string>> sorted;
+    for (Key key = 0; key < 5000; key += 1 + gen() % 4) sorted.emplace_back(key, ValueOf(key));
+    tree.BulkLoad(sorted.begin(), sorted.end());
+    model = std::map<Key, std::string>(sorted.begin(), sorted.end());
+    CheckVerify(tree);
+    CheckContents(tree, model);
+    for (int i = 0; i < 3000; ++i) {
+        Key key = gen() % 10000;
+        if (gen() % 2 == 0) {
+            tree.Put(key, ValueOf(key));
+            model[key] = ValueOf(key);
+        } else {
+            CHECK(tree.Delete(key) == (model.erase(key) == 1));
+        }
+    }
+    CheckVerify(tree);
+    CheckContents(tree, model);
+    // 배치 삽입은 기존 값을 덮어쓰지 않고, 배치 안의 중복은 첫 번째가 남는다
+    std::vector<std::pair<Key, std::string>> batch;
+    for (int i = 0; i < 3000; ++i) {
+        Key key = gen() % 10000;
+        batch.emplace_back(key, std::to_string(i));
+        model.emplace(key, std::to_string(i));
+    }
+    tree.InsertBatch(batch.begin(), batch.end());
+    CheckVerify(tree);
+    CheckContents(tree, model);
+}
+
+// Batches of every size into trees of every shape, including one batch that grows an
+// empty degree 3 tree by several levels at once
+static void TestInsertBatch(int degree) {
+    std::mt19937_64 gen(degree + 100);
+    Bplustree<Key> tree(degree);
+    std::set<Key> model;
+    for (size_t n : {20000, 0, 1, 2, 17, 500, 5000}) {
+        std::vector<Key> batch(n);
+        for (Key& key : batch) key = gen() % 100000;
+        tree.InsertBatch(batch.begin(), batch.end());
+        model.insert(batch.begin(), batch.end());
+        CHECK(tree.Size() == model.size());
+        CHECK(tree.Scan(0, model.size() + 1) == std::vector<Key>(model.begin(), model.end()));
+        CheckVerify(tree);
+        CHECK(tree.ReverseScan(UINT64_MAX, 50) == ModelReverseScan(model, UINT64_MAX, 50));
+        for (int i = 0; i < 1000; ++i) {
+            Key key = gen() % 100000;
+            CHECK(tree.Delete(key) == (model.erase(key) == 1));
+        }
+    }
+    CHECK(tree.Scan(0, INT_MAX) == std::vector<Key>(model.begin(), model.end()));
+}
+
+// Bulk loads of every size and fill factor match their input, stay correct under later
+// inserts and deletes, and a full load is smaller than the same keys inserted one by one
+static void TestBulkLoad(int degree) {
+    std::mt19937_64 gen(degree);
+    for (size_t count : {size_t(0), size_t(1), size_t(degree - 1), size_t(degree), size_t(1000), size_t(20000)}) {
+        for (double fill : {0.5, 0.7, 1.0}) {
+            std::vector<Key> sorted;
+            for (Key key = 0; sorted.size() < count; key += 1 + gen() % 3) sorted.push_back(key);
+            Bplustree<Key> tree(sorted.begin(), sorted.end(), fill, degree);
+            CHECK(tree.Size() == count && tree.Scan(0, count + 1) == sorted);
+            if (fill == 1.0) CheckVerify(tree);
+            CHECK(tree.ReverseScan(UINT64_MAX, count + 1) == std::vector<Key>(sorted.rbegin(), sorted.rend()));
+            std::set<Key> model(sorted.begin(), sorted.end());
+            for (int i = 0; i < 2000; ++i) {
+                Key key = gen() % (3 * count + 10);
+                if (gen() % 2 == 0) {
+                    tree.Insert(key);
+                    model.insert(key);
+                } else {
+                    CHECK(tree.Delete(key) == (model.erase(key) == 1));
+                }
+            }
+            CHECK(tree.Scan(0, model.size() + 1) == std::vector<Key>(model.begin(), model.end()));
+            if (fill == 1.0) CheckVerify(tree);
+        }
+    }
+    std::vector<Key> sorted(20000);
+    for (size_t i = 0; i < sorted.size(); ++i) sorted[i] = i;
+    Bplustree<Key> loaded(sorted.begin(), sorted.end(), 1.0, degree), inserted(degree);
+    for (Key key : sorted) inserted.Insert(key);
+    CHECK(loaded.ApproximateMemoryUsage() < inserted.ApproximateMemoryUsage());
+}
+
+// A bulk load in lazy merge mode starts a fresh delete count: deletes made before the load
+// must not trigger a Compact that packs the sparse nodes of the new tree
+static void TestBulkLoadLazy() {
+    Bplustree<Key> tree(8);
+    tree.SetLazyMerge(true);
+    for (Key key = 0; key < 1000; ++key) tree.Insert(key);
+    for (Key key = 0; key < 600; ++key) CHECK(tree.Delete(key));
+    std::vector<Key> sorted;
+    for (Key key = 0; key < 50; ++key) sorted.push_back(key * 2);
+    tree.BulkLoad(sorted.begin(), sorted.end(), 0.3);
+    size_t loaded = tree.ApproximateMemoryUsage();
+    CHECK(tree.Delete(0));
+    CHECK(tree.ApproximateMemoryUsage() == loaded);
+    CheckVerify(tree);
+}
+
+// Single-threaded OLCBplustree against std::set, starting from a bulk load
+static void TestOLCAgainstSet(int degree) {
+    std::mt19937_64 gen(degree);
+    std::vector<Key> sorted;
+    for (Key key = 0; key < 5000; key += 1 + gen() % 4) sorted.push_back(key);
+    OLCBplustree<Key> tree(degree);
+    tree.BulkLoad(sorted.begin(), sorted.end(), 0.7);
+    std::set<Key> model(sorted.begin(), sorted.end());
+    for (int i = 0; i < 100000; ++i) {
+        Key key = gen() % 5000;
+        switch (gen() % 5) {
+            case 0: case 1:
+                tree.Insert(key);
+                model.insert(key);
+                break;
+            case 2:
+                CHECK(tree.Delete(key) == (model.erase(key) == 1));
+                break;
+            case 3:
+                CHECK(tree.Contains(key) == (model.count(key) == 1));
+                break;
+            case 4: {
+                int n = static_cast<int>(gen() % 80) - 4;
+                if (gen() % 3 == 0) {
+                    CHECK(tree.Scan(key, n) == ModelScan(model, key, n));
+                } else if (gen() % 2 == 0) {
+                    std::vector<Key> buffer(std::max(n, 0));
+                    buffer.resize(tree.Scan(key, buffer.size(), buffer.data()));
+                    CHECK(buffer == ModelScan(model, key, n));
+                } else {
+                    CHECK(tree.ReverseScan(key, n) == ModelReverseScan(model, key, n));
+                }
+                break;
+            }
+        }
+    }
+    std::vector<Key> batch(500);
+    for (Key& key : batch) key = gen() % 6000;
+    tree.InsertBatch(batch.begin(), batch.end());
+    model.insert(batch.begin(), batch.end());
+    CHECK(tree.Size() == model.size());
+    CHECK(tree.Scan(0, model.size() + 1) == std::vector<Key>(model.begin(), model.end()));
+    CheckMultiContains(tree, model, 6010, degree);
+}
+
+// PagedBplustree through an 8-frame pool, so almost every step evicts a page
+static void TestPaged(int degree) {
+    std::string path = TempPath("pages");
+    {
+        PagedBplustree<Key> tree(path, 8, degree);
+        std::set<Key> model;
+        std::mt19937_64 gen(degree);
+        for (int i = 0; i < 30000; ++i) {
+            Key key = gen() % 20000;
+            switch (gen() % 5) {
+                case 0: case 1:
+                    tree.Insert(key);
+                    model.insert(key);
+                    break;
+                case 2:
+                    CHECK(tree.Delete(key) == (model.erase(key) == 1));
+                    break;
+                case 3:
+                    CHECK(tree.Contains(key) == (model.count(key) == 1));
+                    break;
+                case 4: {
+                    int n = static_cast<int>(gen() % 80) - 4;
+                    if (gen() % 2 == 0) {
+                        CHECK(tree.Scan(key, n) == ModelScan(model, key, n));
+                    } else {
+                        CHECK(tree.ReverseScan(key, n) == ModelReverseScan(model, key, n));
+                    }
+                    break;
+                }
+            }
+        }
+        CHECK(tree.Size() == model.size());
+        CHECK(tree.Scan(0, INT_MAX) == std::vector<Key>(model.begin(), model.end()));
+        CHECK(tree.Pool().GetStats().misses > 0);
+
+        std::vector<Key> sorted;
+        for (Key key = 0; key < 50000; key += 1 + gen() % 5) sorted.push_back(key);
+        tree.BulkLoad(sorted.begin(), sorted.end(), 0.7);
+        model = std::set<Key>(sorted.begin(), sorted.end());
+        std::vector<Key> batch;
+        for (int i = 0; i < 2000; ++i) batch.push_back(gen() % 60000);
+        tree.InsertBatch(batch.begin(), batch.end());
+        model.insert(batch.begin(), batch.end());
+        CHECK(tree.Scan(0, INT_MAX) == std::vector<Key>(model.begin(), model.end()));
+        CHECK(tree.ReverseScan(UINT64_MAX, INT_MAX) == ModelReverseScan(model, UINT64_MAX, LONG_MAX));
+
+        // 전부 지우면 루트 리프 하나만 남고 나머지 페이지는 free list로 간다.
+        // 같은 키를 두 번째로 다시 채울 때는 free list만으로 충분해 파일이 자라지 않는다.
+        size_t file_bytes = 0;
+        for (int round = 0; round < 2; ++round) {
+            if (round == 1) file_bytes = tree.FileBytes();
+            for (Key key : model) CHECK(tree.Delete(key));
+            CHECK(tree.Size() == 0 && tree.Scan(0, INT_MAX).empty());
+            CHECK(tree.FreeBytes() == tree.FileBytes() - 2 * PagedBplustree<Key>::kNodeBytes); // 헤더와 루트
+            for (Key key : model) tree.Insert(key);
+            CHECK(tree.Scan(0, INT_MAX) == std::vector<Key>(model.begin(), model.end()));
+        }
+        CHECK(tree.FileBytes() == file_bytes);
+    }
+    unlink(path.c_str());
+}
+
+// A page file reopened after the tree is destroyed holds the same tree (the degree
+// comes from the file), and a scratch tree starts empty and removes its file
+static void TestPagedReopen() {
+    std::string path = TempPath("reopen");
+    std::set<Key> model;
+    std::mt19937_64 gen(5);
+    for (int session = 0; session < 3; ++session) {
+        PagedBplustree<Key> tree(path, 8 + session, session == 0 ? 16 : 5);
+        CHECK(tree.Degree() == 16 && tree.Size() == model.size());
+        CHECK(tree.Scan(0, INT_MAX) == std::vector<Key>(model.begin(), model.end()));
+        for (int i = 0; i < 20000; ++i) {
+            Key key = gen() % 10000;
+            if (gen() % 3 == 0) {
+                CHECK(tree.Delete(key) == (model.erase(key) == 1));
+            } else {
+                tree.Insert(key);
+                model.insert(key);
+            }
+        }
+    }
+    {
+        PagedBplustree<Key> tree(path, 8, 16, false, true);
+        CHECK(tree.Size() == 0 && tree.Scan(0, INT_MAX).empty());
+        tree.Insert(1);
+    }
+    CHECK(access(path.c_str(), F_OK) != 0);
+}
+
+// Threads own the keys k with k % threads == tid and check every result on them exactly;
+// all of them also insert and delete a shared hot range, and one more thread keeps
+// scanning the whole tree (the result must stay sorted while it grows and shrinks).
+static void TestOLCConcurrent(int threads, int ops_per_thread) {
+    const Key kOwnedRange = 20000;
+    const Key kHotBase = 1000000, kHotRange = 64;
+    OLCBplustree<Key> tree(8); // 작은 노드: 분할과 병합이 자주 일어난다
+    std::vector<std::set<Key>> models(threads);
+    std::atomic<int> thread_failures(0);
+    std::atomic<bool> done(false);
+
+    auto worker = [&](int tid) {
+        std::mt19937_64 gen(tid + 1);
+        std::set<Key>& model = models[tid];
+        auto own_key = [&] { return (gen() % (kOwnedRange / threads)) * threads + tid; };
+        int local_failures = 0;
+        for (int i = 0; i < ops_per_thread; ++i) {
+            switch (gen() % 8) {
+                case 0:
+                case 1: {
+                    Key key = own_key();
+                    tree.Insert(key);
+                    model.insert(key);
+                    break;
+                }
+                case 2: {
+                    Key key = own_key();
+                    if (tree.Delete(key) != (model.erase(key) == 1)) local_failures++;
+                    break;
+                }
+                case 3: {
+                    Key key = own_key();
+                    if (tree.Contains(key) != (model.count(key) == 1)) local_failures++;
+                    break;
+                }
+                case 4: {
+                    // 결과는 정렬되어 있어야 하고, 그 구간의 내 키는 정확히 내 모델과 같아야 한다
+                    Key from = gen() % kOwnedRange;
+                    int n = 1 + gen() % 64;
+                    std::vector<Key> keys = tree.Scan(from, n);
+                    bool sorted = std::adjacent_find(keys.begin(), keys.end(), std::greater_equal<Key>()) == keys.end();
+                    if (!sorted || (!keys.empty() && keys.front() < from)) local_failures++;
+                    Key last = static_cast<int>(keys.size()) < n ? kHotBase : keys.back() + 1;
+                    std::vector<Key> mine, expected;
+                    for (Key key : keys) {
+                        if (key < kOwnedRange && static_cast<int>(key % threads) == tid) mine.push_back(key);
+                    }
+                    for (auto it = model.lower_bound(from); it != model.end() && *it < last; ++it) expected.push_back(*it);
+                    if (mine != expected) local_failures++;
+                    break;
+                }
+                case 5: {
+                    Key key = own_key();
+                    std::vector<Key> keys = tree.ReverseScan(key, 8);
+                    bool sorted = std::adjacent_find(keys.begin(), keys.end(), std::less_equal<Key>()) == keys.end();
+                    if (!sorted || (!keys.empty() && keys.front() > key)) local_failures++;
+                    if (!keys.empty() && (keys.front() == key) != (model.count(key) == 1)) local_failures++;
+                    break;
+                }
+                default: {
+                    Key key = kHotBase + gen() % kHotRange;
+                    if (gen() % 2 == 0) {
+                        tree.Insert(key);
+                    } else {
+                        tree.Delete(key);
+                    }
+                    break;
+                }
+            }
+        }
+        thread_failures += local_failures;
+    };
+    auto scanner = [&] {
+        int local_failures = 0;
+        std::vector<Key> buffer(100000);
+        for (int i = 0; !done.load(); ++i) {
+            // 버퍼 스캔과, 스캔 중에 버퍼를 늘려 가는 Scan(0, INT_MAX)를 번갈아 쓴다
+            std::vector<Key> keys = i % 2 == 0 ? tree.Scan(0, INT_MAX) : std::vector<Key>(
+                buffer.begin(), buffer.begin() + tree.Scan(0, buffer.size(), buffer.data()));
+            if (std::adjacent_find(keys.begin(), keys.end(), std::greater_equal<Key>()) != keys.end()) local_failures++;
+        }
+        thread_failures += local_failures;
+    };
+
+    std::thread scan_thread(scanner);
+    std::vector<std::thread> pool;
+    for (int tid = 0; tid < threads; ++tid) pool.emplace_back(worker, tid);
+    for (std::thread& t : pool) t.join();
+    done = true;
+    scan_thread.join();
+    CHECK(thread_failures == 0);
+
+    // 최종 상태: 소유 구간은 모델의 합집합, 핫 구간은 Contains와 일치하는 정렬된 키
+    std::set<Key> all;
+    for (const std::set<Key>& model : models) all.insert(model.begin(), model.end());
+    std::vector<Key> owned = tree.Scan(0, INT_MAX);
+    std::vector<Key> hot(std::lower_bound(owned.begin(), owned.end(), kHotBase), owned.end());
+    owned.resize(owned.size() - hot.size());
+    CHECK(owned == std::vector<Key>(all.begin(), all.end()));
+    CHECK(static_cast<Key>(hot.size()) <= kHotRange);
+    for (Key key = kHotBase; key < kHotBase + kHotRange; ++key) {
+        CHECK(tree.Contains(key) == std::binary_search(hot.begin(), hot.end(), key));
+    }
+    CHECK(tree.Size() == all.size() + hot.size());
+    std::cout << "OLCBplustree: " << threads << " threads, " << all.size() + hot.size() << " keys match\n";
+}
+
+// Deleting every key merges leaves and internal nodes back into one root leaf, and the
+// unlinked nodes are freed once the epoch moves past every operation that could see them
+static void TestOLCReclaim() {
+    const int kKeys = 100000;
+    OLCBplustree<Key> tree(8);
+    std::atomic<int> missing(0);
+    for (int round = 0; round < 3; ++round) {
+        RunPhase(4, kKeys, [&](int, int begin, int end, Histogram&) {
+            for (int i = begin; i < end; ++i) tree.Insert(i);
+        });
+        size_t peak = tree.ApproximateMemoryUsage();
+        RunPhase(4, kKeys, [&](int, int begin, int end, Histogram&) {
+            for (int i = begin; i < end; ++i) missing += !tree.Delete(i);
+        });
+        CHECK(tree.Size() == 0 && tree.Scan(0, 10).empty());
+        // 선점된 스레드가 epoch를 잡고 있었을 수 있으니, 혼자 삽입/삭제를 더 해서 epoch를 넘긴다
+        for (Key key = 0; key < 4096; ++key) tree.Insert(key);
+        for (Key key = 0; key < 4096; ++key) missing += !tree.Delete(key);
+        CHECK(tree.ApproximateMemoryUsage() < peak / 8);
+        CHECK(tree.RetiredBytes() < peak / 8);
+    }
+    CHECK(missing == 0);
+    std::cout << "OLCBplustree: " << tree.ApproximateMemoryUsage() << " bytes left after deleting every key\n";
+}
+
+// Every vectorized search variant the CPU supports agrees with std::upper_bound /
+// std::lower_bound on every array length, including keys with the top bit set
+static void TestSimdSearch() {
+    using namespace simd_search;
+    struct Variant {
+        const char* name;
+        SearchFn upper, lower;
+        bool supported;
+    };
+    __builtin_cpu_init();
+    const Variant variants[] = {
+        {"scalar", UpperBoundScalar, LowerBoundScalar, true},
+        {"sse4.2", UpperBoundSSE42, LowerBoundSSE42, __builtin_cpu_supports("sse4.2") != 0},
+        {"avx2", UpperBoundAVX2, LowerBoundAVX2, __builtin_cpu_supports("avx2") != 0},
+        {"dispatch", UpperBound, LowerBound, true},
+    };
+    std::mt19937_64 gen(23);
+    for (size_t n = 0; n <= 300; ++n) {
+        std::vector<uint64_t> keys(n);
+        for (uint64_t& key : keys) key = gen() % 4 == 0 ? UINT64_MAX - gen() % 1000 : gen() % 1000;
+        std::sort(keys.begin(), keys.end());
+        std::vector<uint64_t> probes = {0, 1, 999, 1000, UINT64_MAX - 1000, UINT64_MAX};
+        for (uint64_t key : keys) {
+            probes.push_back(key);
+            probes.push_back(key + 1);
+            probes.push_back(key - 1);
+        }
+        for (uint64_t probe : probes) {
+            size_t upper = std::upper_bound(keys.begin(), keys.end(), probe) - keys.begin();
+            size_t lower = std::lower_bound(keys.begin(), keys.end(), probe) - keys.begin();
+            for (const Variant& variant : variants) {
+                if (!variant.supported) continue;
+                CHECK(variant.upper(keys.data(), n, probe) == upper);
+                CHECK(variant.lower(keys.data(), n, probe) == lower);
+            }
+        }
+    }
+    std::cout << "simd_search: every variant matches std::upper_bound / std::lower_bound\n";
+}
+
+// Percentiles are within one sub-bucket (1/32) above the exact sample, and merging
+// two halves gives the same histogram as recording everything in one
+static void TestHistogram() {
+    std::mt19937_64 gen(17);
+    std::vector<uint64_t> samples;
+    Histogram all, first, second;
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t value = gen() >> (gen() % 64); // 모든 자릿수에 고르게
+        samples.push_back(value);
+        all.Add(value);
+        (i % 2 == 0 ? first : second).Add(value);
+    }
+    std::sort(samples.begin(), samples.end());
+    first.Merge(second);
+    CHECK(all.Count() == samples.size() && all.Min() == samples.front() && all.Max() == samples.back());
+    for (double p : {0.0, 1.0, 50.0, 90.0, 99.0, 99.9, 100.0}) {
+        size_t rank = std::max<size_t>(1, static_cast<size_t>(samples.size() * (p / 100.0)));
+        uint64_t exact = samples[rank - 1];
+        uint64_t estimate = all.Percentile(p);
+        CHECK(estimate >= exact && estimate - exact <= exact / 32);
+        CHECK(first.Percentile(p) == estimate);
+    }
+    CHECK(Histogram().Percentile(50) == 0);
+    std::cout << "Histogram: percentiles within 1/32 of the exact samples\n";
+}
+
+// RunPhase hands every operation to exactly one worker, and merges the workers' latencies
+static void TestRunPhase() {
+    const int kOps = 10007;
+    for (int threads : {1, 3, 8}) {
+        std::vector<int> seen(kOps, 0);
+        PhaseResult result = RunPhase(threads, kOps, [&](int, int begin, int end, Histogram& latency) {
+            for (int i = begin; i < end; ++i) {
+                seen[i]++;
+                latency.Add(i);
+            }
+        });
+        CHECK(std::count(seen.begin(), seen.end(), 1) == kOps);
+        CHECK(result.ops == kOps && static_cast<int>(result.thread_ops.size()) == threads);
+        long total = 0;
+        for (long ops : result.thread_ops) total += ops;
+        CHECK(total == kOps && result.latency.Count() == kOps);
+    }
+    std::cout << "RunPhase: every operation runs exactly once\n";
+}
+
+// Snapshot round trip of a key-value tree; a corrupted, truncated or inconsistent file must be rejected
+static void TestSnapshot() {
+    std::string path = TempPath("snapshot");
+    Bplustree<Key, uint64_t> tree;
+    std::map<Key, uint64_t> model;
+    std::mt19937_64 gen(5);
+    for (int i = 0; i < 100000; ++i) {
+        Key key = gen() % 1000000;
+        tree.Put(key, key * 7);
+        model[key] = key * 7;
+    }
+    std::string error;
+    CHECK(tree.SaveSnapshot(path, &error));
+
+    Bplustree<Key, uint64_t> loaded;
+    CHECK(loaded.LoadSnapshot(path, 0.8, &error));
+    CheckVerify(loaded);
+    CHECK(loaded.Size() == model.size());
+    for (int i = 0; i < 10000; ++i) {
+        Key key = gen() % 1000000;
+        uint64_t value = 0;
+        CHECK(loaded.Get(key, &value) == (model.count(key) == 1));
+        CHECK(model.count(key) == 0 || value == model[key]);
+    }
+
+    SnapshotReader<Key, uint64_t> reader;
+    CHECK(reader.Open(path, true));
+    for (int i = 0; i < 10000; ++i) {
+        Key key = gen() % 1000000;
+        uint64_t value = 0;
+        CHECK(reader.Get(key, &value) == (model.count(key) == 1));
+        CHECK(model.count(key) == 0 || value == model[key]);
+    }
+    reader.Close();
+
+    // 값 영역의 한 바이트를 바꾸면 CRC 검사에서 거부되어야 한다
+    int fd = open(path.c_str(), O_RDWR);
+    off_t offset = sizeof(SnapshotHeader) + model.size() * sizeof(Key) + 5;
+    char byte;
+    CHECK(pread(fd, &byte, 1, offset) == 1);
+    byte ^= 0x40;
+    CHECK(pwrite(fd, &byte, 1, offset) == 1);
+    Bplustree<Key, uint64_t> corrupted;
+    CHECK(!corrupted.LoadSnapshot(path, 1.0, &error));
+
+    // CRC가 맞더라도 fanout이나 개수가 잘못된 헤더는 거부되어야 한다 (0으로 나누기, 무한 루프, 넘침)
+    SnapshotHeader original;
+    CHECK(pread(fd, &original, sizeof(original), 0) == sizeof(original));
+    for (int variant = 0; variant < 3; ++variant) {
+        SnapshotHeader header = original;
+        if (variant < 2) header.fanout = variant;
+        else header.count = UINT64_MAX / 4;
+        header.header_crc = Crc32c(0, &header, offsetof(SnapshotHeader, header_crc));
+        CHECK(pwrite(fd, &header, sizeof(header), 0) == sizeof(header));
+        CHECK(!reader.Open(path, false));
+    }
+    // 원래 헤더로는 (데이터 CRC를 검사하지 않으면) 다시 열려야 한다
+    CHECK(pwrite(fd, &original, sizeof(original), 0) == sizeof(original));
+    CHECK(reader.Open(path, false));
+    reader.Close();
+    CHECK(ftruncate(fd, sizeof(SnapshotHeader) + 100) == 0);
+    CHECK(!corrupted.LoadSnapshot(path, 1.0, &error));
+    close(fd);
+    unlink(path.c_str());
+    std::cout << "Snapshot: round trip and corruption checks done\n";
+}
+
+// Recovery from a log whose tail was torn by a crash: intact records replay (including the
+// clear record of a bulk load), the torn record is dropped, and appends continue after it
+static void TestWalTornTail() {
+    std::string path = TempPath("wal");
+    unlink(path.c_str());
+    std::set<Key> model;
+    {
+        WriteAheadLog<Key> log(path, SyncPolicy::kNone);
+        Logged<Key, Bplustree<Key>> tree(log, 8);
+        std::mt19937_64 gen(11);
+        for (int i = 0; i < 5000; ++i) {
+            Key key = gen() % 2000;
+            tree.Insert(key);
+            model.insert(key);
+        }
+        // 벌크 로드는 clear + 삽입으로 기록되므로 이전 내용은 복구되지 않아야 한다
+        std::vector<Key> sorted;
+        for (Key key = 10000; key < 13000; key += 3) sorted.push_back(key);
+        tree.BulkLoad(sorted.begin(), sorted.end());
+        model = std::set<Key>(sorted.begin(), sorted.end());
+        for (int i = 0; i < 5000; ++i) {
+            Key key = 10000 + gen() % 4000;
+            if (gen() % 3 == 0) {
+                tree.Delete(key);
+                model.erase(key);
+            } else {
+                tree.Insert(key);
+                model.insert(key);
+            }
+        }
+    }
+    size_t records = 5000 + 1 + 1000 + 5000;
+    {
+        WriteAheadLog<Key> log(path, SyncPolicy::kNone);
+        Logged<Key, Bplustree<Key>> tree(log, 8);
+        tree.Insert(12345678); // 이 레코드를 반쯤 잘라낸다
+    }
+    int fd = open(path.c_str(), O_RDWR);
+    off_t size = lseek(fd, 0, SEEK_END);
+    CHECK(ftruncate(fd, size - 3) == 0);
+    close(fd);
+    {
+        WriteAheadLog<Key> log(path, SyncPolicy::kNone);
+        Logged<Key, Bplustree<Key>> tree(log, 8);
+        CHECK(tree.Replay() == records);
+        CHECK(tree.Scan(0, INT_MAX) == std::vector<Key>(model.begin(), model.end()));
+        CheckVerify(tree);
+        tree.Insert(87654321);
+    }
+    // 체크섬이 틀린 마지막 레코드도 잘린 꼬리로 취급된다
+    fd = open(path.c_str(), O_RDWR);
+    size = lseek(fd, 0, SEEK_END);
+    char byte;
+    CHECK(pread(fd, &byte, 1, size - 1) == 1);
+    byte ^= 1;
+    CHECK(pwrite(fd, &byte, 1, size - 1) == 1);
+    close(fd);
+    {
+        WriteAheadLog<Key> log(path, SyncPolicy::kNone);
+        Logged<Key, Bplustree<Key>> tree(log, 8);
+        CHECK(tree.Replay() == records);
+        CHECK(tree.Scan(0, INT_MAX) == std::vector<Key>(model.begin(), model.end()));
+    }
+    unlink(path.c_str());
+    std::cout << "WriteAheadLog: torn tail recovery done\n";
+}
+
+// Checkpoint, more writes, "crash": the snapshot plus the replayed log restore everything
+static void TestWalCheckpoint() {
+    std::string path = TempPath("wal_checkpoint");
+    std::string snapshot = TempPath("checkpoint_snapshot");
+    unlink(path.c_str());
+    std::set<Key> model;
+    {
+        WriteAheadLog<Key> log(path, SyncPolicy::kEveryOp);
+        Logged<Key, Bplustree<Key>> tree(log);
+        std::mt19937_64 gen(13);
+        for (int i = 0; i < 3000; ++i) {
+            Key key = gen() % 5000;
+            tree.Insert(key);
+            model.insert(key);
+        }
+        std::string error;
+        CHECK(tree.Checkpoint(snapshot, &error));
+        for (int i = 0; i < 300; ++i) {
+            Key key = gen() % 5000;
+            if (gen() % 2 == 0) {
+                tree.Delete(key);
+                model.erase(key);
+            } else {
+                tree.Insert(key);
+                model.insert(key);
+            }
+        }
+    }
+    WriteAheadLog<Key> log(path, SyncPolicy::kNone);
+    Logged<Key, Bplustree<Key>> tree(log);
+    std::string error;
+    CHECK(tree.LoadSnapshot(snapshot, 1.0, &error));
+    CHECK(tree.Replay() == 300);
+    CHECK(tree.Scan(0, INT_MAX) == std::vector<Key>(model.begin(), model.end()));
+    unlink(path.c_str());
+    unlink(snapshot.c_str());
+    std::cout << "WriteAheadLog: checkpoint + replay done\n";
+}
+
+// Concurrent logged writers with group commit; the replayed tree must match the live one
+static void TestWalConcurrentReplay() {
+    std::string path = TempPath("wal_concurrent");
+    unlink(path.c_str());
+    std::vector<Key> live;
+    {
+        WriteAheadLog<Key> log(path, SyncPolicy::kInterval, 1);
+        Logged<Key, OLCBplustree<Key>> tree(log, 8);
+        std::vector<std::thread> pool;
+        for (int tid = 0; tid < 4; ++tid) {
+            pool.emplace_back([&tree, tid] {
+                std::mt19937_64 gen(tid + 100);
+                for (int i = 0; i < 5000; ++i) {
+                    Key key = gen() % 500; // 스레드끼리 같은 키를 두고 경쟁
+                    if (gen() % 2 == 0) {
+                        tree.Insert(key);
+                    } else {
+                        tree.Delete(key);
+                    }
+                }
+            });
+        }
+        for (std::thread& t : pool) t.join();
+        live = tree.Scan(0, INT_MAX);
+    }
+    WriteAheadLog<Key> log(path, SyncPolicy::kNone);
+    Logged<Key, Bplustree<Key>> replayed(log);
+    CHECK(replayed.Replay() == 20000);
+    CHECK(replayed.Scan(0, INT_MAX) == live);
+    unlink(path.c_str());
+    std::cout << "WriteAheadLog: concurrent writers replay to the same tree\n";
+}
+
+int main() {
+    for (int degree : {3, 4, 5, 8, 15, 31}) {
+        for (bool lazy : {false, true}) TestBplustree<512>(degree, lazy, degree * 2 + lazy);
+    }
+    TestBplustree<4096>(255, false, 255);
+    TestBplustree<4096>(255, true, 256);
+    TestBplustree<256>(1000, false, 1000); // kMaxDegree로 제한된다
+    CHECK(Bplustree<Key>().Degree() == Bplustree<Key>::kMaxDegree);
+    for (int degree : {3, 4, 15}) TestBulkLoad(degree);
+    TestBulkLoadLazy();
+    std::cout << "Bplustree: bulk loads match their input\n";
+    for (int degree : {3, 4, 8, 15}) TestInsertBatch(degree);
+    std::cout << "Bplustree: batch inserts match std::set\n";
+
+    for (int degree : {3, 8, 64}) TestOLCAgainstSet(degree);
+    std::cout << "OLCBplustree: one thread matches std::set\n";
+    TestOLCConcurrent(8, 50000);
+    TestOLCReclaim();
+    for (int degree : {3, 4, 16, PagedBplustree<Key>::kMaxDegree}) TestPaged(degree);
+    TestPagedReopen();
+    std::cout << "PagedBplustree: 8-frame pool matches std::set, deletes free their pages, reopens\n";
+    TestSnapshot();
+    TestWalTornTail();
+    TestWalCheckpoint();
+    TestWalConcurrentReplay();
+    std::cout << "Bplustree: degrees 3-31 and 255, strict and lazy merges match std::map\n";
+    TestSimdSearch();
+    TestHistogram();
+    TestRunPhase();
+
+    if (failures > 0) {
+        std::cout << failures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "All tests passed\n";
+    return 0;
+}
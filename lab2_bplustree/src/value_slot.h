@@ -0,0 +1,60 @@
+#ifndef LAB2_BPLUSTREE_VALUE_SLOT_H_
+#define LAB2_BPLUSTREE_VALUE_SLOT_H_
+
+#include <cstddef>
+#include <type_traits>
+
+// Placeholder value type for set-only containers (Value = void).
+struct NoValue {};
+
+// Values up to this size that are trivially copyable live inline in the node.
+static constexpr size_t kMaxInlineValueSize = 16;
+
+// ValueSlot: storage for one value inside a node.
+//
+// - Value = void: empty (no bytes when used as a base class).
+// - Small, trivially copyable values (record pointers, offsets, ...): stored inline,
+//   so a lookup that found the key has the value on the same cache line.
+// - Anything else: stored out of line; the slot holds an owning pointer.
+//
+// Slots are plain handles: copying a slot does not copy an out-of-line value.
+// Init/Destroy must be called explicitly by the owning node.
+template<typename Value, typename Enable = void>
+struct ValueSlot {
+    typedef Value ValueType;
+    static constexpr bool kOutOfLine = true;
+
+    Value* value_ptr;
+
+    void InitValue(const Value& value) { value_ptr = new Value(value); }
+    void DestroyValue() { delete value_ptr; }
+    void SetValue(const Value& value) { *value_ptr = value; }
+    const Value* GetValue() const { return value_ptr; }
+};
+
+template<typename Value>
+struct ValueSlot<Value, typename std::enable_if<std::is_trivially_copyable<Value>::value &&
+                                                sizeof(Value) <= kMaxInlineValueSize>::type> {
+    typedef Value ValueType;
+    static constexpr bool kOutOfLine = false;
+
+    Value value;
+
+    void InitValue(const Value& v) { value = v; }
+    void DestroyValue() {}
+    void SetValue(const Value& v) { value = v; }
+    const Value* GetValue() const { return &value; }
+};
+
+template<>
+struct ValueSlot<void> {
+    typedef NoValue ValueType;
+    static constexpr bool kOutOfLine = false;
+
+    void InitValue(const NoValue&) {}
+    void DestroyValue() {}
+    void SetValue(const NoValue&) {}
+    const NoValue* GetValue() const { return nullptr; }
+};
+
+#endif  // LAB2_BPLUSTREE_VALUE_SLOT_H_
@@ -80,6 +80,22 @@ long nextValue() {
 	return nextLong(items);
 }
 
+//same as nextLong(items), but safe to call from several threads at once
+//once init_zipf_generator has run: uses rand_r on the caller's seed and
+//does not update lastVal.
+long nextValue_r(unsigned int* seed) {
+	double u = (double)rand_r(seed) / ((double)RAND_MAX);
+	double uz=u*zetan;
+	if (uz < 1.0){
+		return base;
+	}
+
+	if (uz<1.0 + pow(0.5,theta)) {
+		return base + 1;
+	}
+	return base + (long)((items) * pow(eta*u - eta + 1, alpha));
+}
+
 void setLastValue(long val){
 	lastVal = val;
 }